@@ -0,0 +1,322 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     IoBackendBenchmark.cpp
+ * @brief    loopback回显基准：libev（epoll就绪通知）与io_uring（多次完成的accept/recv、
+ *           缓冲区环、不等待可写的send）两种服务端IO方式的对比
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     用法：IoBackendBenchmark [连接数] [消息字节数] [每种后端测试秒数]
+ *           客户端线程用epoll在所有连接上做一问一答，统计每秒往返次数；服务端两种后端的
+ *           处理方式与Dispatcher一致：libev读事件->read()->write()，io_uring环fd可读->Reap()
+ *           ->收到的数据直接提交send。
+ * Modify history:
+ ******************************************************************************/
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <ev.h>
+#include "util/CIoUring.hpp"
+
+static std::atomic<bool> g_bStop(false);
+
+static int Listen(int& iPort)
+{
+    int iFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int iReuse = 1;
+    setsockopt(iFd, SOL_SOCKET, SO_REUSEADDR, &iReuse, sizeof(iReuse));
+    struct sockaddr_in stAddr;
+    memset(&stAddr, 0, sizeof(stAddr));
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    stAddr.sin_port = 0;
+    socklen_t uiAddrLen = sizeof(stAddr);
+    if (bind(iFd, (struct sockaddr*)&stAddr, sizeof(stAddr)) < 0 || listen(iFd, 1024) < 0
+            || getsockname(iFd, (struct sockaddr*)&stAddr, &uiAddrLen) < 0)
+    {
+        perror("listen");
+        exit(1);
+    }
+    iPort = ntohs(stAddr.sin_port);
+    return(iFd);
+}
+
+/* ------------------------------- libev ------------------------------- */
+
+static void EvEchoCallback(struct ev_loop* loop, struct ev_io* watcher, int revents)
+{
+    char szBuff[16384];
+    while (true)
+    {
+        ssize_t iLen = read(watcher->fd, szBuff, sizeof(szBuff));
+        if (iLen > 0)
+        {
+            if (write(watcher->fd, szBuff, iLen) != iLen)   // 一问一答，发送缓冲区不会满
+            {
+                perror("write");
+            }
+            continue;
+        }
+        if (iLen < 0 && (EAGAIN == errno || EINTR == errno))
+        {
+            return;
+        }
+        ev_io_stop(loop, watcher);
+        close(watcher->fd);
+        delete watcher;
+        return;
+    }
+}
+
+static void EvAcceptCallback(struct ev_loop* loop, struct ev_io* watcher, int revents)
+{
+    int iFd = -1;
+    while ((iFd = accept4(watcher->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        int iNoDelay = 1;
+        setsockopt(iFd, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+        ev_io* pWatcher = new ev_io;
+        ev_io_init(pWatcher, EvEchoCallback, iFd, EV_READ);
+        ev_io_start(loop, pWatcher);
+    }
+}
+
+static void EvStopCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+{
+    if (g_bStop)
+    {
+        ev_break(loop, EVBREAK_ALL);
+    }
+}
+
+static void RunLibevServer(int iListenFd)
+{
+    struct ev_loop* loop = ev_loop_new(EVBACKEND_EPOLL);
+    ev_io stAcceptWatcher;
+    ev_io_init(&stAcceptWatcher, EvAcceptCallback, iListenFd, EV_READ);
+    ev_io_start(loop, &stAcceptWatcher);
+    ev_timer stStopWatcher;
+    ev_timer_init(&stStopWatcher, EvStopCallback, 0.1, 0.1);
+    ev_timer_start(loop, &stStopWatcher);
+    ev_run(loop, 0);
+    ev_loop_destroy(loop);  // 连接fd随进程退出关闭
+}
+
+/* ------------------------------ io_uring ------------------------------ */
+
+struct tagRingConnection
+{
+    bool bSending = false;
+    std::string strSending;
+    std::string strWaiting;
+};
+
+static void RingSend(neb::CIoUring& oRing, int iFd, tagRingConnection& stConn)
+{
+    stConn.strSending.swap(stConn.strWaiting);
+    stConn.strWaiting.clear();
+    stConn.bSending = oRing.PrepareSend(iFd, stConn.strSending.data(), stConn.strSending.size(),
+            ((uint64_t)3 << 32) | (uint32_t)iFd);
+}
+
+static void RunRingServer(int iListenFd)
+{
+    neb::CIoUring oRing;
+    if (!oRing.Init())
+    {
+        fprintf(stderr, "io_uring init failed: %s\n", strerror(oRing.GetErrno()));
+        exit(1);
+    }
+    // user_data高32位为请求类型（1 accept，2 recv，3 send），低32位为fd
+    oRing.PrepareAccept(iListenFd, ((uint64_t)1 << 32) | (uint32_t)iListenFd);
+    std::unordered_map<int, tagRingConnection> mapConnection;
+    std::vector<neb::CIoUring::tagCompletion> vecCompletion;
+    struct pollfd stPollFd;
+    stPollFd.fd = oRing.GetFd();
+    stPollFd.events = POLLIN;
+    while (!g_bStop)
+    {
+        oRing.Submit();
+        if (poll(&stPollFd, 1, 100) <= 0)
+        {
+            continue;
+        }
+        vecCompletion.clear();
+        oRing.Reap(vecCompletion, 256);
+        for (size_t i = 0; i < vecCompletion.size(); ++i)
+        {
+            const neb::CIoUring::tagCompletion& stCompletion = vecCompletion[i];
+            uint32_t uiType = (uint32_t)(stCompletion.ullUserData >> 32);
+            int iFd = (int)(uint32_t)stCompletion.ullUserData;
+            if (1 == uiType)
+            {
+                if (stCompletion.iResult >= 0)
+                {
+                    int iNoDelay = 1;
+                    setsockopt(stCompletion.iResult, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+                    mapConnection[stCompletion.iResult];
+                    oRing.PrepareRecv(stCompletion.iResult, ((uint64_t)2 << 32) | (uint32_t)stCompletion.iResult);
+                }
+                if (!stCompletion.More())
+                {
+                    oRing.PrepareAccept(iListenFd, stCompletion.ullUserData);
+                }
+            }
+            else if (2 == uiType)
+            {
+                if (stCompletion.iResult > 0)
+                {
+                    tagRingConnection& stConn = mapConnection[iFd];
+                    stConn.strWaiting.append(oRing.GetBuffer(stCompletion.BufferId()), stCompletion.iResult);
+                    if (!stConn.bSending)
+                    {
+                        RingSend(oRing, iFd, stConn);
+                    }
+                }
+                if (stCompletion.HasBuffer())
+                {
+                    oRing.RecycleBuffer(stCompletion.BufferId());
+                }
+                if (stCompletion.iResult == 0)
+                {
+                    mapConnection.erase(iFd);
+                    close(iFd);
+                }
+                else if (!stCompletion.More())
+                {
+                    oRing.PrepareRecv(iFd, stCompletion.ullUserData);
+                }
+            }
+            else if (3 == uiType)
+            {
+                auto iter = mapConnection.find(iFd);
+                if (iter == mapConnection.end())
+                {
+                    continue;
+                }
+                tagRingConnection& stConn = iter->second;
+                stConn.bSending = false;
+                if (stCompletion.iResult > 0 && (size_t)stCompletion.iResult < stConn.strSending.size())
+                {
+                    stConn.strWaiting.insert(0, stConn.strSending, stCompletion.iResult, std::string::npos);
+                }
+                if (!stConn.strWaiting.empty())
+                {
+                    RingSend(oRing, iFd, stConn);
+                }
+            }
+        }
+    }
+}
+
+/* ------------------------------- client ------------------------------- */
+
+static uint64_t RunClient(int iPort, int iConnNum, int iMsgLen, int iSeconds)
+{
+    int iEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<int> vecFd;
+    std::vector<int> vecRecvLen(iConnNum, 0);
+    std::string strMsg(iMsgLen, 'x');
+    struct sockaddr_in stAddr;
+    memset(&stAddr, 0, sizeof(stAddr));
+    stAddr.sin_family = AF_INET;
+    stAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    stAddr.sin_port = htons(iPort);
+    for (int i = 0; i < iConnNum; ++i)
+    {
+        int iFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (connect(iFd, (struct sockaddr*)&stAddr, sizeof(stAddr)) < 0)
+        {
+            perror("connect");
+            exit(1);
+        }
+        int iNoDelay = 1;
+        setsockopt(iFd, IPPROTO_TCP, TCP_NODELAY, &iNoDelay, sizeof(iNoDelay));
+        fcntl(iFd, F_SETFL, fcntl(iFd, F_GETFL) | O_NONBLOCK);
+        struct epoll_event stEvent;
+        stEvent.events = EPOLLIN;
+        stEvent.data.u32 = i;
+        epoll_ctl(iEpollFd, EPOLL_CTL_ADD, iFd, &stEvent);
+        vecFd.push_back(iFd);
+    }
+    for (int i = 0; i < iConnNum; ++i)
+    {
+        if (write(vecFd[i], strMsg.data(), iMsgLen) != iMsgLen)
+        {
+            perror("write");
+        }
+    }
+    uint64_t ullRoundTrip = 0;
+    char szBuff[16384];
+    struct epoll_event astEvent[256];
+    auto tpEnd = std::chrono::steady_clock::now() + std::chrono::seconds(iSeconds);
+    while (std::chrono::steady_clock::now() < tpEnd)
+    {
+        int iEventNum = epoll_wait(iEpollFd, astEvent, 256, 100);
+        for (int i = 0; i < iEventNum; ++i)
+        {
+            int iIndex = astEvent[i].data.u32;
+            ssize_t iLen = 0;
+            while ((iLen = read(vecFd[iIndex], szBuff, sizeof(szBuff))) > 0)
+            {
+                vecRecvLen[iIndex] += iLen;
+            }
+            while (vecRecvLen[iIndex] >= iMsgLen)
+            {
+                vecRecvLen[iIndex] -= iMsgLen;
+                ++ullRoundTrip;
+                if (write(vecFd[iIndex], strMsg.data(), iMsgLen) != iMsgLen)
+                {
+                    perror("write");
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < vecFd.size(); ++i)
+    {
+        close(vecFd[i]);
+    }
+    close(iEpollFd);
+    return(ullRoundTrip);
+}
+
+static double Bench(const char* szName, void (*fnServer)(int), int iConnNum, int iMsgLen, int iSeconds)
+{
+    int iPort = 0;
+    int iListenFd = Listen(iPort);
+    g_bStop = false;
+    std::thread oServer(fnServer, iListenFd);
+    uint64_t ullRoundTrip = RunClient(iPort, iConnNum, iMsgLen, iSeconds);
+    g_bStop = true;
+    oServer.join();
+    close(iListenFd);
+    double dRate = (double)ullRoundTrip / iSeconds;
+    printf("%-10s connections %-5d msg %-6d bytes: %12.0f round trips/s\n", szName, iConnNum, iMsgLen, dRate);
+    return(dRate);
+}
+
+int main(int argc, char* argv[])
+{
+    int iConnNum = (argc > 1) ? atoi(argv[1]) : 64;
+    int iMsgLen = (argc > 2) ? atoi(argv[2]) : 128;
+    int iSeconds = (argc > 3) ? atoi(argv[3]) : 5;
+    setvbuf(stdout, NULL, _IONBF, 0);
+    double dLibev = Bench("libev", RunLibevServer, iConnNum, iMsgLen, iSeconds);
+    double dRing = Bench("io_uring", RunRingServer, iConnNum, iMsgLen, iSeconds);
+    printf("io_uring / libev: %.2f\n", dRing / dLibev);
+    return(0);
+}
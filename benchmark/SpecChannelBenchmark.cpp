@@ -0,0 +1,193 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     SpecChannelBenchmark.cpp
+ * @brief    两个Worker之间经SpecChannel传递消息的吞吐量（消息数/秒）基准
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     用法：SpecChannelBenchmark [消息总数] [每轮事件循环写入的消息数] [队列大小]
+ *           两个线程各运行一个libev事件循环，与Worker的Dispatcher相同。写入方每轮事件循环
+ *           写入一批消息，读取方在ev_async回调中读空SpecChannel。比较三种写入方式：
+ *           per-message：每条消息Write()后立即ev_async_send()（改动前的方式）；
+ *           coalesced：每条消息Write()，只在SetNotified()由false变true时通知，通知在本轮
+ *           事件循环结束前（EV_MINPRI的ev_prepare）发送，与Dispatcher::AsyncSend()一致；
+ *           batched：WriteBatch()一次写入整批消息，通知方式同coalesced。
+ * Modify history:
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "channel/SpecChannel.hpp"
+
+using namespace neb;
+
+enum E_WRITE_MODE
+{
+    WRITE_PER_MESSAGE = 0,
+    WRITE_COALESCED = 1,
+    WRITE_BATCHED = 2,
+};
+
+struct tagBench
+{
+    E_WRITE_MODE eMode;
+    uint32 uiTotal;
+    uint32 uiBurst;
+    SpecChannel<std::string>* pChannel;
+    struct ev_loop* pReaderLoop;
+    ev_async* pReaderAsync;
+    bool bNotifyPending;
+    uint32 uiWritten;
+    uint64 ullAsyncSend;
+    std::vector<std::string> vecBatch;
+    std::atomic<uint32> uiRead;
+    uint64 ullReadCallback;
+};
+
+static void ReaderCallback(struct ev_loop* loop, ev_async* watcher, int revents)
+{
+    tagBench* pBench = (tagBench*)watcher->data;
+    uint32 uiFlags = 0;
+    uint32 uiStepSeq = 0;
+    std::string strData;
+    uint32 uiRead = pBench->uiRead.load(std::memory_order_relaxed);
+    while (pBench->pChannel->Read(uiFlags, uiStepSeq, strData))
+    {
+        ++uiRead;
+    }
+    pBench->uiRead.store(uiRead, std::memory_order_relaxed);
+    ++pBench->ullReadCallback;
+    if (uiRead >= pBench->uiTotal)
+    {
+        ev_break(loop, EVBREAK_ALL);
+    }
+}
+
+static void Notify(tagBench* pBench)
+{
+    ev_async_send(pBench->pReaderLoop, pBench->pReaderAsync);
+    ++pBench->ullAsyncSend;
+}
+
+static void WriterIdleCallback(struct ev_loop* loop, ev_idle* watcher, int revents)
+{
+    tagBench* pBench = (tagBench*)watcher->data;
+    uint32 uiBurst = pBench->uiTotal - pBench->uiWritten;
+    uiBurst = (uiBurst < pBench->uiBurst) ? uiBurst : pBench->uiBurst;
+    if (WRITE_BATCHED == pBench->eMode)
+    {
+        while (pBench->vecBatch.size() < uiBurst)
+        {
+            pBench->vecBatch.push_back(std::string(64, 'x'));
+        }
+        uint32 uiWritten = pBench->pChannel->WriteBatch(0, 0, pBench->vecBatch);
+        pBench->uiWritten += uiWritten;
+        if (uiWritten > 0 && pBench->pChannel->MutableWatcher()->SetNotified())
+        {
+            pBench->bNotifyPending = true;
+        }
+    }
+    else
+    {
+        for (uint32 i = 0; i < uiBurst; ++i)
+        {
+            if (ERR_OK != pBench->pChannel->Write(0, 0, std::string(64, 'x')))
+            {
+                break;      // 队列满，下一轮再写
+            }
+            ++pBench->uiWritten;
+            if (WRITE_PER_MESSAGE == pBench->eMode)
+            {
+                Notify(pBench);
+            }
+            else if (pBench->pChannel->MutableWatcher()->SetNotified())
+            {
+                pBench->bNotifyPending = true;
+            }
+        }
+    }
+    if (pBench->uiWritten >= pBench->uiTotal)
+    {
+        ev_idle_stop(loop, watcher);
+    }
+}
+
+static void WriterPrepareCallback(struct ev_loop* loop, ev_prepare* watcher, int revents)
+{
+    tagBench* pBench = (tagBench*)watcher->data;
+    if (pBench->bNotifyPending)
+    {
+        pBench->bNotifyPending = false;
+        Notify(pBench);
+    }
+    if (pBench->uiWritten >= pBench->uiTotal)
+    {
+        ev_prepare_stop(loop, watcher);
+    }
+}
+
+static void RunWriter(tagBench* pBench)
+{
+    struct ev_loop* loop = ev_loop_new(EVFLAG_AUTO);
+    ev_idle* pIdle = (ev_idle*)malloc(sizeof(ev_idle));
+    ev_prepare* pPrepare = (ev_prepare*)malloc(sizeof(ev_prepare));
+    ev_idle_init(pIdle, WriterIdleCallback);
+    pIdle->data = (void*)pBench;
+    ev_idle_start(loop, pIdle);
+    ev_prepare_init(pPrepare, WriterPrepareCallback);
+    ev_set_priority(pPrepare, EV_MINPRI);
+    pPrepare->data = (void*)pBench;
+    ev_prepare_start(loop, pPrepare);
+    ev_run(loop, 0);
+    ev_loop_destroy(loop);
+    free(pIdle);
+    free(pPrepare);
+}
+
+static void Bench(E_WRITE_MODE eMode, const char* szName, uint32 uiTotal, uint32 uiBurst, uint32 uiQueueSize)
+{
+    SpecChannel<std::string> oChannel(1, 2, uiQueueSize, false, false);
+    oChannel.MutableWatcher();      // 读空时清除通知标记
+    tagBench stBench;
+    stBench.eMode = eMode;
+    stBench.uiTotal = uiTotal;
+    stBench.uiBurst = uiBurst;
+    stBench.pChannel = &oChannel;
+    stBench.pReaderLoop = ev_loop_new(EVFLAG_AUTO);
+    stBench.pReaderAsync = (ev_async*)malloc(sizeof(ev_async));
+    stBench.bNotifyPending = false;
+    stBench.uiWritten = 0;
+    stBench.ullAsyncSend = 0;
+    stBench.uiRead = 0;
+    stBench.ullReadCallback = 0;
+    ev_async_init(stBench.pReaderAsync, ReaderCallback);
+    stBench.pReaderAsync->data = (void*)&stBench;
+    ev_async_start(stBench.pReaderLoop, stBench.pReaderAsync);
+
+    auto tpStart = std::chrono::steady_clock::now();
+    std::thread oWriter(RunWriter, &stBench);
+    ev_run(stBench.pReaderLoop, 0);
+    oWriter.join();
+    double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tpStart).count();
+    printf("%-12s %10.0f msgs/s  async_send %10llu  read_callback %10llu  full %u\n",
+            szName, stBench.uiRead.load() / dSeconds, (unsigned long long)stBench.ullAsyncSend,
+            (unsigned long long)stBench.ullReadCallback, oChannel.GetFullNum());
+    ev_async_stop(stBench.pReaderLoop, stBench.pReaderAsync);
+    ev_loop_destroy(stBench.pReaderLoop);
+    free(stBench.pReaderAsync);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 uiTotal = (argc > 1) ? atoi(argv[1]) : 10000000;
+    uint32 uiBurst = (argc > 2) ? atoi(argv[2]) : 16;
+    uint32 uiQueueSize = (argc > 3) ? atoi(argv[3]) : 4096;
+    printf("messages %u, burst %u, queue size %u\n", uiTotal, uiBurst, uiQueueSize);
+    Bench(WRITE_PER_MESSAGE, "per-message", uiTotal, uiBurst, uiQueueSize);
+    Bench(WRITE_COALESCED, "coalesced", uiTotal, uiBurst, uiQueueSize);
+    Bench(WRITE_BATCHED, "batched", uiTotal, uiBurst, uiQueueSize);
+    return(0);
+}
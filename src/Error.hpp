@@ -53,6 +53,8 @@ enum E_ERROR_NO
     ERR_SPEC_CHANNEL_CALL               = 10106,    ///< inappropriate call
     ERR_SPEC_CHANNEL_MIGRATE            = 10107,    ///< channel migrate failed
 
+    ERR_COMPUTE_EXCEPTION               = 10200,    ///< 计算任务抛出异常
+
     /* 存储代理错误码段  11000~11999 */
     ERR_INCOMPLET_DATAPROXY_DATA        = 11001,    ///< DataProxy请求数据包不完整
     ERR_INVALID_REDIS_ROUTE             = 11002,    ///< 无效的redis路由信息
@@ -312,6 +312,16 @@ void Actor::CircuitBreak(const std::string& strIdentify)
     m_pLabor->GetDispatcher()->CircuitBreak(strIdentify);
 }
 
+bool Actor::MsgPermit(uint64 ullUin)
+{
+    return(m_pLabor->GetDispatcher()->MsgPermit(ullUin));
+}
+
+bool Actor::AsyncCompute(uint32 uiStepSeq, std::function<int32(std::string&)> fnCompute)
+{
+    return(m_pLabor->GetActorBuilder()->AsyncCompute(uiStepSeq, std::move(fnCompute)));
+}
+
 uint32 Actor::SendToSelf(int32 iCmd, uint32 uiSeq, const MsgBody& oMsgBody)
 {
     return(IO<CodecNebula>::SendToSelf(this, iCmd, uiSeq, oMsgBody));
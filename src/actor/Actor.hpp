@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <string>
+#include <functional>
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -293,6 +294,26 @@ protected:
      */
     void CircuitBreak(const std::string& strIdentify);
 
+    /**
+     * @brief 用户消息频率检查
+     * @note 按配置permission.uin_permit（stat_interval内允许permit_num条）以令牌桶限制，
+     *       未配置时总是返回true。超过限制返回false，由业务决定丢弃或回复错误。
+     */
+    bool MsgPermit(uint64 ullUin);
+
+    /**
+     * @brief 把CPU密集型计算（压缩、大JSON构造、加解密、打分等）提交到框架计算线程池
+     * @note fnCompute在计算线程执行，只能访问按值捕获的数据，不能访问Actor和框架对象；
+     *       返回错误码，结果（或错误信息）写入参数。计算完成后在当前Worker回调uiStepSeq
+     *       对应的Step：成功回调Callback(nullptr, pRawData, uiRawDataSize)，失败回调
+     *       ErrBack(nullptr, iErrno, strErrMsg)，返回值的处理与网络响应回调相同。Step超时
+     *       或结束时，其尚未开始执行的计算任务被取消。
+     * @param uiStepSeq 已注册的回调Step的seq
+     * @param fnCompute 计算任务
+     * @return 是否提交成功（Step不存在、计算线程池未启用或排队已满时返回false）
+     */
+    bool AsyncCompute(uint32 uiStepSeq, std::function<int32(std::string&)> fnCompute);
+
     /**
      * @brief 发送请求到当前worker
      * @return SelfChannel的seq
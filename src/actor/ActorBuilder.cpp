@@ -76,46 +76,55 @@ bool ActorBuilder::Init(CJsonObject& oDynamicLoadConf)
     return(true);
 }
 
-void ActorBuilder::StepTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+void ActorBuilder::StepTimeoutCallback(void* pData)
 {
-    if (watcher->data != NULL)
+    if (pData != NULL)
     {
-        auto pWatcher = static_cast<ActorWatcher*>(watcher->data);
+        uint64 ullStartTime = Dispatcher::GetCoarseMicroTime();
+        auto pWatcher = static_cast<ActorWatcher*>(pData);
         auto pStep = std::static_pointer_cast<Step>(pWatcher->GetActor());
-        pStep->m_pLabor->GetActorBuilder()->OnStepTimeout(pStep);
+        Labor* pLabor = pStep->m_pLabor;
+        pLabor->GetActorBuilder()->OnStepTimeout(pStep);
+        pLabor->GetDispatcher()->LoopCallbackDone("StepTimeoutCallback", ullStartTime, (Actor*)pStep.get());
     }
 }
 
-void ActorBuilder::SessionTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+void ActorBuilder::SessionTimeoutCallback(void* pData)
 {
-    if (watcher->data != NULL)
+    if (pData != NULL)
     {
-        auto pWatcher = static_cast<ActorWatcher*>(watcher->data);
+        uint64 ullStartTime = Dispatcher::GetCoarseMicroTime();
+        auto pWatcher = static_cast<ActorWatcher*>(pData);
         auto pSession = std::static_pointer_cast<Session>(pWatcher->GetActor());
-        pSession->m_pLabor->GetActorBuilder()->OnSessionTimeout(pSession);
+        Labor* pLabor = pSession->m_pLabor;
+        pLabor->GetActorBuilder()->OnSessionTimeout(pSession);
+        pLabor->GetDispatcher()->LoopCallbackDone("SessionTimeoutCallback", ullStartTime, (Actor*)pSession.get());
     }
 }
 
-void ActorBuilder::ChainTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+void ActorBuilder::ChainTimeoutCallback(void* pData)
 {
-    if (watcher->data != NULL)
+    if (pData != NULL)
     {
-        auto pWatcher = static_cast<ActorWatcher*>(watcher->data);
+        uint64 ullStartTime = Dispatcher::GetCoarseMicroTime();
+        auto pWatcher = static_cast<ActorWatcher*>(pData);
         auto pChain = std::static_pointer_cast<Chain>(pWatcher->GetActor());
-        pChain->m_pLabor->GetActorBuilder()->OnChainTimeout(pChain);
+        Labor* pLabor = pChain->m_pLabor;
+        pLabor->GetActorBuilder()->OnChainTimeout(pChain);
+        pLabor->GetDispatcher()->LoopCallbackDone("ChainTimeoutCallback", ullStartTime, (Actor*)pChain.get());
     }
 }
 
 bool ActorBuilder::OnStepTimeout(std::shared_ptr<Step> pStep)
 {
-    ev_timer* watcher = pStep->MutableWatcher()->MutableTimerWatcher();
+    CTimingWheel::tagTimer* pTimer = pStep->MutableWatcher()->MutableTimer();
     LOG4_TRACE("seq %lu: active_time %lf, now_time %lf, lifetime %lf",
             pStep->GetSequence(), pStep->GetActiveTime(), m_pLabor->GetNowTime(), pStep->GetTimeout());
     E_CMD_STATUS eResult = pStep->Timeout();
     if (CMD_STATUS_RUNNING == eResult)
     {
         ev_tstamp after = pStep->GetTimeout();
-        m_pLabor->GetDispatcher()->RefreshEvent(watcher, after);
+        m_pLabor->GetDispatcher()->RefreshTimer(pTimer, after);
         return(true);
     }
     else
@@ -128,12 +137,11 @@ bool ActorBuilder::OnStepTimeout(std::shared_ptr<Step> pStep)
 
 bool ActorBuilder::OnSessionTimeout(std::shared_ptr<Session> pSession)
 {
-    ev_timer* watcher = pSession->MutableWatcher()->MutableTimerWatcher();
-    //LOG4_TRACE("CHECK watchar = 0x%x", watcher);
+    CTimingWheel::tagTimer* pTimer = pSession->MutableWatcher()->MutableTimer();
     ev_tstamp after = pSession->GetActiveTime() - m_pLabor->GetNowTime() + pSession->GetTimeout();
     if (after > 0)    // 定时时间内被重新刷新过，重新设置定时器
     {
-        m_pLabor->GetDispatcher()->RefreshEvent(watcher, after);
+        m_pLabor->GetDispatcher()->RefreshTimer(pTimer, after);
         return(true);
     }
     else    // 会话已超时
@@ -141,7 +149,7 @@ bool ActorBuilder::OnSessionTimeout(std::shared_ptr<Session> pSession)
         //LOG4_TRACE("session_id: %s", pSession->GetSessionId().c_str());
         if (CMD_STATUS_RUNNING == pSession->Timeout())
         {
-            m_pLabor->GetDispatcher()->RefreshEvent(watcher, pSession->GetTimeout());
+            m_pLabor->GetDispatcher()->RefreshTimer(pTimer, pSession->GetTimeout());
             return(true);
         }
         else
@@ -154,19 +162,18 @@ bool ActorBuilder::OnSessionTimeout(std::shared_ptr<Session> pSession)
 
 bool ActorBuilder::OnChainTimeout(std::shared_ptr<Chain> pChain)
 {
-    ev_timer* watcher = pChain->MutableWatcher()->MutableTimerWatcher();
-    LOG4_TRACE("CHECK watchar = 0x%x", watcher);
+    CTimingWheel::tagTimer* pTimer = pChain->MutableWatcher()->MutableTimer();
     ev_tstamp after = pChain->GetActiveTime() - m_pLabor->GetNowTime() + pChain->GetTimeout();
     if (after > 0)    // 定时时间内被重新刷新过，重新设置定时器
     {
-        m_pLabor->GetDispatcher()->RefreshEvent(watcher, after);
+        m_pLabor->GetDispatcher()->RefreshTimer(pTimer, after);
         return(true);
     }
     else    // 会话已超时
     {
         if (CMD_STATUS_RUNNING == pChain->Timeout())
         {
-            m_pLabor->GetDispatcher()->RefreshEvent(watcher, pChain->GetTimeout());
+            m_pLabor->GetDispatcher()->RefreshTimer(pTimer, pChain->GetTimeout());
             return(true);
         }
         else
@@ -303,7 +310,7 @@ bool ActorBuilder::OnMessage(std::shared_ptr<SocketChannel> pChannel, const MsgH
                 if (CMD_STATUS_RUNNING != eResult)
                 {
                     uint32 uiChainId = step_iter->second->GetChainId();
-                    m_pLabor->GetDispatcher()->DelEvent(step_iter->second->MutableWatcher()->MutableTimerWatcher());
+                    m_pLabor->GetDispatcher()->DelTimer(step_iter->second->MutableWatcher()->MutableTimer());
                     step_iter->second->MutableWatcher()->Reset();
                     m_mapCallbackStep.erase(step_iter);
                     if (CMD_STATUS_FAULT != eResult && 0 != uiChainId)
@@ -343,7 +350,7 @@ bool ActorBuilder::OnError(std::shared_ptr<SocketChannel> pChannel, uint32 uiSte
             if (CMD_STATUS_RUNNING != eResult)
             {
                 uint32 uiChainId = step_iter->second->GetChainId();
-                m_pLabor->GetDispatcher()->DelEvent(step_iter->second->MutableWatcher()->MutableTimerWatcher());
+                m_pLabor->GetDispatcher()->DelTimer(step_iter->second->MutableWatcher()->MutableTimer());
                 step_iter->second->MutableWatcher()->Reset();
                 m_mapCallbackStep.erase(step_iter);
                 if (CMD_STATUS_FAULT != eResult && 0 != uiChainId)
@@ -378,7 +385,7 @@ void ActorBuilder::RemoveStep(std::shared_ptr<Step> pStep)
         return;
     }
     std::unordered_map<uint32, std::shared_ptr<Step> >::iterator callback_iter;
-    m_pLabor->GetDispatcher()->DelEvent(pStep->MutableWatcher()->MutableTimerWatcher());
+    m_pLabor->GetDispatcher()->DelTimer(pStep->MutableWatcher()->MutableTimer());
     pStep->MutableWatcher()->Reset();
     callback_iter = m_mapCallbackStep.find(pStep->GetSequence());
     if (callback_iter != m_mapCallbackStep.end())
@@ -386,6 +393,7 @@ void ActorBuilder::RemoveStep(std::shared_ptr<Step> pStep)
         LOG4_TRACE("erase step(seq %u)", pStep->GetSequence());
         m_mapCallbackStep.erase(callback_iter);
     }
+    CancelCompute(pStep->GetSequence());
 }
 
 void ActorBuilder::RemoveSession(std::shared_ptr<Session> pSession)
@@ -394,7 +402,7 @@ void ActorBuilder::RemoveSession(std::shared_ptr<Session> pSession)
     {
         return;
     }
-    m_pLabor->GetDispatcher()->DelEvent(pSession->MutableWatcher()->MutableTimerWatcher());
+    m_pLabor->GetDispatcher()->DelTimer(pSession->MutableWatcher()->MutableTimer());
     pSession->MutableWatcher()->Reset();
     auto iter = m_mapCallbackSession.find(pSession->GetSessionId());
     if (iter != m_mapCallbackSession.end())
@@ -410,7 +418,7 @@ void ActorBuilder::RemoveChain(uint32 uiChainId)
     if (chain_iter != m_mapChain.end())
     {
         std::shared_ptr<Chain> pChain = chain_iter->second;
-        m_pLabor->GetDispatcher()->DelEvent(pChain->MutableWatcher()->MutableTimerWatcher());
+        m_pLabor->GetDispatcher()->DelTimer(pChain->MutableWatcher()->MutableTimer());
         pChain->MutableWatcher()->Reset();
         m_mapChain.erase(chain_iter);
     }
@@ -437,6 +445,28 @@ void ActorBuilder::ChannelNotice(std::shared_ptr<SocketChannel> pChannel, const
     }
 }
 
+void ActorBuilder::WatermarkNotice(std::shared_ptr<SocketChannel> pChannel, bool bHighWatermark)
+{
+    LOG4_TRACE(" ");
+    auto cmd_iter = m_mapCmd.find(CMD_REQ_CHANNEL_WATERMARK);
+    if (cmd_iter != m_mapCmd.end() && cmd_iter->second != nullptr)
+    {
+        MsgHead oMsgHead;
+        MsgBody oMsgBody;
+        oMsgBody.mutable_req_target()->set_route_id(0);
+        oMsgBody.mutable_req_target()->set_route(bHighWatermark ? "high_watermark" : "low_watermark");
+        oMsgBody.set_data(pChannel->GetIdentify());
+        oMsgBody.set_add_on(pChannel->GetClientData());
+        oMsgHead.set_cmd(CMD_REQ_CHANNEL_WATERMARK);
+        oMsgHead.set_seq(m_pLabor->GetSequence());
+        oMsgHead.set_len(oMsgBody.ByteSize());
+        std::ostringstream oss;
+        oss << m_pLabor->GetNodeInfo().uiNodeId << "." << m_pLabor->GetNowTime() << "." << m_pLabor->GetSequence();
+        cmd_iter->second->SetTraceId(oss.str());
+        cmd_iter->second->AnyMessage(pChannel, oMsgHead, oMsgBody);
+    }
+}
+
 void ActorBuilder::AddChainConf(const std::string& strChainKey, std::queue<std::vector<std::string> >&& queChainBlocks)
 {
     m_mapChainConf.insert(std::make_pair(strChainKey, std::move(queChainBlocks)));
@@ -482,6 +512,7 @@ void ActorBuilder::LoadSysCmd()
         MakeSharedCmd(nullptr, "neb::CmdSpecChannelCreated", (int)CMD_REQ_SPEC_CHANNEL);
         MakeSharedCmd(nullptr, "neb::CmdFdTransfer", (int)CMD_REQ_FD_TRANSFER);
         MakeSharedCmd(nullptr, "neb::CmdChannelMigrate", (int)CMD_REQ_CHANNEL_MIGRATE);
+        MakeSharedCmd(nullptr, "neb::CmdChannelRebalance", (int)CMD_REQ_CHANNEL_REBALANCE);
         std::string strModulePath = "/healthy";
         MakeSharedModule(nullptr, "neb::ModuleHealth", strModulePath);
         strModulePath = "/health";
@@ -571,11 +602,7 @@ bool ActorBuilder::TransformToSharedStep(Actor* pCreator, std::shared_ptr<Actor>
         return(false);
     }
     pWatcher->Set(pSharedActor);
-    ev_timer* timer_watcher = pWatcher->MutableTimerWatcher();
-    if (nullptr == timer_watcher)
-    {
-        return(false);
-    }
+    CTimingWheel::tagTimer* pTimer = pWatcher->MutableTimer();
 
     if (nullptr != pCreator)
     {
@@ -593,7 +620,7 @@ bool ActorBuilder::TransformToSharedStep(Actor* pCreator, std::shared_ptr<Actor>
     {
         if (gc_dNoTimeout != pSharedStep->m_dTimeout)
         {
-            m_pLabor->GetDispatcher()->AddEvent(timer_watcher, StepTimeoutCallback, pSharedStep->m_dTimeout);
+            m_pLabor->GetDispatcher()->AddTimer(pTimer, StepTimeoutCallback, pSharedStep->m_dTimeout);
         }
         LOG4_TRACE("%s(seq %u, active_time %lf, lifetime %lf) register successful.", pSharedStep->GetActorName().c_str(),
                         pSharedStep->GetSequence(), pSharedStep->GetActiveTime(), pSharedStep->GetTimeout());
@@ -614,11 +641,7 @@ bool ActorBuilder::TransformToSharedSession(Actor* pCreator, std::shared_ptr<Act
         return(false);
     }
     pWatcher->Set(pSharedActor);
-    ev_timer* timer_watcher = pWatcher->MutableTimerWatcher();
-    if (nullptr == timer_watcher)
-    {
-        return(false);
-    }
+    CTimingWheel::tagTimer* pTimer = pWatcher->MutableTimer();
 
     if (nullptr != pCreator)
     {
@@ -632,7 +655,7 @@ bool ActorBuilder::TransformToSharedSession(Actor* pCreator, std::shared_ptr<Act
     {
         if (pSharedSession->m_dTimeout > 0)
         {
-            m_pLabor->GetDispatcher()->AddEvent(timer_watcher, SessionTimeoutCallback, pSharedSession->m_dTimeout);
+            m_pLabor->GetDispatcher()->AddTimer(pTimer, SessionTimeoutCallback, pSharedSession->m_dTimeout);
         }
         return(true);
     }
@@ -729,11 +752,7 @@ bool ActorBuilder::TransformToSharedChain(Actor* pCreator, std::shared_ptr<Actor
         return(false);
     }
     pWatcher->Set(pSharedActor);
-    ev_timer* timer_watcher = pWatcher->MutableTimerWatcher();
-    if (nullptr == timer_watcher)
-    {
-        return(false);
-    }
+    CTimingWheel::tagTimer* pTimer = pWatcher->MutableTimer();
 
     if (nullptr != pCreator)
     {
@@ -772,7 +791,7 @@ bool ActorBuilder::TransformToSharedChain(Actor* pCreator, std::shared_ptr<Actor
     {
         if (gc_dNoTimeout != pSharedChain->m_dTimeout)
         {
-            m_pLabor->GetDispatcher()->AddEvent(timer_watcher, ChainTimeoutCallback, pSharedChain->m_dTimeout);
+            m_pLabor->GetDispatcher()->AddTimer(pTimer, ChainTimeoutCallback, pSharedChain->m_dTimeout);
         }
         return(true);
     }
@@ -864,6 +883,72 @@ bool ActorBuilder::ExecStep(uint32 uiStepSeq, int iErrno, const std::string& str
     }
 }
 
+bool ActorBuilder::AsyncCompute(uint32 uiStepSeq, std::function<int32(std::string&)>&& fnCompute)
+{
+    if (m_mapCallbackStep.find(uiStepSeq) == m_mapCallbackStep.end())
+    {
+        LOG4_ERROR("no callback step for seq %u, compute task not submitted.", uiStepSeq);
+        return(false);
+    }
+    auto& pCanceled = m_mapComputeCancel[uiStepSeq];
+    if (pCanceled == nullptr)
+    {
+        pCanceled = std::make_shared<std::atomic<bool>>(false);
+    }
+    return(m_pLabor->GetDispatcher()->AsyncCompute(uiStepSeq, std::move(fnCompute), pCanceled));
+}
+
+bool ActorBuilder::OnComputeResult(uint32 uiStepSeq, int32 iErrno, const std::string& strResult)
+{
+    auto step_iter = m_mapCallbackStep.find(uiStepSeq);
+    if (step_iter == m_mapCallbackStep.end())
+    {
+        LOG4_TRACE("no callback for compute result, step seq %u!", uiStepSeq);
+        CancelCompute(uiStepSeq);
+        return(false);
+    }
+    E_CMD_STATUS eResult;
+    std::shared_ptr<Step> pStep = step_iter->second;
+    pStep->SetActiveTime(m_pLabor->GetNowTime());
+    if (ERR_OK == iErrno)
+    {
+        eResult = pStep->Callback(nullptr, strResult.data(), (uint32)strResult.size());
+    }
+    else
+    {
+        eResult = pStep->ErrBack(nullptr, iErrno, strResult);
+    }
+    if (CMD_STATUS_RUNNING != eResult)
+    {
+        uint32 uiChainId = pStep->GetChainId();
+        RemoveStep(pStep);
+        if (CMD_STATUS_FAULT != eResult && 0 != uiChainId)
+        {
+            auto chain_iter = m_mapChain.find(uiChainId);
+            if (chain_iter != m_mapChain.end())
+            {
+                chain_iter->second->SetActiveTime(m_pLabor->GetNowTime());
+                eResult = chain_iter->second->Next();
+                if (CMD_STATUS_RUNNING != eResult)
+                {
+                    RemoveChain(uiChainId);
+                }
+            }
+        }
+    }
+    return(true);
+}
+
+void ActorBuilder::CancelCompute(uint32 uiStepSeq)
+{
+    auto iter = m_mapComputeCancel.find(uiStepSeq);
+    if (iter != m_mapComputeCancel.end())
+    {
+        iter->second->store(true, std::memory_order_relaxed);
+        m_mapComputeCancel.erase(iter);
+    }
+}
+
 std::shared_ptr<Operator> ActorBuilder::GetOperator(const std::string& strOperatorName)
 {
     auto iter = m_mapOperator.find(strOperatorName);
@@ -879,9 +964,8 @@ std::shared_ptr<Operator> ActorBuilder::GetOperator(const std::string& strOperat
 
 bool ActorBuilder::ResetTimeout(std::shared_ptr<Actor> pSharedActor)
 {
-    ev_timer* watcher = pSharedActor->MutableWatcher()->MutableTimerWatcher();
-    ev_tstamp after = m_pLabor->GetNowTime() + pSharedActor->GetTimeout();
-    m_pLabor->GetDispatcher()->RefreshEvent(watcher, after);
+    CTimingWheel::tagTimer* pTimer = pSharedActor->MutableWatcher()->MutableTimer();
+    m_pLabor->GetDispatcher()->RefreshTimer(pTimer, pSharedActor->GetTimeout());
     return(true);
 }
 
@@ -20,6 +20,8 @@
 #include <sstream>
 #include <fstream>
 #include <memory>
+#include <atomic>
+#include <functional>
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -88,9 +90,9 @@ public:
     bool Init(CJsonObject& oBootLoadConf, CJsonObject& oDynamicLoadConf);
     bool Init(CJsonObject& oDynamicLoadConf);
 
-    static void StepTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
-    static void SessionTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
-    static void ChainTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
+    static void StepTimeoutCallback(void* pData);
+    static void SessionTimeoutCallback(void* pData);
+    static void ChainTimeoutCallback(void* pData);
     bool OnStepTimeout(std::shared_ptr<Step> pStep);
     bool OnSessionTimeout(std::shared_ptr<Session> pSession);
     bool OnChainTimeout(std::shared_ptr<Chain> pChain);
@@ -142,6 +144,7 @@ public:
     virtual std::shared_ptr<Session> GetSession(uint32 uiSessionId);
     virtual std::shared_ptr<Session> GetSession(const std::string& strSessionId);
     virtual bool ExecStep(uint32 uiStepSeq, int iErrno = ERR_OK, const std::string& strErrMsg = "", void* data = NULL);
+    bool AsyncCompute(uint32 uiStepSeq, std::function<int32(std::string&)>&& fnCompute);
     virtual std::shared_ptr<Operator> GetOperator(const std::string& strOperatorName);
     virtual bool ResetTimeout(std::shared_ptr<Actor> pSharedActor);
     int32 GetStepNum();
@@ -154,7 +157,10 @@ public:
 protected:
     void RemoveStep(std::shared_ptr<Step> pStep);
     void RemoveChain(uint32 uiChainId);
+    bool OnComputeResult(uint32 uiStepSeq, int32 iErrno, const std::string& strResult);
+    void CancelCompute(uint32 uiStepSeq);     ///< Step结束时取消其尚未执行的计算任务
     void ChannelNotice(std::shared_ptr<SocketChannel> pChannel, const std::string& strIdentify, const std::string& strClientData);
+    void WatermarkNotice(std::shared_ptr<SocketChannel> pChannel, bool bHighWatermark);
 
     void LoadSysCmd();
     void BootLoadCmd(CJsonObject& oCmdConf);
@@ -182,6 +188,7 @@ private:
     std::unordered_map<std::string, std::shared_ptr<Step> > m_mapClusterChannelStep;    //集群回调，发往集群的请求和响应都会经由ClusterChannelStep截获再收发
     std::unordered_map<std::string, std::shared_ptr<Session> > m_mapCallbackSession;
     std::unordered_set<std::shared_ptr<Session> > m_setAssemblyLine;   ///< 资源就绪后执行队列
+    std::unordered_map<uint32, std::shared_ptr<std::atomic<bool>> > m_mapComputeCancel;    ///< key为提交了计算任务的Step的seq，同一Step的任务共用取消标志
 
     friend class Manager;
     friend class Worker;
@@ -46,6 +46,10 @@ enum E_CMD
     CMD_RSP_FD_TRANSFER                 = 20,   ///< 通过SpecChannel传送文件描述符响应（无须响应）
     CMD_REQ_CHANNEL_MIGRATE             = 21,   ///< 通过SpecChannel迁移SocketChannel请求
     CMD_RSP_CHANNEL_MIGRATE             = 22,   ///< 通过SpecChannel迁移SocketChannel响应（无须响应）
+    CMD_REQ_CHANNEL_WATERMARK           = 23,   ///< 连接待发送数据越过高/低水位（由框架层触发通知并以Cmd的形式通知到业务Cmd，业务层可据此降载）
+    CMD_RSP_CHANNEL_WATERMARK           = 24,   ///< 无意义，不会被使用
+    CMD_REQ_CHANNEL_REBALANCE           = 25,   ///< 负载均衡：Manager通知高负载Worker迁出一个连接到低负载Worker
+    CMD_RSP_CHANNEL_REBALANCE           = 26,   ///< 负载均衡响应（无须响应）
 
     CMD_REQ_NODE_STATUS_REPORT          = 101,  ///< 节点Server状态上报请求（各节点向控制中心上报自身状态信息）
     CMD_RSP_NODE_STATUS_REPORT          = 102,  ///< 节点Server状态上报应答
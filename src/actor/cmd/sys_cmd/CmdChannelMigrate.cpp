@@ -12,6 +12,7 @@
 #include "ios/Dispatcher.hpp"
 #include "ios/ChannelWatcher.hpp"
 #include "actor/step/Step.hpp"
+#include "util/CBufferPool.hpp"
 
 namespace neb
 {
@@ -29,6 +30,7 @@ bool CmdChannelMigrate::AnyMessage(
             std::shared_ptr<SocketChannel> pChannel, SocketChannelPack& oPack)
 {
     auto pMigratedChannel = oPack.UnpackChannel();
+    CBufferPool::Instance().AddInUseBytes((int64_t)pMigratedChannel->GetBufferBytes());   // 迁出方已扣除
     GetLabor(this)->GetDispatcher()->AddChannelToLoop(pMigratedChannel);
     LOG4_INFO("channel[%d] with codec_type %d migrate done.",
             pMigratedChannel->GetFd(), pMigratedChannel->GetCodecType());
@@ -0,0 +1,57 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CmdChannelRebalance.cpp
+ * @brief    负载均衡连接迁移
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include "CmdChannelRebalance.hpp"
+#include "channel/SocketChannel.hpp"
+#include "ios/Dispatcher.hpp"
+#include "util/json/CJsonObject.hpp"
+
+namespace neb
+{
+
+CmdChannelRebalance::CmdChannelRebalance(int32 iCmd)
+    : Cmd(iCmd)
+{
+}
+
+CmdChannelRebalance::~CmdChannelRebalance()
+{
+}
+
+bool CmdChannelRebalance::AnyMessage(
+        std::shared_ptr<SocketChannel> pChannel,
+        const MsgHead& oInMsgHead,
+        const MsgBody& oInMsgBody)
+{
+    CJsonObject oRebalance;
+    uint32 uiToLabor = 0;
+    double dMinMsgRate = 0.0;
+    double dMaxMsgRate = 0.0;
+    if (!oRebalance.Parse(oInMsgBody.data())
+            || !oRebalance.Get("to_labor", uiToLabor)
+            || !oRebalance.Get("min_msg_rate", dMinMsgRate)
+            || !oRebalance.Get("max_msg_rate", dMaxMsgRate))
+    {
+        LOG4_ERROR("invalid rebalance data: %s", oInMsgBody.data().c_str());
+        return(false);
+    }
+    auto pDispatcher = GetLabor(this)->GetDispatcher();
+    auto pMigrateChannel = pDispatcher->GetRebalanceChannel(dMinMsgRate, dMaxMsgRate);
+    if (pMigrateChannel == nullptr)
+    {
+        LOG4_DEBUG("no channel with msg rate in [%lf, %lf) to migrate.", dMinMsgRate, dMaxMsgRate);
+        return(true);
+    }
+    LOG4_NOTICE("rebalance: migrate channel[%d] %u msg in current period from labor %u to labor %u.",
+            pMigrateChannel->GetFd(), pMigrateChannel->GetUnitTimeMsgNum(), GetLaborId(), uiToLabor);
+    return(pDispatcher->MigrateSocketChannel(GetLaborId(), uiToLabor, pMigrateChannel));
+}
+
+} /* namespace neb */
+
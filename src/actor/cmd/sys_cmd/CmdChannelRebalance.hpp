@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CmdChannelRebalance.hpp
+ * @brief    负载均衡连接迁移
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     收到Manager的负载均衡通知后，选取本Worker中可迁移的接收消息最多的连接
+ *           迁移到指定的低负载Worker。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_ACTOR_CMD_SYS_CMD_CMDCHANNELREBALANCE_HPP_
+#define SRC_ACTOR_CMD_SYS_CMD_CMDCHANNELREBALANCE_HPP_
+
+#include "actor/ActorSys.hpp"
+#include "actor/cmd/Cmd.hpp"
+
+namespace neb
+{
+
+class CmdChannelRebalance: public Cmd,
+    public DynamicCreator<CmdChannelRebalance, int32>, public ActorSys
+{
+public:
+    CmdChannelRebalance(int32 iCmd);
+    virtual ~CmdChannelRebalance();
+    virtual bool AnyMessage(
+                    std::shared_ptr<SocketChannel> pChannel,
+                    const MsgHead& oInMsgHead,
+                    const MsgBody& oInMsgBody);
+};
+
+} /* namespace neb */
+
+#endif /* SRC_ACTOR_CMD_SYS_CMD_CMDCHANNELREBALANCE_HPP_ */
+
@@ -13,6 +13,7 @@
 #include "ios/Dispatcher.hpp"
 #include "labor/NodeInfo.hpp"
 #include "actor/step/PbStep.hpp"
+#include "codec/CodecUtil.hpp"
 
 namespace neb
 {
@@ -31,12 +32,71 @@ bool CmdFdTransfer::AnyMessage(
         const MsgHead& oInMsgHead,
         const MsgBody& oInMsgBody)
 {
-    FdTransfer oFdTransferInfo;
-    if (!oFdTransferInfo.ParseFromString(oInMsgBody.data()))
+    // data为一个或多个“4字节长度（网络字节序）+ FdTransfer”，先全部解析再创建连接，
+    // 以便解析失败时关闭本批次所有fd
+    const std::string& strData = oInMsgBody.data();
+    std::vector<FdTransfer> vecFdTransfer;
+    size_t uiPos = 0;
+    while (uiPos + sizeof(uint32) <= strData.size())
     {
-        LOG4_ERROR("SpecChannelInfo ParseFromString failed.");
+        uint32 uiLength = 0;
+        memcpy(&uiLength, strData.data() + uiPos, sizeof(uiLength));
+        uiLength = CodecUtil::N2H(uiLength);
+        uiPos += sizeof(uiLength);
+        if (uiPos + uiLength > strData.size())
+        {
+            LOG4_ERROR("invalid fd transfer data length %u.", uiLength);
+            CloseTransferFd(oInMsgBody, vecFdTransfer);
+            return(false);
+        }
+        vecFdTransfer.emplace_back();
+        if (!vecFdTransfer.back().ParseFromArray(strData.data() + uiPos, uiLength))
+        {
+            LOG4_ERROR("FdTransfer ParseFromArray failed.");
+            vecFdTransfer.pop_back();
+            CloseTransferFd(oInMsgBody, vecFdTransfer);
+            return(false);
+        }
+        uiPos += uiLength;
+    }
+    if (uiPos != strData.size())
+    {
+        LOG4_ERROR("invalid fd transfer data, %u bytes left.", (uint32)(strData.size() - uiPos));
+        CloseTransferFd(oInMsgBody, vecFdTransfer);
         return(false);
     }
+    for (auto iter = vecFdTransfer.begin(); iter != vecFdTransfer.end(); ++iter)
+    {
+        AddChannel(*iter);
+    }
+    return(true);
+}
+
+void CmdFdTransfer::CloseTransferFd(const MsgBody& oInMsgBody, const std::vector<FdTransfer>& vecFdTransfer)
+{
+    // add_on为本批次全部fd（每个4字节，网络字节序）
+    const std::string& strFdList = oInMsgBody.add_on();
+    if (strFdList.size() > 0)
+    {
+        for (size_t i = 0; i + sizeof(uint32) <= strFdList.size(); i += sizeof(uint32))
+        {
+            uint32 uiFd = 0;
+            memcpy(&uiFd, strFdList.data() + i, sizeof(uiFd));
+            int iFd = (int)CodecUtil::N2H(uiFd);
+            LOG4_WARNING("close transfer fd %d.", iFd);
+            close(iFd);
+        }
+        return;
+    }
+    for (auto iter = vecFdTransfer.begin(); iter != vecFdTransfer.end(); ++iter)
+    {
+        LOG4_WARNING("close transfer fd %d.", iter->fd());
+        close(iter->fd());
+    }
+}
+
+void CmdFdTransfer::AddChannel(const FdTransfer& oFdTransferInfo)
+{
     LOG4_INFO("%s:%d fd[%d] transfer, addr_family %d with codec_type %d",
             oFdTransferInfo.client_addr().c_str(),
             oFdTransferInfo.client_port(), oFdTransferInfo.fd(),
@@ -62,11 +122,10 @@ bool CmdFdTransfer::AnyMessage(
             pNewChannel->SetKeepAlive(GetNodeInfo().dIoTimeout);
             std::shared_ptr<Step> pStepTellWorker
                 = GetLabor(this)->GetActorBuilder()->MakeSharedStep(nullptr, "neb::StepTellWorker", pNewChannel);
-            if (nullptr == pStepTellWorker)
+            if (nullptr != pStepTellWorker)
             {
-                return(false);
+                pStepTellWorker->Emit(ERR_OK);
             }
-            pStepTellWorker->Emit(ERR_OK);
         }
         else
         {
@@ -77,13 +136,11 @@ bool CmdFdTransfer::AnyMessage(
             pNewChannel->SetKeepAlive(dIoTimeout);
         }
         GetLabor(this)->IoStatAddConnection(IO_STAT_DOWNSTREAM_NEW_CONNECTION);
-        return(true);
     }
     else    // 没有足够资源分配给新连接，直接close掉
     {
         close(oFdTransferInfo.fd());
     }
-    return(true);
 }
 
 } /* namespace neb */
@@ -16,6 +16,8 @@
 namespace neb
 {
 
+class FdTransfer;
+
 class CmdFdTransfer: public Cmd,
     public DynamicCreator<CmdFdTransfer, int32>, public ActorSys
 {
@@ -26,6 +28,15 @@ public:
                     std::shared_ptr<SocketChannel> pChannel,
                     const MsgHead& oInMsgHead,
                     const MsgBody& oInMsgBody);
+
+protected:
+    void AddChannel(const FdTransfer& oFdTransferInfo);
+
+    /**
+     * @brief 解析失败时关闭本批次收到的全部fd（此时尚未有fd转交给SocketChannel）
+     * @note 优先按add_on中的fd列表关闭，add_on为空时只能关闭已解析出的fd
+     */
+    void CloseTransferFd(const MsgBody& oInMsgBody, const std::vector<FdTransfer>& vecFdTransfer);
 };
 
 } /* namespace neb */
@@ -62,8 +62,9 @@ bool CmdSpecChannelCreated::AnyMessage(
                     std::move(const_cast<MsgBody&>(oInMsgBody)));
             if (iResult == ERR_OK)
             {
-                LaborShared::Instance()->GetDispatcher(oSpecInfo.to_labor())->AsyncSend(
-                        pNoticeSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+                LaborShared::Instance()->GetDispatcher(pNoticeSpecChannel->GetFromLaborId())->AsyncSend(
+                        LaborShared::Instance()->GetDispatcher(oSpecInfo.to_labor()),
+                        pNoticeSpecChannel->MutableWatcher());
             }
             else
             {
@@ -30,7 +30,8 @@ namespace neb
 {
 
 SessionManager::SessionManager(ev_tstamp dStatInterval)
-    : Session("neb::SessionManager", dStatInterval)
+    : Session("neb::SessionManager", dStatInterval),
+      m_oRandom((uint32)time(nullptr) ^ (uint32)getpid())
 {
 }
 
@@ -101,6 +102,7 @@ E_CMD_STATUS SessionManager::Timeout()
     pRecord->set_item("nebula");
     pRecord->add_value(uiConnect);
     pRecord->set_value_type(ReportRecord::VALUE_FIXED);
+    Rebalance();
     std::string strSessionId = "neb::SessionDataReport";
     auto pSharedSession = GetSession(strSessionId);
     if (pSharedSession == nullptr)
@@ -335,6 +337,10 @@ bool SessionManager::SetWorkerLoad(uint32 uiWorkerIndex, const ReportRecord& oWo
     m_vecWorkerInfo[uiWorkerIndex]->uiRecvByte = oWorkerStatus.value(3);
     m_vecWorkerInfo[uiWorkerIndex]->uiSendNum = oWorkerStatus.value(4);
     m_vecWorkerInfo[uiWorkerIndex]->uiSendByte = oWorkerStatus.value(5);
+    if (oWorkerStatus.value_size() > 6)
+    {
+        m_vecWorkerInfo[uiWorkerIndex]->uiLoopCpuTime = oWorkerStatus.value(6);
+    }
     return(true);
 }
 
@@ -391,6 +397,59 @@ int32 SessionManager::GetDispatchWorkerId(int32 iListenFd, const char* szRemoteA
     }
 }
 
+int32 SessionManager::GetMinLoadWorkerId(int32 iListenFd)
+{
+    uint32 uiCandidateNum = 0;
+    const std::vector<uint32>* pBondingWorker = nullptr;
+    auto fd_iter = m_mapListenFd2Worker.find(iListenFd);
+    if (fd_iter == m_mapListenFd2Worker.end())  // no bonding
+    {
+        if (m_vecWorkerInfo.size() < 2)
+        {
+            return(-1); // no worker
+        }
+        uiCandidateNum = m_vecWorkerInfo.size() - 1;    // loader的worker编号为0
+    }
+    else
+    {
+        pBondingWorker = &fd_iter->second.second;
+        uiCandidateNum = pBondingWorker->size();
+        if (uiCandidateNum == 0)
+        {
+            return(-1);
+        }
+    }
+
+    uint32 uiFirst = m_oRandom() % uiCandidateNum;
+    uint32 uiSecond = uiFirst;
+    if (uiCandidateNum > 1)
+    {
+        uiSecond = (uiFirst + 1 + m_oRandom() % (uiCandidateNum - 1)) % uiCandidateNum;
+    }
+    uint32 uiFirstWorker = (pBondingWorker == nullptr) ? uiFirst + 1 : (*pBondingWorker)[uiFirst];
+    uint32 uiSecondWorker = (pBondingWorker == nullptr) ? uiSecond + 1 : (*pBondingWorker)[uiSecond];
+    uint32 uiWorkerIndex = (GetWorkerLoadScore(uiSecondWorker) < GetWorkerLoadScore(uiFirstWorker))
+            ? uiSecondWorker : uiFirstWorker;
+    if (uiWorkerIndex < m_vecWorkerInfo.size() && m_vecWorkerInfo[uiWorkerIndex] != nullptr)
+    {
+        // 下次负载上报之前先按已分发的连接累计，避免连续分发到同一个Worker
+        ++m_vecWorkerInfo[uiWorkerIndex]->uiConnection;
+    }
+    return(uiWorkerIndex);
+}
+
+uint64 SessionManager::GetWorkerLoadScore(uint32 uiWorkerIndex) const
+{
+    if (uiWorkerIndex >= m_vecWorkerInfo.size() || m_vecWorkerInfo[uiWorkerIndex] == nullptr)
+    {
+        return(UINT64_MAX);
+    }
+    // 连接数与待处理步骤数之和，按事件循环每次迭代的CPU时间加权（每迭代1毫秒CPU时间得分翻倍）
+    const WorkerInfo& stWorkerInfo = *m_vecWorkerInfo[uiWorkerIndex];
+    return(((uint64)stWorkerInfo.uiConnection + stWorkerInfo.uiLoad + 1)
+            * (1000 + stWorkerInfo.uiLoopCpuTime));
+}
+
 bool SessionManager::CheckWorker()
 {
     LOG4_TRACE(" ");
@@ -413,6 +472,88 @@ bool SessionManager::CheckWorker()
     return(true);
 }
 
+void SessionManager::Rebalance()
+{
+    const NodeInfo& stNodeInfo = GetLabor(this)->GetNodeInfo();
+    if (!stNodeInfo.bThreadMode || !stNodeInfo.bRebalance)
+    {
+        return;
+    }
+    uint64 ullTotalRecvNum = 0;
+    uint32 uiWorkerNum = 0;
+    std::shared_ptr<WorkerInfo> pHotWorker = nullptr;
+    std::shared_ptr<WorkerInfo> pColdWorker = nullptr;
+    for (uint32 i = 1; i < m_vecWorkerInfo.size(); ++i)   // loader的worker编号为0
+    {
+        if (m_vecWorkerInfo[i] == nullptr)
+        {
+            continue;
+        }
+        ullTotalRecvNum += m_vecWorkerInfo[i]->uiRecvNum;
+        ++uiWorkerNum;
+    }
+    if (uiWorkerNum < 2 || ullTotalRecvNum == 0)
+    {
+        return;
+    }
+    double dAvgRecvNum = (double)ullTotalRecvNum / uiWorkerNum;
+    ev_tstamp dNow = GetNowTime();
+    for (uint32 i = 1; i < m_vecWorkerInfo.size(); ++i)
+    {
+        auto& pWorkerInfo = m_vecWorkerInfo[i];
+        if (pWorkerInfo == nullptr)
+        {
+            continue;
+        }
+        if (pWorkerInfo->uiRecvNum > dAvgRecvNum * stNodeInfo.dRebalanceHighRatio)
+        {
+            ++pWorkerInfo->uiHotRound;
+        }
+        else
+        {
+            pWorkerInfo->uiHotRound = 0;
+        }
+        if (dNow - pWorkerInfo->dLastMigrateTime < stNodeInfo.dRebalanceCooldown)
+        {
+            continue;
+        }
+        if (pWorkerInfo->uiHotRound >= stNodeInfo.uiRebalanceHotRound
+                && (pHotWorker == nullptr || pWorkerInfo->uiRecvNum > pHotWorker->uiRecvNum))
+        {
+            pHotWorker = pWorkerInfo;
+        }
+        if (pWorkerInfo->uiRecvNum < dAvgRecvNum * stNodeInfo.dRebalanceLowRatio
+                && (pColdWorker == nullptr || pWorkerInfo->uiRecvNum < pColdWorker->uiRecvNum))
+        {
+            pColdWorker = pWorkerInfo;
+        }
+    }
+    if (pHotWorker == nullptr || pColdWorker == nullptr)
+    {
+        return;
+    }
+
+    // 只迁移消息数小于两者差值一半的连接：迁移消息数为r的连接后源Worker为hot-r、目标Worker为cold+r，
+    // r < (hot-cold)/2时目标Worker仍比源Worker空闲，避免冷热反转后来回迁移
+    double dInterval = (stNodeInfo.dDataReportInterval > 0) ? stNodeInfo.dDataReportInterval : 1.0;
+    CJsonObject oRebalance;
+    oRebalance.Add("to_labor", pColdWorker->iWorkerIndex);
+    oRebalance.Add("min_msg_rate", (double)stNodeInfo.uiRebalanceMinMsg);
+    oRebalance.Add("max_msg_rate",
+            ((double)pHotWorker->uiRecvNum - (double)pColdWorker->uiRecvNum) / 2 / dInterval);
+    MsgHead oMsgHead;
+    MsgBody oMsgBody;
+    oMsgBody.set_data(oRebalance.ToString());
+    oMsgHead.set_cmd(CMD_REQ_CHANNEL_REBALANCE);
+    LOG4_NOTICE("rebalance: worker %d recv %u, worker %d recv %u, average %.1lf",
+            pHotWorker->iWorkerIndex, pHotWorker->uiRecvNum,
+            pColdWorker->iWorkerIndex, pColdWorker->uiRecvNum, dAvgRecvNum);
+    IO<CodecNebulaInNode>::TransmitTo(this, pHotWorker->iWorkerIndex, GetSequence(), oMsgHead, oMsgBody);
+    pHotWorker->uiHotRound = 0;
+    pHotWorker->dLastMigrateTime = dNow;
+    pColdWorker->dLastMigrateTime = dNow;
+}
+
 void SessionManager::SendOnlineNodesToWorker()
 {
     // 重启Worker进程后下发其他节点的信息
@@ -11,6 +11,7 @@
 #ifndef SRC_ACTOR_SESSION_SYS_SESSION_MANAGER_SESSIONMANAGER_HPP_
 #define SRC_ACTOR_SESSION_SYS_SESSION_MANAGER_SESSIONMANAGER_HPP_
 
+#include <random>
 #include "actor/ActorSys.hpp"
 #include "labor/NodeInfo.hpp"
 #include "actor/session/Session.hpp"
@@ -46,12 +47,26 @@ public:
     void SetLoaderActorBuilder(ActorBuilder* pActorBuilder);
     int32 GetDispatchWorkerId(int32 iListenFd);
     int32 GetDispatchWorkerId(int32 iListenFd, const char* szRemoteAddr, int iRemotePort);
+    /**
+     * @brief 最小负载分发：随机取两个候选Worker，选负载得分低者（power of two choices），
+     *        避免所有新连接都涌向上报数据已过时的同一个“最空闲”Worker
+     */
+    int32 GetMinLoadWorkerId(int32 iListenFd);
     bool CheckWorker();
+    /**
+     * @brief 连接负载均衡：接收消息数持续高于平均值的Worker迁出一个连接到低负载Worker
+     * @note 每个统计周期最多迁移一个连接，参与迁移的Worker在冷却时间内不再参与迁移
+     */
+    void Rebalance();
     void SendOnlineNodesToWorker();
     void MakeReportData(CJsonObject& oReportJson);
 
+private:
+    uint64 GetWorkerLoadScore(uint32 uiWorkerIndex) const;
+
 private:
     uint32 m_uiRoundRobin = 0;
+    std::minstd_rand m_oRandom;
     std::vector<std::shared_ptr<WorkerInfo>> m_vecWorkerInfo;
     std::unordered_map<int, std::pair<uint32, std::vector<uint32>>> m_mapListenFd2Worker;
 
@@ -19,6 +19,10 @@ struct ChannelOption
 {
     bool bPipeline = false;
     bool bWithSsl = false;
+    bool bCork = false;                 ///< 合并同一轮事件循环内的多次发送
+    uint32 uiSendHighWatermark = 0;     ///< 待发送数据高水位（字节），超过则停止从该连接读取，0为不限制
+    uint32 uiSendLowWatermark = 0;      ///< 待发送数据低水位（字节），低于则恢复读取
+    uint32 uiZeroCopyThreshold = 0;     ///< 单次发送数据量不小于该值时使用MSG_ZEROCOPY（字节），0为不使用
     int iSocketType = SOCKET_STREAM;
     ev_tstamp dKeepAlive = 7.0;
     std::string strAuth;
@@ -29,6 +33,10 @@ struct ChannelOption
     {
         bPipeline = stOption.bPipeline;
         bWithSsl = stOption.bWithSsl;
+        bCork = stOption.bCork;
+        uiSendHighWatermark = stOption.uiSendHighWatermark;
+        uiSendLowWatermark = stOption.uiSendLowWatermark;
+        uiZeroCopyThreshold = stOption.uiZeroCopyThreshold;
         iSocketType = stOption.iSocketType;
         dKeepAlive = stOption.dKeepAlive;
         strAuth = stOption.strAuth;
@@ -38,6 +46,10 @@ struct ChannelOption
     {
         bPipeline = stOption.bPipeline;
         bWithSsl = stOption.bWithSsl;
+        bCork = stOption.bCork;
+        uiSendHighWatermark = stOption.uiSendHighWatermark;
+        uiSendLowWatermark = stOption.uiSendLowWatermark;
+        uiZeroCopyThreshold = stOption.uiZeroCopyThreshold;
         iSocketType = stOption.iSocketType;
         dKeepAlive = stOption.dKeepAlive;
         strAuth = std::move(stOption.strAuth);
@@ -47,6 +59,10 @@ struct ChannelOption
     {
         bPipeline = stOption.bPipeline;
         bWithSsl = stOption.bWithSsl;
+        bCork = stOption.bCork;
+        uiSendHighWatermark = stOption.uiSendHighWatermark;
+        uiSendLowWatermark = stOption.uiSendLowWatermark;
+        uiZeroCopyThreshold = stOption.uiZeroCopyThreshold;
         iSocketType = stOption.iSocketType;
         dKeepAlive = stOption.dKeepAlive;
         strAuth = stOption.strAuth;
@@ -57,6 +73,10 @@ struct ChannelOption
     {
         bPipeline = stOption.bPipeline;
         bWithSsl = stOption.bWithSsl;
+        bCork = stOption.bCork;
+        uiSendHighWatermark = stOption.uiSendHighWatermark;
+        uiSendLowWatermark = stOption.uiSendLowWatermark;
+        uiZeroCopyThreshold = stOption.uiZeroCopyThreshold;
         iSocketType = stOption.iSocketType;
         dKeepAlive = stOption.dKeepAlive;
         strAuth = std::move(stOption.strAuth);
@@ -25,12 +25,12 @@ namespace neb
 {
 
 SocketChannel::SocketChannel()
-    : m_bIsClient(false), m_bWithSsl(false), m_bMigrated(false), m_pImpl(nullptr), m_pLogger(nullptr), m_pWatcher(nullptr)
+    : m_bIsClient(false), m_bWithSsl(false), m_bMigrated(false), m_bCorkPending(false), m_bReadSuspended(false), m_bDeferPending(false), m_bAutoMigrate(false), m_bRingIo(false), m_ullRingRecvId(0), m_ullRingSendId(0), m_pImpl(nullptr), m_pLogger(nullptr), m_pWatcher(nullptr)
 {
 }
 
 SocketChannel::SocketChannel(std::shared_ptr<NetLogger> pLogger, bool bIsClient, bool bWithSsl)
-    : m_bIsClient(bIsClient), m_bWithSsl(bWithSsl), m_bMigrated(false), m_pImpl(nullptr), m_pLogger(pLogger), m_pWatcher(nullptr)
+    : m_bIsClient(bIsClient), m_bWithSsl(bWithSsl), m_bMigrated(false), m_bCorkPending(false), m_bReadSuspended(false), m_bDeferPending(false), m_bAutoMigrate(false), m_bRingIo(false), m_ullRingRecvId(0), m_ullRingSendId(0), m_pImpl(nullptr), m_pLogger(pLogger), m_pWatcher(nullptr)
 {
 }
 
@@ -183,6 +183,26 @@ ev_tstamp SocketChannel::GetLastRecvTime() const
     return(m_pImpl->GetLastRecvTime());
 }
 
+uint64 SocketChannel::GetMonotonicActiveTime() const
+{
+    if (m_pImpl == nullptr)
+    {
+        LOG4_TRACE("m_pImpl is nullptr");
+        return(0);
+    }
+    return(m_pImpl->GetMonotonicActiveTime());
+}
+
+uint64 SocketChannel::GetMonotonicRecvTime() const
+{
+    if (m_pImpl == nullptr)
+    {
+        LOG4_TRACE("m_pImpl is nullptr");
+        return(0);
+    }
+    return(m_pImpl->GetMonotonicRecvTime());
+}
+
 ev_tstamp SocketChannel::GetKeepAlive() const
 {
     if (m_pImpl == nullptr)
@@ -263,6 +283,14 @@ uint32 SocketChannel::GetUnitTimeMsgNum() const
     return(m_pImpl->GetUnitTimeMsgNum());
 }
 
+void SocketChannel::ResetUnitTimeMsgNum()
+{
+    if (m_pImpl != nullptr)
+    {
+        m_pImpl->ResetUnitTimeMsgNum();
+    }
+}
+
 E_CODEC_STATUS SocketChannel::Send()
 {
     if (m_pImpl == nullptr)
@@ -327,6 +355,129 @@ void SocketChannel::SetKeepAlive(ev_tstamp dTime)
     }
 }
 
+bool SocketChannel::IsCork() const
+{
+    if (m_pImpl == nullptr)
+    {
+        return(false);
+    }
+    return(m_pImpl->IsCork());
+}
+
+void SocketChannel::SetCork(bool bCork)
+{
+    if (m_pImpl != nullptr)
+    {
+        m_pImpl->SetCork(bCork);
+    }
+}
+
+size_t SocketChannel::GetBufferBytes() const
+{
+    if (m_pImpl == nullptr)
+    {
+        return(0);
+    }
+    return(m_pImpl->GetBufferBytes());
+}
+
+size_t SocketChannel::GetSendQueueBytes() const
+{
+    if (m_pImpl == nullptr)
+    {
+        return(0);
+    }
+    return(m_pImpl->GetSendQueueBytes());
+}
+
+uint32 SocketChannel::GetSendHighWatermark() const
+{
+    if (m_pImpl == nullptr)
+    {
+        return(0);
+    }
+    return(m_pImpl->GetSendHighWatermark());
+}
+
+uint32 SocketChannel::GetSendLowWatermark() const
+{
+    if (m_pImpl == nullptr)
+    {
+        return(0);
+    }
+    return(m_pImpl->GetSendLowWatermark());
+}
+
+bool SocketChannel::ReleaseBuffer()
+{
+    if (m_pImpl == nullptr)
+    {
+        return(false);
+    }
+    return(m_pImpl->ReleaseBuffer());
+}
+
+int SocketChannel::ReapZeroCopy()
+{
+    if (m_pImpl == nullptr)
+    {
+        return(0);
+    }
+    return(m_pImpl->ReapZeroCopy());
+}
+
+bool SocketChannel::TakeZeroCopyPending(CBufferChain& oChain)
+{
+    if (m_pImpl == nullptr)
+    {
+        return(false);
+    }
+    return(m_pImpl->TakeZeroCopyPending(oChain));
+}
+
+bool SocketChannel::SetRingIo(bool bRingIo)
+{
+    if (m_pImpl == nullptr || !m_pImpl->SetRingIo(bRingIo))
+    {
+        return(false);
+    }
+    m_bRingIo = bRingIo;
+    return(true);
+}
+
+void SocketChannel::FeedRecv(const char* pData, int iResult)
+{
+    if (m_pImpl != nullptr)
+    {
+        m_pImpl->FeedRecv(pData, iResult);
+    }
+}
+
+void SocketChannel::SetRingSendPending(bool bPending)
+{
+    if (m_pImpl != nullptr)
+    {
+        m_pImpl->SetRingSendPending(bPending);
+    }
+}
+
+int SocketChannel::PinRingSend(struct iovec* pVec, int iMaxIov)
+{
+    if (m_pImpl == nullptr)
+    {
+        return(0);
+    }
+    return(m_pImpl->PinRingSend(pVec, iMaxIov));
+}
+
+void SocketChannel::RingSendDone(size_t uiLen)
+{
+    if (m_pImpl != nullptr)
+    {
+        m_pImpl->RingSendDone(uiLen);
+    }
+}
+
 bool SocketChannel::Close()
 {
     if (m_pImpl == nullptr)
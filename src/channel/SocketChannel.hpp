@@ -10,6 +10,7 @@
 #ifndef SRC_CHANNEL_SOCKETCHANNEL_HPP_
 #define SRC_CHANNEL_SOCKETCHANNEL_HPP_
 
+#include <sys/uio.h>
 #include <string>
 #include <memory>
 #include "Channel.hpp"
@@ -58,6 +59,8 @@ public:
     virtual ev_tstamp GetActiveTime() const;
     virtual ev_tstamp GetPenultimateActiveTime() const;
     virtual ev_tstamp GetLastRecvTime() const;
+    virtual uint64 GetMonotonicActiveTime() const;     ///< CLOCK_MONOTONIC_COARSE微秒
+    virtual uint64 GetMonotonicRecvTime() const;       ///< CLOCK_MONOTONIC_COARSE微秒
     virtual ev_tstamp GetKeepAlive() const;
     virtual int GetErrno() const;
     virtual const std::string& GetErrMsg() const;
@@ -66,6 +69,7 @@ public:
     virtual bool NeedAliveCheck() const;
     virtual uint32 GetMsgNum() const;
     virtual uint32 GetUnitTimeMsgNum() const;
+    virtual void ResetUnitTimeMsgNum();
     virtual E_CODEC_STATUS Send();
     virtual uint32 GetPeerStepSeq() const;
     virtual void SetChannelStatus(E_CHANNEL_STATUS eStatus);
@@ -73,11 +77,38 @@ public:
     virtual void SetIdentify(const std::string& strIdentify);
     virtual void SetRemoteAddr(const std::string& strRemoteAddr);
     virtual void SetKeepAlive(ev_tstamp dTime);
+    virtual bool IsCork() const;
+    virtual void SetCork(bool bCork);
+    virtual size_t GetBufferBytes() const;
+    virtual size_t GetSendQueueBytes() const;       ///< 待发送的字节数
+    virtual uint32 GetSendHighWatermark() const;
+    virtual uint32 GetSendLowWatermark() const;
+    virtual bool ReleaseBuffer();
 
     bool IsMigrated() const
     {
         return(m_bMigrated);
     }
+    /**
+     * @brief 待发送数据是否超过高水位（超过时已停止从该连接读取，降到低水位后恢复）
+     */
+    bool IsReadSuspended() const
+    {
+        return(m_bReadSuspended);
+    }
+    /**
+     * @brief 是否允许负载均衡时自动迁移到其他Worker（默认不允许）
+     * @note 框架无法得知业务Step是否仍持有该连接，由业务确认连接上没有在本Worker处理中的
+     *       异步请求、连接状态也不与本Worker绑定后调用SetAutoMigrate(true)开启
+     */
+    bool IsAutoMigrate() const
+    {
+        return(m_bAutoMigrate);
+    }
+    void SetAutoMigrate(bool bAutoMigrate)
+    {
+        m_bAutoMigrate = bAutoMigrate;
+    }
     ChannelWatcher* MutableWatcher();
 
     template <typename ...Targs>
@@ -86,6 +117,13 @@ protected:
     virtual Labor* GetLabor();
     virtual int16 GetRemoteWorkerIndex() const;
     virtual bool Close();
+    virtual int ReapZeroCopy();
+    virtual bool TakeZeroCopyPending(CBufferChain& oChain);     ///< 取走仍被内核零拷贝引用的发送段
+    virtual bool SetRingIo(bool bRingIo);                       ///< 收发改由Dispatcher的io_uring完成（不支持SSL）
+    virtual void FeedRecv(const char* pData, int iResult);      ///< 交给下一次Read()的io_uring接收结果
+    virtual void SetRingSendPending(bool bPending);             ///< io_uring发送未完成期间不直接写socket
+    virtual int PinRingSend(struct iovec* pVec, int iMaxIov);  ///< 以发送队列队首的段填充iovec，发送完成前段不释放
+    virtual void RingSendDone(size_t uiLen);                    ///< io_uring发送完成，从发送队列移除并解除对段的引用
     virtual void SetBonding(Labor* pLabor, std::shared_ptr<NetLogger> pLogger, std::shared_ptr<SocketChannel> pBindChannel);
     void SetMigrated(bool bMigrated);
     bool InitImpl(std::shared_ptr<SocketChannel> pImpl);
@@ -94,6 +132,13 @@ private:
     bool m_bIsClient;
     bool m_bWithSsl;
     bool m_bMigrated;
+    bool m_bCorkPending;        ///< 已在Dispatcher待发送列表中
+    bool m_bReadSuspended;      ///< 待发送数据超过高水位，已停止读
+    bool m_bDeferPending;       ///< 消息处理预算用尽，已在Dispatcher延后处理列表中
+    bool m_bAutoMigrate;        ///< 允许负载均衡自动迁移
+    bool m_bRingIo;             ///< 收发由Dispatcher的io_uring完成
+    uint64 m_ullRingRecvId;     ///< 未终止的io_uring接收（监听fd为accept）请求，0为没有
+    uint64 m_ullRingSendId;     ///< 未完成的io_uring发送请求，0为没有
     std::string m_strEmpty;
     // Hide most of the channel implementation for Actors
     std::shared_ptr<SocketChannel> m_pImpl;
@@ -11,6 +11,7 @@
 #define SRC_CHANNEL_SOCKETCHANNELIMPL_HPP_
 
 #include <memory>
+#include <sys/socket.h>
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -22,6 +23,7 @@
 #endif
 
 #include "util/CBuffer.hpp"
+#include "util/CBufferChain.hpp"
 #include "util/StreamCodec.hpp"
 #include "util/json/CJsonObject.hpp"
 
@@ -34,6 +36,10 @@
 #include "ios/ChannelWatcher.hpp"
 #include "labor/NodeInfo.hpp"
 
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+
 namespace neb
 {
 
@@ -128,6 +134,16 @@ public:
         return(m_dLastRecvTime);
     }
 
+    virtual uint64 GetMonotonicActiveTime() const override
+    {
+        return(m_ullMonotonicActiveTime);
+    }
+
+    virtual uint64 GetMonotonicRecvTime() const override
+    {
+        return(m_ullMonotonicRecvTime);
+    }
+
     virtual ev_tstamp GetKeepAlive() const override;
 
     virtual int GetErrno() const override
@@ -162,6 +178,25 @@ public:
 
     bool NeedAliveCheck() const override;
 
+    bool IsCork() const override
+    {
+        return(m_bCork);
+    }
+
+    size_t GetBufferBytes() const override;
+
+    size_t GetSendQueueBytes() const override;
+
+    uint32 GetSendHighWatermark() const override
+    {
+        return(m_uiSendHighWatermark);
+    }
+
+    uint32 GetSendLowWatermark() const override
+    {
+        return(m_uiSendLowWatermark);
+    }
+
     uint32 GetMsgNum() const override
     {
         return(m_uiMsgNum);
@@ -172,6 +207,11 @@ public:
         return(m_uiUnitTimeMsgNum);
     }
 
+    void ResetUnitTimeMsgNum() override
+    {
+        m_uiUnitTimeMsgNum = 0;
+    }
+
     const std::list<uint32>& GetPipelineStepSeq() const
     {
         return(m_listPipelineStepSeq);
@@ -205,6 +245,26 @@ public:
         m_bPipeline = bPipeline;
     }
 
+    void SetCork(bool bCork) override
+    {
+        m_bCork = bCork;
+    }
+
+    /**
+     * @brief 设置待发送数据高低水位
+     * @note uiLow为0或不小于uiHigh时取uiHigh的一半
+     */
+    void SetSendWatermark(uint32 uiHigh, uint32 uiLow)
+    {
+        m_uiSendHighWatermark = uiHigh;
+        m_uiSendLowWatermark = (uiLow == 0 || uiLow >= uiHigh) ? (uiHigh >> 1) : uiLow;
+    }
+
+    /**
+     * @brief 设置零拷贝发送阈值（0为关闭），SSL连接不支持
+     */
+    bool SetZeroCopyThreshold(uint32 uiThreshold);
+
     void SetClientData(const std::string& strClientData) override
     {
         m_strClientData = strClientData;
@@ -224,16 +284,75 @@ public:
 
     void SetRemoteWorkerIndex(int16 iRemoteWorkerIndex);
 
+    /**
+     * @brief 释放收发缓冲区的存储空间（用于空闲连接）
+     * @note 仅当所有缓冲区都没有待处理数据时释放，下次收发时重新分配
+     */
+    virtual bool ReleaseBuffer() override;
+
     virtual bool Close() override;
     virtual void SetBonding(Labor* pLabor, std::shared_ptr<NetLogger> pLogger, std::shared_ptr<SocketChannel> pBindChannel);
 
 protected:
     virtual int Write(CBuffer* pBuff, int& iErrno);
+    virtual ssize_t Write(CBufferChain* pChain, int& iErrno);
     virtual int Read(CBuffer* pBuff, int& iErrno);
 
+    /**
+     * @brief 读取零拷贝发送的完成通知并释放内核已不再引用的发送缓冲区
+     */
+    virtual int ReapZeroCopy() override;
+
+    /**
+     * @brief 连接关闭前把仍被内核零拷贝引用的发送段转移到oChain
+     * @return 有待确认的零拷贝发送时返回true
+     */
+    virtual bool TakeZeroCopyPending(CBufferChain& oChain) override;
+
+    /**
+     * @brief 切换到io_uring收发：Read()只返回FeedRecv()交来的数据，不再读socket；
+     *        SetRingSendPending(true)期间Write()不写socket，保证发送顺序
+     * @note SSL连接不支持；切换后不再使用零拷贝发送（完成通知需要读取socket错误队列）
+     */
+    virtual bool SetRingIo(bool bRingIo) override;
+    virtual void FeedRecv(const char* pData, int iResult) override;
+    virtual void SetRingSendPending(bool bPending) override
+    {
+        m_bRingSendPending = bPending;
+    }
+    virtual int PinRingSend(struct iovec* pVec, int iMaxIov) override;
+    virtual void RingSendDone(size_t uiLen) override;
+
+    uint32 GetRecvSize() const
+    {
+        return(m_uiRecvSize);
+    }
+
 private:
     bool SetCodec(Codec* pCodec);
 
+    /**
+     * @brief 根据最近的接收长度调整下次接收预留的缓冲区空间
+     * @note 读满预留空间则翻倍（大块数据流提前扩容），连续两次不足一半则减半
+     */
+    void AdaptRecvSize(int iReadLen);
+
+    /**
+     * @brief 记录访问时间：墙上时间供统计与日志，单调时间供IO超时判断（不受系统时间调整影响）
+     */
+    void RefreshActiveTime()
+    {
+        struct timespec stTime;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &stTime);
+        m_dPenultimateActiveTime = m_dActiveTime;
+        m_dActiveTime = m_pLabor->GetNowTime();
+        m_ullMonotonicActiveTime = (uint64)stTime.tv_sec * 1000000 + stTime.tv_nsec / 1000;
+    }
+
+    static const uint32 RECV_SIZE_MIN = 1024;
+    static const uint32 RECV_SIZE_INIT = 4096;
+    static const uint32 RECV_SIZE_MAX = 262144;
+
 private:
     uint8 m_ucChannelStatus;
     E_CODEC_STATUS m_eLastCodecStatus;    ///< 连接关闭前的最后一个编解码状态（当且仅当连接的应用层读缓冲区有数据未处理完而对端关闭连接时使用）
@@ -242,14 +361,27 @@ private:
     int32 m_iFd;                          ///< 文件描述符
     uint32 m_uiSeq;                       ///< 文件描述符创建时对应的序列号
     uint32 m_bPipeline;                   ///< 是否支持pipeline
+    bool m_bCork;                         ///< 是否合并发送（数据暂存在发送队列，由Dispatcher在本轮事件循环结束前统一发送）
+    uint32 m_uiRecvSize;                  ///< 自适应的单次接收预留空间
+    uint32 m_uiRecvShrinkNum;             ///< 接收长度连续不足预留空间一半的次数
+    bool m_bRingIo;                       ///< 收发由Dispatcher的io_uring完成
+    bool m_bRingSendPending;              ///< 有未完成的io_uring发送
+    bool m_bRingRecvReady;                ///< 有FeedRecv()交来的接收结果未被Read()取走
+    int m_iRingRecvResult;                ///< 接收结果：大于0为数据长度，0为对端关闭，小于0为-errno
+    const char* m_pRingRecvData;
+    uint32 m_uiSendHighWatermark;         ///< 待发送数据高水位，0为不限制
+    uint32 m_uiSendLowWatermark;          ///< 待发送数据低水位
     uint32 m_uiUnitTimeMsgNum;            ///< 统计单位时间内接收消息数量
     uint32 m_uiMsgNum;                    ///< 接收消息数量
     ev_tstamp m_dActiveTime;              ///< 最后一次访问时间
     ev_tstamp m_dPenultimateActiveTime;   ///< 倒数第二次访问时间
     ev_tstamp m_dLastRecvTime;            ///< 最后一次接收消息时间
+    uint64 m_ullMonotonicActiveTime;      ///< 最后一次访问时间（CLOCK_MONOTONIC_COARSE微秒，用于IO超时）
+    uint64 m_ullMonotonicRecvTime;        ///< 最后一次接收消息时间（CLOCK_MONOTONIC_COARSE微秒，用于IO超时）
     ev_tstamp m_dKeepAlive;               ///< 连接保持时间
     CBuffer* m_pRecvBuff;
-    CBuffer* m_pSendBuff;
+    CBuffer* m_pSendBuff;                 ///< 编码缓冲区，编码完成后转入m_pSendChain
+    CBufferChain* m_pSendChain;           ///< 分段发送队列
     CBuffer* m_pWaitForSendBuff;    ///< 等待发送的数据缓冲区（数据到达时，连接并未建立，等连接建立并且pSendBuff发送完毕后立即发送）
     Codec* m_pCodec;                      ///< 编解码器
     HttpMsg* m_pHoldingHttpMsg;           // 如果有http协议转换
@@ -273,16 +405,21 @@ SocketChannelImpl<T>::SocketChannelImpl(Labor* pLabor, std::shared_ptr<NetLogger
         bool bIsClient, bool bWithSsl, int iFd, uint32 ulSeq, ev_tstamp dKeepAlive)
     : SocketChannel(pLogger, bIsClient, bWithSsl),
       m_ucChannelStatus(CHANNEL_STATUS_INIT),m_eLastCodecStatus(CODEC_STATUS_OK),
-      m_iRemoteWorkerIdx(-1), m_iFd(iFd), m_uiSeq(ulSeq), m_bPipeline(true),
+      m_iRemoteWorkerIdx(-1), m_iFd(iFd), m_uiSeq(ulSeq), m_bPipeline(true), m_bCork(false),
+      m_uiRecvSize(RECV_SIZE_INIT), m_uiRecvShrinkNum(0),
+      m_bRingIo(false), m_bRingSendPending(false), m_bRingRecvReady(false), m_iRingRecvResult(0), m_pRingRecvData(nullptr),
+      m_uiSendHighWatermark(0), m_uiSendLowWatermark(0),
       m_uiUnitTimeMsgNum(0), m_uiMsgNum(0),
-      m_dActiveTime(0.0), m_dPenultimateActiveTime(0.0), m_dLastRecvTime(0.0), m_dKeepAlive(dKeepAlive),
-      m_pRecvBuff(nullptr), m_pSendBuff(nullptr), m_pWaitForSendBuff(nullptr),
+      m_dActiveTime(0.0), m_dPenultimateActiveTime(0.0), m_dLastRecvTime(0.0),
+      m_ullMonotonicActiveTime(0), m_ullMonotonicRecvTime(0), m_dKeepAlive(dKeepAlive),
+      m_pRecvBuff(nullptr), m_pSendBuff(nullptr), m_pSendChain(nullptr), m_pWaitForSendBuff(nullptr),
       m_pCodec(nullptr), m_pHoldingHttpMsg(nullptr), m_iErrno(0), m_pLabor(pLabor)
 {
     try
     {
         m_pRecvBuff = new CBuffer();
         m_pSendBuff = new CBuffer();
+        m_pSendChain = new CBufferChain();
         m_pWaitForSendBuff = new CBuffer();
     }
     catch(std::bad_alloc& e)
@@ -291,6 +428,10 @@ SocketChannelImpl<T>::SocketChannelImpl(Labor* pLabor, std::shared_ptr<NetLogger
     }
     //m_dActiveTime = m_pLabor->GetNowTime();
     memset(m_szErrBuff, 0, sizeof(m_szErrBuff));
+    if (m_pLabor != nullptr)
+    {
+        SetSendWatermark(m_pLabor->GetNodeInfo().uiSendHighWatermark, m_pLabor->GetNodeInfo().uiSendLowWatermark);
+    }
 }
 
 template<typename T>
@@ -306,11 +447,75 @@ SocketChannelImpl<T>::~SocketChannelImpl()
     FREE(m_pWatcher);
     DELETE(m_pRecvBuff);
     DELETE(m_pSendBuff);
+    DELETE(m_pSendChain);
     DELETE(m_pWaitForSendBuff);
     DELETE(m_pHoldingHttpMsg);
     DELETE(m_pCodec);
 }
 
+template<typename T>
+size_t SocketChannelImpl<T>::GetBufferBytes() const
+{
+    size_t uiBytes = 0;
+    if (m_pRecvBuff != nullptr)
+    {
+        uiBytes += m_pRecvBuff->Capacity();
+    }
+    if (m_pSendBuff != nullptr)
+    {
+        uiBytes += m_pSendBuff->Capacity();
+    }
+    if (m_pWaitForSendBuff != nullptr)
+    {
+        uiBytes += m_pWaitForSendBuff->Capacity();
+    }
+    if (m_pSendChain != nullptr)
+    {
+        uiBytes += m_pSendChain->Capacity();
+    }
+    return(uiBytes);
+}
+
+template<typename T>
+size_t SocketChannelImpl<T>::GetSendQueueBytes() const
+{
+    size_t uiBytes = 0;
+    if (m_pSendBuff != nullptr)
+    {
+        uiBytes += m_pSendBuff->ReadableBytes();
+    }
+    if (m_pWaitForSendBuff != nullptr)
+    {
+        uiBytes += m_pWaitForSendBuff->ReadableBytes();
+    }
+    if (m_pSendChain != nullptr)
+    {
+        uiBytes += m_pSendChain->ReadableBytes() - m_pSendChain->FileBytes();     // 文件段不占用内存
+    }
+    return(uiBytes);
+}
+
+template<typename T>
+bool SocketChannelImpl<T>::ReleaseBuffer()
+{
+    if (m_pRecvBuff == nullptr || m_pSendBuff == nullptr
+            || m_pWaitForSendBuff == nullptr || m_pSendChain == nullptr)
+    {
+        return(false);
+    }
+    if (m_pRecvBuff->ReadableBytes() > 0 || m_pSendBuff->ReadableBytes() > 0
+            || m_pWaitForSendBuff->ReadableBytes() > 0 || !m_pSendChain->Empty())
+    {
+        return(false);
+    }
+    m_pRecvBuff->Release();
+    m_pSendBuff->Release();
+    m_pWaitForSendBuff->Release();
+    m_pSendChain->Release();
+    LOG4_TRACE("fd %d, seq %u buffer released", m_iFd, m_uiSeq);
+    return(true);
+}
+
 template<typename T>
 E_CODEC_TYPE SocketChannelImpl<T>::GetCodecType() const
 {
@@ -427,25 +632,32 @@ E_CODEC_STATUS SocketChannelImpl<T>::Send()
                 m_strIdentify.c_str(), m_iFd, m_uiSeq, (int)m_ucChannelStatus, m_strRemoteAddr.c_str());
         return(CODEC_STATUS_ERR);
     }
-    int iNeedWriteLen = 0;
-    iNeedWriteLen = m_pSendBuff->ReadableBytes();
-    if (0 == iNeedWriteLen)
+    if (!m_pSendChain->Append(m_pSendBuff))
+    {
+        LOG4_ERROR("%s append to send queue failed!", m_strIdentify.c_str());
+        return(CODEC_STATUS_ERR);
+    }
+    size_t uiNeedWriteLen = 0;
+    uiNeedWriteLen = m_pSendChain->ReadableBytes();
+    if (0 == uiNeedWriteLen)
     {
         if (CHANNEL_STATUS_ESTABLISHED != m_ucChannelStatus)
         {
             return(CODEC_STATUS_OK);
         }
-        iNeedWriteLen = m_pWaitForSendBuff->ReadableBytes();
-        if (0 == iNeedWriteLen)
+        uiNeedWriteLen = m_pWaitForSendBuff->ReadableBytes();
+        if (0 == uiNeedWriteLen)
         {
             LOG4_TRACE("no data need to send.");
             return(CODEC_STATUS_OK);
         }
         else
         {
-            CBuffer* pExchangeBuff = m_pSendBuff;
-            m_pSendBuff = m_pWaitForSendBuff;
-            m_pWaitForSendBuff = pExchangeBuff;
+            if (!m_pSendChain->Append(m_pWaitForSendBuff))
+            {
+                LOG4_ERROR("%s append to send queue failed!", m_strIdentify.c_str());
+                return(CODEC_STATUS_ERR);
+            }
             m_pWaitForSendBuff->Compact(1);
         }
     }
@@ -454,20 +666,19 @@ E_CODEC_STATUS SocketChannelImpl<T>::Send()
     {
         m_dKeepAlive = m_pLabor->GetNodeInfo().dIoTimeout;
     }
-    m_dPenultimateActiveTime = m_dActiveTime;
-    m_dActiveTime = m_pLabor->GetNowTime();
-    int iHadWrittenLen = 0;
-    int iWrittenLen = 0;
+    RefreshActiveTime();
+    ssize_t iHadWrittenLen = 0;
+    ssize_t iWrittenLen = 0;
     do
     {
-        iWrittenLen = Write(m_pSendBuff, m_iErrno);
+        iWrittenLen = Write(m_pSendChain, m_iErrno);
         if (iWrittenLen > 0)
         {
             iHadWrittenLen += iWrittenLen;
         }
     }
-    while (iWrittenLen > 0 && iHadWrittenLen < iNeedWriteLen);
-    LOG4_TRACE("iNeedWriteLen = %d, iHadWrittenLen = %d", iNeedWriteLen, iHadWrittenLen);
+    while (iWrittenLen > 0 && (size_t)iHadWrittenLen < uiNeedWriteLen);
+    LOG4_TRACE("uiNeedWriteLen = %zu, iHadWrittenLen = %zd", uiNeedWriteLen, iHadWrittenLen);
     if (iHadWrittenLen >= 0)
     {
         if (m_bIsClient)
@@ -478,14 +689,8 @@ E_CODEC_STATUS SocketChannelImpl<T>::Send()
         {
             m_pLabor->IoStatAddSendBytes(m_iFd, iHadWrittenLen, IO_STAT_DOWNSTREAM_SEND_BYTE);
         }
-        if (m_pSendBuff->Capacity() > CBuffer::BUFFER_MAX_READ
-            && (m_pSendBuff->ReadableBytes() < m_pSendBuff->Capacity() / 2))
-        {
-            m_pSendBuff->Compact(m_pSendBuff->ReadableBytes() * 2);
-        }
-        m_dPenultimateActiveTime = m_dActiveTime;
-        m_dActiveTime = m_pLabor->GetNowTime();
-        if (iNeedWriteLen == iHadWrittenLen && 0 == m_pWaitForSendBuff->ReadableBytes())
+        RefreshActiveTime();
+        if (uiNeedWriteLen == (size_t)iHadWrittenLen && 0 == m_pWaitForSendBuff->ReadableBytes())
         {
             return(CODEC_STATUS_OK);
         }
@@ -498,8 +703,7 @@ E_CODEC_STATUS SocketChannelImpl<T>::Send()
     {
         if (EAGAIN == m_iErrno || EINTR == m_iErrno)    // 对非阻塞socket而言，EAGAIN不是一种错误;EINTR即errno为4，错误描述Interrupted system call，操作也应该继续。
         {
-            m_dPenultimateActiveTime = m_dActiveTime;
-            m_dActiveTime = m_pLabor->GetNowTime();
+            RefreshActiveTime();
             return(CODEC_STATUS_PAUSE);
         }
         m_strErrMsg = strerror_r(m_iErrno, m_szErrBuff, sizeof(m_szErrBuff));
@@ -575,24 +779,33 @@ E_CODEC_STATUS SocketChannelImpl<T>::SendRequest(uint32 uiStepSeq, Targs&&... ar
         return(eCodecStatus);
     }
 
-    int iNeedWriteLen = m_pSendBuff->ReadableBytes();
-    if (iNeedWriteLen <= 0)
+    if (!m_pSendChain->Append(m_pSendBuff))
+    {
+        LOG4_ERROR("%s append to send queue failed!", m_strIdentify.c_str());
+        return(CODEC_STATUS_ERR);
+    }
+    size_t uiNeedWriteLen = m_pSendChain->ReadableBytes();
+    if (0 == uiNeedWriteLen)
     {
         return(eCodecStatus);
     }
+    if (m_bCork && CHANNEL_STATUS_ESTABLISHED == m_ucChannelStatus)
+    {
+        return(eCodecStatus);   // 由Dispatcher在本轮事件循环结束前统一发送
+    }
 
-    int iHadWrittenLen = 0;
-    int iWrittenLen = 0;
+    ssize_t iHadWrittenLen = 0;
+    ssize_t iWrittenLen = 0;
     do
     {
-        iWrittenLen = Write(m_pSendBuff, m_iErrno);
+        iWrittenLen = Write(m_pSendChain, m_iErrno);
         if (iWrittenLen > 0)
         {
             iHadWrittenLen += iWrittenLen;
         }
     }
-    while (iWrittenLen > 0 && iHadWrittenLen < iNeedWriteLen);
-    LOG4_TRACE("iNeedWriteLen = %d, iHadWrittenLen = %d", iNeedWriteLen, iHadWrittenLen);
+    while (iWrittenLen > 0 && (size_t)iHadWrittenLen < uiNeedWriteLen);
+    LOG4_TRACE("uiNeedWriteLen = %zu, iHadWrittenLen = %zd", uiNeedWriteLen, iHadWrittenLen);
     if (iHadWrittenLen >= 0)
     {
         if (m_bIsClient)
@@ -603,14 +816,8 @@ E_CODEC_STATUS SocketChannelImpl<T>::SendRequest(uint32 uiStepSeq, Targs&&... ar
         {
             m_pLabor->IoStatAddSendBytes(m_iFd, iHadWrittenLen, IO_STAT_DOWNSTREAM_SEND_BYTE);
         }
-        if (m_pSendBuff->Capacity() > CBuffer::BUFFER_MAX_READ
-            && (m_pSendBuff->ReadableBytes() < m_pSendBuff->Capacity() / 2))
-        {
-            m_pSendBuff->Compact(m_pSendBuff->ReadableBytes() * 2);
-        }
-        m_dPenultimateActiveTime = m_dActiveTime;
-        m_dActiveTime = m_pLabor->GetNowTime();
-        if (iNeedWriteLen == iHadWrittenLen)
+        RefreshActiveTime();
+        if (uiNeedWriteLen == (size_t)iHadWrittenLen)
         {
             return(eCodecStatus);
         }
@@ -623,8 +830,7 @@ E_CODEC_STATUS SocketChannelImpl<T>::SendRequest(uint32 uiStepSeq, Targs&&... ar
     {
         if (EAGAIN == m_iErrno || EINTR == m_iErrno)    // 对非阻塞socket而言，EAGAIN不是一种错误;EINTR即errno为4，错误描述Interrupted system call，操作也应该继续。
         {
-            m_dPenultimateActiveTime = m_dActiveTime;
-            m_dActiveTime = m_pLabor->GetNowTime();
+            RefreshActiveTime();
             return(CODEC_STATUS_PAUSE);
         }
         m_strErrMsg = strerror_r(m_iErrno, m_szErrBuff, sizeof(m_szErrBuff));
@@ -673,24 +879,35 @@ E_CODEC_STATUS SocketChannelImpl<T>::SendResponse(Targs&&... args)
         return(eCodecStatus);
     }
 
-    int iNeedWriteLen = m_pSendBuff->ReadableBytes();
-    if (iNeedWriteLen <= 0)
+    if (!m_pSendChain->Append(m_pSendBuff))
+    {
+        LOG4_ERROR("%s append to send queue failed!", m_strIdentify.c_str());
+        return(CODEC_STATUS_ERR);
+    }
+    size_t uiNeedWriteLen = m_pSendChain->ReadableBytes();
+    if (0 == uiNeedWriteLen)
     {
         return(eCodecStatus);
     }
+    if (m_bCork && CHANNEL_STATUS_ESTABLISHED == m_ucChannelStatus
+            && !(m_pCodec->GetCodecType() == CODEC_HTTP
+                && (static_cast<T*>(m_pCodec))->GetKeepAlive() == 0.0))
+    {
+        return(eCodecStatus);   // 由Dispatcher在本轮事件循环结束前统一发送
+    }
 
-    int iHadWrittenLen = 0;
-    int iWrittenLen = 0;
+    ssize_t iHadWrittenLen = 0;
+    ssize_t iWrittenLen = 0;
     do
     {
-        iWrittenLen = Write(m_pSendBuff, m_iErrno);
+        iWrittenLen = Write(m_pSendChain, m_iErrno);
         if (iWrittenLen > 0)
         {
             iHadWrittenLen += iWrittenLen;
         }
     }
-    while (iWrittenLen > 0 && iHadWrittenLen < iNeedWriteLen);
-    LOG4_TRACE("iNeedWriteLen = %d, iHadWrittenLen = %d", iNeedWriteLen, iHadWrittenLen);
+    while (iWrittenLen > 0 && (size_t)iHadWrittenLen < uiNeedWriteLen);
+    LOG4_TRACE("uiNeedWriteLen = %zu, iHadWrittenLen = %zd", uiNeedWriteLen, iHadWrittenLen);
     if (iHadWrittenLen >= 0)
     {
         if (m_bIsClient)
@@ -701,14 +918,8 @@ E_CODEC_STATUS SocketChannelImpl<T>::SendResponse(Targs&&... args)
         {
             m_pLabor->IoStatAddSendBytes(m_iFd, iHadWrittenLen, IO_STAT_DOWNSTREAM_SEND_BYTE);
         }
-        if (m_pSendBuff->Capacity() > CBuffer::BUFFER_MAX_READ
-            && (m_pSendBuff->ReadableBytes() < m_pSendBuff->Capacity() / 2))
-        {
-            m_pSendBuff->Compact(m_pSendBuff->ReadableBytes() * 2);
-        }
-        m_dPenultimateActiveTime = m_dActiveTime;
-        m_dActiveTime = m_pLabor->GetNowTime();
-        if (iNeedWriteLen == iHadWrittenLen)
+        RefreshActiveTime();
+        if (uiNeedWriteLen == (size_t)iHadWrittenLen)
         {
             if (m_pCodec->GetCodecType() == CODEC_HTTP
                     && (static_cast<T*>(m_pCodec))->GetKeepAlive() == 0.0)
@@ -730,8 +941,7 @@ E_CODEC_STATUS SocketChannelImpl<T>::SendResponse(Targs&&... args)
     {
         if (EAGAIN == m_iErrno || EINTR == m_iErrno)    // 对非阻塞socket而言，EAGAIN不是一种错误;EINTR即errno为4，错误描述Interrupted system call，操作也应该继续。
         {
-            m_dPenultimateActiveTime = m_dActiveTime;
-            m_dActiveTime = m_pLabor->GetNowTime();
+            RefreshActiveTime();
             return(CODEC_STATUS_PAUSE);
         }
         m_strErrMsg = strerror_r(m_iErrno, m_szErrBuff, sizeof(m_szErrBuff));
@@ -760,6 +970,8 @@ E_CODEC_STATUS SocketChannelImpl<T>::Recv(Targs&&... args)
     }
     int iReadLen = 0;
     int iHadReadLen = 0;
+    // SSL连接已解密的数据可能滞留在SSL层而socket不再可读，不能中途停止读取
+    uint32 uiRecvBudget = WithSsl() ? 0 : m_pLabor->GetNodeInfo().uiRecvBudget;
     do
     {
         iReadLen = Read(m_pRecvBuff, m_iErrno);
@@ -768,6 +980,11 @@ E_CODEC_STATUS SocketChannelImpl<T>::Recv(Targs&&... args)
         if (iReadLen > 0)
         {
             iHadReadLen += iReadLen;
+            AdaptRecvSize(iReadLen);
+            if (uiRecvBudget > 0 && (uint32)iHadReadLen >= uiRecvBudget)
+            {
+                break;  // 剩余数据留给下一轮事件循环，避免单个连接独占
+            }
         }
     }
     while (iReadLen > 0);
@@ -788,8 +1005,7 @@ E_CODEC_STATUS SocketChannelImpl<T>::Recv(Targs&&... args)
     {
         if (EAGAIN == m_iErrno || EINTR == m_iErrno)    // 对非阻塞socket而言，EAGAIN不是一种错误;EINTR即errno为4，错误描述Interrupted system call，操作也应该继续。
         {
-            m_dPenultimateActiveTime = m_dActiveTime;
-            m_dActiveTime = m_pLabor->GetNowTime();
+            RefreshActiveTime();
             m_eLastCodecStatus = CODEC_STATUS_PAUSE;
         }
         else
@@ -806,20 +1022,22 @@ E_CODEC_STATUS SocketChannelImpl<T>::Recv(Targs&&... args)
     if (iHadReadLen > 0)
     {
         if (m_pRecvBuff->Capacity() > CBuffer::BUFFER_MAX_READ
+            && m_pRecvBuff->Capacity() > m_uiRecvSize * 2
             && (m_pRecvBuff->ReadableBytes() < m_pRecvBuff->Capacity() / 2))
         {
             m_pRecvBuff->Compact(m_pRecvBuff->ReadableBytes() * 2);
         }
-        m_dPenultimateActiveTime = m_dActiveTime;
-        m_dActiveTime = m_pLabor->GetNowTime();
+        RefreshActiveTime();
         m_dLastRecvTime = m_dActiveTime;
+        m_ullMonotonicRecvTime = m_ullMonotonicActiveTime;
         auto uiReadIndex = m_pRecvBuff->GetReadIndex();
         E_CODEC_STATUS eCodecStatus = CODEC_STATUS_OK;
         if (m_pCodec->DecodeWithReactor())
         {
-            size_t uiSendBuffLen = m_pSendBuff->ReadableBytes();
+            // 编解码器可能直接把数据段追加到发送队列（AppendBlock），两处都要计算
+            size_t uiSendLen = m_pSendBuff->ReadableBytes() + m_pSendChain->ReadableBytes();
             eCodecStatus = (static_cast<T*>(m_pCodec))->Decode(m_pRecvBuff, std::forward<Targs>(args)..., m_pSendBuff);
-            if (m_pSendBuff->ReadableBytes() > uiSendBuffLen
+            if (m_pSendBuff->ReadableBytes() + m_pSendChain->ReadableBytes() > uiSendLen
                     && (eCodecStatus == CODEC_STATUS_OK || eCodecStatus == CODEC_STATUS_PART_OK))
             {
                 Send();
@@ -877,9 +1095,10 @@ E_CODEC_STATUS SocketChannelImpl<T>::Fetch(Targs&&... args)
     E_CODEC_STATUS eCodecStatus = CODEC_STATUS_OK;
     if (m_pCodec->DecodeWithReactor())
     {
-        size_t uiSendBuffLen = m_pSendBuff->ReadableBytes();
+        // 编解码器可能直接把数据段追加到发送队列（AppendBlock），两处都要计算
+        size_t uiSendLen = m_pSendBuff->ReadableBytes() + m_pSendChain->ReadableBytes();
         eCodecStatus = (static_cast<T*>(m_pCodec))->Decode(m_pRecvBuff, std::forward<Targs>(args)..., m_pSendBuff);
-        if (m_pSendBuff->ReadableBytes() > uiSendBuffLen
+        if (m_pSendBuff->ReadableBytes() + m_pSendChain->ReadableBytes() > uiSendLen
                 && (eCodecStatus == CODEC_STATUS_OK || eCodecStatus == CODEC_STATUS_PART_OK))
         {
             Send();
@@ -946,6 +1165,7 @@ bool SocketChannelImpl<T>::Close()
     if (CHANNEL_STATUS_CLOSED != m_ucChannelStatus)
     {
         m_pSendBuff->Compact(1);
+        m_pSendChain->Clear();
         m_pWaitForSendBuff->Compact(1);
         if (0 == close(m_iFd))
         {
@@ -988,7 +1208,27 @@ bool SocketChannelImpl<T>::SetCodec(Codec* pCodec)
     {
         delete m_pCodec;
     }
+    auto iter = m_pLabor->GetNodeInfo().mapCodecBufferSize.find(pCodec->GetCodecType());
+    if (iter != m_pLabor->GetNodeInfo().mapCodecBufferSize.end())
+    {
+        m_pRecvBuff->Reserve(iter->second);
+        m_pSendBuff->Reserve(iter->second);
+        if (iter->second > RECV_SIZE_MIN && iter->second < RECV_SIZE_MAX)
+        {
+            m_uiRecvSize = iter->second;
+        }
+    }
+    if (m_pLabor->GetNodeInfo().setCorkCodec.count(pCodec->GetCodecType()) > 0)
+    {
+        m_bCork = true;
+    }
+    if (m_pLabor->GetNodeInfo().uiZeroCopyThreshold > 0 && m_pSendChain->GetZeroCopyThreshold() == 0)
+    {
+        SetZeroCopyThreshold(m_pLabor->GetNodeInfo().uiZeroCopyThreshold);
+    }
     pCodec->ConnectionSetting(m_pSendBuff);
+    pCodec->m_pSendStage = m_pSendBuff;
+    pCodec->m_pSendChain = m_pSendChain;
     m_pCodec = pCodec;
     return(true);
 }
@@ -997,14 +1237,184 @@ template<typename T>
 int SocketChannelImpl<T>::Write(CBuffer* pBuff, int& iErrno)
 {
     LOG4_TRACE("fd[%d], channel_seq[%u]", GetFd(), GetSequence());
+    if (m_bRingSendPending)
+    {
+        iErrno = EAGAIN;
+        return(-1);
+    }
     return(pBuff->WriteFD(m_iFd, iErrno));
 }
 
+template<typename T>
+ssize_t SocketChannelImpl<T>::Write(CBufferChain* pChain, int& iErrno)
+{
+    LOG4_TRACE("fd[%d], channel_seq[%u]", GetFd(), GetSequence());
+    if (m_bRingSendPending)     // 队首数据已交给io_uring发送，完成后由Dispatcher继续
+    {
+        iErrno = EAGAIN;
+        return(-1);
+    }
+    return(pChain->WriteFD(m_iFd, iErrno));
+}
+
 template<typename T>
 int SocketChannelImpl<T>::Read(CBuffer* pBuff, int& iErrno)
 {
     LOG4_TRACE("fd[%d], channel_seq[%u]", GetFd(), GetSequence());
-    return(pBuff->ReadFD(m_iFd, iErrno));
+    if (!m_bRingIo)
+    {
+        return(pBuff->ReadFD(m_iFd, m_uiRecvSize, iErrno));
+    }
+    if (!m_bRingRecvReady)
+    {
+        iErrno = EAGAIN;
+        return(-1);
+    }
+    m_bRingRecvReady = false;
+    if (m_iRingRecvResult > 0)
+    {
+        pBuff->Write(m_pRingRecvData, m_iRingRecvResult);
+        m_pRingRecvData = nullptr;
+        return(m_iRingRecvResult);
+    }
+    else if (m_iRingRecvResult < 0)
+    {
+        iErrno = -m_iRingRecvResult;
+        return(-1);
+    }
+    return(0);
+}
+
+template<typename T>
+bool SocketChannelImpl<T>::SetRingIo(bool bRingIo)
+{
+    if (m_pSendChain == nullptr || WithSsl())
+    {
+        return(false);
+    }
+    if (bRingIo)
+    {
+        m_pSendChain->SetZeroCopyThreshold(0);
+    }
+    m_bRingIo = bRingIo;
+    m_bRingRecvReady = false;
+    return(true);
+}
+
+template<typename T>
+void SocketChannelImpl<T>::FeedRecv(const char* pData, int iResult)
+{
+    m_pRingRecvData = pData;
+    m_iRingRecvResult = iResult;
+    m_bRingRecvReady = true;
+}
+
+template<typename T>
+int SocketChannelImpl<T>::PinRingSend(struct iovec* pVec, int iMaxIov)
+{
+    if (m_pSendChain == nullptr)
+    {
+        return(0);
+    }
+    return(m_pSendChain->PinRingSend(pVec, iMaxIov));
+}
+
+template<typename T>
+void SocketChannelImpl<T>::RingSendDone(size_t uiLen)
+{
+    if (m_pSendChain == nullptr)
+    {
+        return;
+    }
+    m_pSendChain->RingSendDone(uiLen);
+    if (uiLen == 0)
+    {
+        return;
+    }
+    if (m_bIsClient)
+    {
+        m_pLabor->IoStatAddSendBytes(m_iFd, uiLen, IO_STAT_UPSTREAM_SEND_BYTE);
+    }
+    else
+    {
+        m_pLabor->IoStatAddSendBytes(m_iFd, uiLen, IO_STAT_DOWNSTREAM_SEND_BYTE);
+    }
+    RefreshActiveTime();
+}
+
+template<typename T>
+bool SocketChannelImpl<T>::SetZeroCopyThreshold(uint32 uiThreshold)
+{
+    if (m_pSendChain == nullptr || WithSsl() || m_bRingIo)
+    {
+        return(false);
+    }
+    if (uiThreshold > 0)
+    {
+        int iOn = 1;
+        if (setsockopt(m_iFd, SOL_SOCKET, SO_ZEROCOPY, &iOn, sizeof(iOn)) < 0)
+        {
+            LOG4_WARNING("fd %d setsockopt(SO_ZEROCOPY) error %d, zero copy disabled.", m_iFd, errno);
+            m_pSendChain->SetZeroCopyThreshold(0);
+            return(false);
+        }
+    }
+    m_pSendChain->SetZeroCopyThreshold(uiThreshold);
+    return(true);
+}
+
+template<typename T>
+int SocketChannelImpl<T>::ReapZeroCopy()
+{
+    if (m_pSendChain == nullptr || !m_pSendChain->ZeroCopyPending())
+    {
+        return(0);
+    }
+    int iNoticeNum = m_pSendChain->ReapZeroCopy(m_iFd);
+    LOG4_TRACE("fd %d, seq %u, %d zero copy notices, %llu copied.", m_iFd, m_uiSeq,
+            iNoticeNum, (unsigned long long)m_pSendChain->GetZeroCopyCopiedNum());
+    return(iNoticeNum);
+}
+
+template<typename T>
+bool SocketChannelImpl<T>::TakeZeroCopyPending(CBufferChain& oChain)
+{
+    if (m_pSendChain == nullptr || !m_pSendChain->ZeroCopyPending())
+    {
+        return(false);
+    }
+    m_pSendChain->ReapZeroCopy(m_iFd);
+    if (!m_pSendChain->ZeroCopyPending())
+    {
+        return(false);
+    }
+    oChain.TakeZeroCopyPending(*m_pSendChain);
+    return(true);
+}
+
+template<typename T>
+void SocketChannelImpl<T>::AdaptRecvSize(int iReadLen)
+{
+    if ((uint32)iReadLen >= m_uiRecvSize)
+    {
+        m_uiRecvShrinkNum = 0;
+        if (m_uiRecvSize < RECV_SIZE_MAX)
+        {
+            m_uiRecvSize <<= 1;
+        }
+    }
+    else if ((uint32)iReadLen < (m_uiRecvSize >> 1))
+    {
+        if (++m_uiRecvShrinkNum >= 2 && m_uiRecvSize > RECV_SIZE_MIN)
+        {
+            m_uiRecvSize >>= 1;
+            m_uiRecvShrinkNum = 0;
+        }
+    }
+    else
+    {
+        m_uiRecvShrinkNum = 0;
+    }
 }
 
 } /* namespace neb */
@@ -11,6 +11,7 @@
 #define SRC_CHANNEL_SOCKETCHANNELSSLIMPL_HPP_
 
 #ifdef WITH_OPENSSL
+#include <climits>
 #include "SslContext.hpp"
 #include "SocketChannelImpl.hpp"
 
@@ -54,6 +55,7 @@ public:
 
 protected:
     virtual int Write(CBuffer* pBuff, int& iErrno) override;
+    virtual ssize_t Write(CBufferChain* pChain, int& iErrno) override;
     virtual int Read(CBuffer* pBuff, int& iErrno) override;
 
 private: 
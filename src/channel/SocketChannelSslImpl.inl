@@ -582,13 +582,55 @@ int SocketChannelSslImpl<T>::Write(CBuffer* pBuff, int& iErrno)
     return(iWritenLen);
 }
 
+template <typename T>
+ssize_t SocketChannelSslImpl<T>::Write(CBufferChain* pChain, int& iErrno)
+{
+    LOG4_TRACE("");
+    const char* pData = nullptr;
+    size_t uiNeedWriteLen = 0;
+    if (!pChain->Peek(pData, uiNeedWriteLen))
+    {
+        return(0);
+    }
+    if (uiNeedWriteLen > (size_t)INT_MAX)   // SSL_write()长度参数为int，超大数据块分多次写出
+    {
+        uiNeedWriteLen = (size_t)INT_MAX;
+    }
+    int iWritenLen = SSL_write(m_pSslConnection, pData, (int)uiNeedWriteLen);
+    if (iWritenLen > 0)
+    {
+        pChain->Skip(iWritenLen);
+    }
+    else
+    {
+        iErrno = errno;
+        int iErrCode = SSL_get_error(m_pSslConnection, iWritenLen);
+        switch (iErrCode)
+        {
+            case SSL_ERROR_WANT_READ:
+            case SSL_ERROR_WANT_WRITE:
+                LOG4_DEBUG("The operation did not complete; the same TLS/SSL I/O function should be called again later.");
+                iErrno = EAGAIN;
+                break;
+            case SSL_ERROR_ZERO_RETURN:
+                LOG4_DEBUG("ssl channel(fd %d) closed by peer.", SocketChannelImpl<T>::GetFd());
+                break;
+            default:
+                LOG4_ERROR("SSL_write() error code %d, see SSL_get_error() manual for error code detail.", iErrCode);
+                ;
+        }
+    }
+    return(iWritenLen);
+}
+
 template <typename T>
 int SocketChannelSslImpl<T>::Read(CBuffer* pBuff, int& iErrno)
 {
     LOG4_TRACE("");
-    if (pBuff->WriteableBytes() < 1024)
+    if (!pBuff->EnsureWritableBytes(SocketChannelImpl<T>::GetRecvSize()))
     {
-        pBuff->EnsureWritableBytes(8192);
+        iErrno = ENOMEM;
+        return(-1);
     }
     int iReadLen = SSL_read(m_pSslConnection, pBuff->GetRawWriteBuffer(), pBuff->WriteableBytes());
     if (iReadLen > 0)
@@ -10,7 +10,10 @@
 #ifndef SRC_CHANNEL_SPECCHANNEL_HPP_
 #define SRC_CHANNEL_SPECCHANNEL_HPP_
 
+#include <new>
+#include <deque>
 #include <vector>
+#include <utility>
 #include <atomic>
 #include "SocketChannel.hpp"
 #include "ios/SpecChannelWatcher.hpp"
@@ -18,24 +21,113 @@
 namespace neb
 {
 
+/**
+ * @brief SpecChannel中与消息类型无关的部分（溢出队列处理与水位统计）
+ */
+class SpecChannelBase: public SocketChannel
+{
+public:
+    SpecChannelBase()
+        : m_uiPeakBacklog(0), m_uiOverflowNum(0), m_uiFullNum(0)
+    {
+    }
+    virtual ~SpecChannelBase()
+    {
+    }
+
+    /**
+     * @brief 把溢出队列中的消息按序写入环形队列（仅写入方调用）
+     * @return 溢出队列已清空返回true
+     */
+    virtual bool FlushOverflow() = 0;
+
+    /**
+     * @brief 写入方是否应暂缓写入（有消息在溢出队列中，或环形队列已用超过3/4）
+     */
+    virtual bool IsBackPressure() const = 0;
+
+    virtual uint32 GetCapacity() const = 0;
+
+    uint32 GetPeakBacklog() const
+    {
+        return(m_uiPeakBacklog.load(std::memory_order_relaxed));
+    }
+
+    uint32 GetOverflowNum() const
+    {
+        return(m_uiOverflowNum.load(std::memory_order_relaxed));
+    }
+
+    uint32 GetFullNum() const
+    {
+        return(m_uiFullNum.load(std::memory_order_relaxed));
+    }
+
+    void ResetStat()
+    {
+        m_uiPeakBacklog.store(0, std::memory_order_relaxed);
+        m_uiOverflowNum.store(0, std::memory_order_relaxed);
+        m_uiFullNum.store(0, std::memory_order_relaxed);
+    }
+
+protected:
+    void UpdatePeakBacklog(uint32 uiBacklog)
+    {
+        if (uiBacklog > m_uiPeakBacklog.load(std::memory_order_relaxed))
+        {
+            m_uiPeakBacklog.store(uiBacklog, std::memory_order_relaxed);
+        }
+    }
+
+protected:
+    std::atomic<uint32> m_uiPeakBacklog;        ///< 统计周期内最大积压消息数（环形队列+溢出队列）
+    std::atomic<uint32> m_uiOverflowNum;        ///< 统计周期内写入溢出队列的消息数
+    std::atomic<uint32> m_uiFullNum;            ///< 统计周期内因队列满被拒绝的消息数
+};
+
 template<typename Tdata, typename Thead = int>
-class SpecChannel: public SocketChannel
+class SpecChannel: public SpecChannelBase
 {
 public:
+    /**
+     * @param uiQueueSize 环形队列大小，向上取整为2的幂
+     * @param bOverflow 环形队列满时是否把消息暂存到写入方的溢出队列（不限长度），否则返回ERR_SPEC_CHANNEL_FULL
+     */
     SpecChannel(uint32 uiWriteWorker, uint32 uiReadWorker,
-            uint32 uiQueueSize, bool bWithHeader = false);
+            uint32 uiQueueSize, bool bWithHeader = false, bool bOverflow = false);
     virtual ~SpecChannel();
 
     int Write(uint32 uiFlags, uint32 uiStepSeq, Tdata&& oData);
 
     int Write(uint32 uiFlags, uint32 uiStepSeq, Thead&& oHead, Tdata&& oData);
 
+    /**
+     * @brief 批量写入，环形队列空间只确认一次，写序号只发布一次
+     * @note 环形队列放不下的消息进入溢出队列（允许溢出时），返回后vecData中只剩未写入的消息
+     * @return 写入的消息数，队列满且不允许溢出时小于传入的消息数
+     */
+    uint32 WriteBatch(uint32 uiFlags, uint32 uiStepSeq, std::vector<Tdata>& vecData);
+
+    /**
+     * @brief 带消息头的批量写入（如框架内部的SpecChannel<MsgBody, MsgHead>），语义同上
+     */
+    uint32 WriteBatch(uint32 uiFlags, uint32 uiStepSeq, std::vector<std::pair<Thead, Tdata>>& vecMsg);
+
     bool Read(uint32& uiFlags, uint32& uiStepSeq, Tdata& oData);
 
     bool Read(uint32& uiFlags, uint32& uiStepSeq, Thead& oHead, Tdata& oData);
 
     bool IsEmpty() const;
 
+    virtual bool FlushOverflow() override;
+
+    virtual bool IsBackPressure() const override;
+
+    virtual uint32 GetCapacity() const override
+    {
+        return(m_uiCapacity);
+    }
+
     void GetEnds(uint32& uiFrom, uint32& uiTo) const;
 
     virtual int GetFd() const override
@@ -101,37 +193,104 @@ protected:
     void WriteData(Tdata&& oData);
     void WriteHeadAndData(Thead&& oHead, Tdata&& oData);
 
+    /**
+     * @brief 读空后清除通知标记并再次检查队列
+     * @note 清除标记之前写入的数据在此处被发现，之后写入的数据由写入方重新通知，不会遗漏
+     * @return 队列仍非空返回true
+     */
+    bool ClearNotifiedAndRecheck(uint32 uiCurrentRead);
+
+private:
+    static const uint32 CACHE_LINE_SIZE = 64;
+
+    struct tagSlot
+    {
+        uint32 uiFlags;
+        uint32 uiStepSeq;
+        Tdata oData;
+        Thead oHead;
+
+        tagSlot(uint32 uiSlotFlags, uint32 uiSlotStepSeq, Thead&& oSlotHead, Tdata&& oSlotData)
+            : uiFlags(uiSlotFlags), uiStepSeq(uiSlotStepSeq),
+              oData(std::forward<Tdata>(oSlotData)), oHead(std::forward<Thead>(oSlotHead))
+        {
+        }
+    };
+
+    int WriteSlot(uint32 uiFlags, uint32 uiStepSeq, Thead&& oHead, Tdata&& oData);
+    template<typename Tmsg>
+    uint32 WriteBatchMsg(uint32 uiFlags, uint32 uiStepSeq, std::vector<Tmsg>& vecMsg);
+    static Thead TakeHead(Tdata& oData)
+    {
+        return(Thead());
+    }
+    static Tdata&& TakeData(Tdata& oData)
+    {
+        return(std::move(oData));
+    }
+    static Thead&& TakeHead(std::pair<Thead, Tdata>& stMsg)
+    {
+        return(std::move(stMsg.first));
+    }
+    static Tdata&& TakeData(std::pair<Thead, Tdata>& stMsg)
+    {
+        return(std::move(stMsg.second));
+    }
+    tagSlot* ReadSlot();
+    void PopSlot(tagSlot* pSlot);
+
 private:
     bool m_bWithHeader;
+    bool m_bOverflow;
     uint32 m_uiWriteLaborIndex;
     uint32 m_uiReadLaborIndex;
-    uint32 m_uiSize;
-    uint32 m_uiEffectiveSize;
-    uint32 m_uiPeerStepSeq;
-    std::atomic<uint32> m_uiWriteIndex;
-    std::atomic<uint32> m_uiReadIndex;
+    uint32 m_uiCapacity;                        ///< 2的幂
+    uint32 m_uiMask;
+    tagSlot* m_pSlot;                           ///< 预分配的槽，写入时原地构造，读出后析构
     std::string m_strIdentify;
     std::string m_strRemoteAddr;
-    std::vector<uint32> m_vecFlags;
-    std::vector<std::pair<uint32, Tdata>> m_vecData;
-    std::vector<Thead> m_vecHead;
     SpecChannelWatcher* m_pWatcher;
+    std::deque<tagSlot> m_dequeOverflow;        ///< 写入方的溢出队列，仅写入方访问
+
+    // 写入方和读取方各占独立的缓存行，并缓存对方的位置，仅在缓存值显示满/空时才读取对方的原子变量
+    char m_szWriterPadding[CACHE_LINE_SIZE];
+    std::atomic<uint32> m_uiWriteIndex;         ///< 自由递增，取模由m_uiMask完成
+    uint32 m_uiReadIndexCache;                  ///< 写入方缓存的m_uiReadIndex
+    char m_szReaderPadding[CACHE_LINE_SIZE - 2 * sizeof(uint32)];
+    std::atomic<uint32> m_uiReadIndex;
+    uint32 m_uiWriteIndexCache;                 ///< 读取方缓存的m_uiWriteIndex
+    uint32 m_uiPeerStepSeq;
+    char m_szTailPadding[CACHE_LINE_SIZE - 3 * sizeof(uint32)];
 };
 
 template<typename Tdata, typename Thead>
 SpecChannel<Tdata, Thead>::SpecChannel(
-        uint32 uiWriteWorker, uint32 uiReadWorker, uint32 uiQueueSize, bool bWithHeader)
-    : m_bWithHeader(bWithHeader),
+        uint32 uiWriteWorker, uint32 uiReadWorker, uint32 uiQueueSize, bool bWithHeader, bool bOverflow)
+    : m_bWithHeader(bWithHeader), m_bOverflow(bOverflow),
       m_uiWriteLaborIndex(uiWriteWorker), m_uiReadLaborIndex(uiReadWorker),
-      m_uiSize(uiQueueSize), m_uiEffectiveSize(0), m_uiPeerStepSeq(0),
-      m_uiWriteIndex(0), m_uiReadIndex(0),
-      m_pWatcher(nullptr)
+      m_uiCapacity(2), m_uiMask(1), m_pSlot(nullptr),
+      m_pWatcher(nullptr),
+      m_uiWriteIndex(0), m_uiReadIndexCache(0),
+      m_uiReadIndex(0), m_uiWriteIndexCache(0), m_uiPeerStepSeq(0)
 {
+    while (m_uiCapacity < uiQueueSize && m_uiCapacity < 0x80000000)
+    {
+        m_uiCapacity <<= 1;
+    }
+    m_uiMask = m_uiCapacity - 1;
+    m_pSlot = static_cast<tagSlot*>(::operator new(sizeof(tagSlot) * m_uiCapacity));
 }
 
 template<typename Tdata, typename Thead>
 SpecChannel<Tdata, Thead>::~SpecChannel()
 {
+    tagSlot* pSlot = nullptr;
+    while ((pSlot = ReadSlot()) != nullptr)
+    {
+        PopSlot(pSlot);
+    }
+    ::operator delete(m_pSlot);
+    m_pSlot = nullptr;
     if (nullptr != m_pWatcher)
     {
         delete m_pWatcher;
@@ -142,104 +301,238 @@ SpecChannel<Tdata, Thead>::~SpecChannel()
 template<typename Tdata, typename Thead>
 int SpecChannel<Tdata, Thead>::Write(uint32 uiFlags, uint32 uiStepSeq, Tdata&& oData)
 {
-    auto const uiCurrentWrite = m_uiWriteIndex.load(std::memory_order_relaxed);
-    auto uiNextRecord = uiCurrentWrite + 1;
-    uiNextRecord = (uiNextRecord == m_uiSize) ? 0 : uiNextRecord;
-    if (m_uiEffectiveSize < m_uiSize)
-    {
-        m_vecFlags.push_back(uiFlags);
-        m_vecData.emplace_back(std::move(std::make_pair(uiStepSeq, std::forward<Tdata>(oData))));
-        m_uiWriteIndex.store(uiNextRecord, std::memory_order_release);
-        ++m_uiEffectiveSize;
-        return(ERR_OK);
-    }
-    else
+    return(WriteSlot(uiFlags, uiStepSeq, Thead(), std::forward<Tdata>(oData)));
+}
+
+template<typename Tdata, typename Thead>
+int SpecChannel<Tdata, Thead>::Write(uint32 uiFlags, uint32 uiStepSeq, Thead&& oHead, Tdata&& oData)
+{
+    return(WriteSlot(uiFlags, uiStepSeq, std::forward<Thead>(oHead), std::forward<Tdata>(oData)));
+}
+
+template<typename Tdata, typename Thead>
+uint32 SpecChannel<Tdata, Thead>::WriteBatch(uint32 uiFlags, uint32 uiStepSeq, std::vector<Tdata>& vecData)
+{
+    return(WriteBatchMsg(uiFlags, uiStepSeq, vecData));
+}
+
+template<typename Tdata, typename Thead>
+uint32 SpecChannel<Tdata, Thead>::WriteBatch(uint32 uiFlags, uint32 uiStepSeq, std::vector<std::pair<Thead, Tdata>>& vecMsg)
+{
+    return(WriteBatchMsg(uiFlags, uiStepSeq, vecMsg));
+}
+
+template<typename Tdata, typename Thead>
+template<typename Tmsg>
+uint32 SpecChannel<Tdata, Thead>::WriteBatchMsg(uint32 uiFlags, uint32 uiStepSeq, std::vector<Tmsg>& vecData)
+{
+    uint32 uiWritten = 0;
+    uint32 uiNum = vecData.size();
+    if (m_dequeOverflow.empty() || FlushOverflow())
     {
-        if (uiNextRecord == m_uiReadIndex.load(std::memory_order_acquire))  // queue is full
+        auto const uiCurrentWrite = m_uiWriteIndex.load(std::memory_order_relaxed);
+        uint32 uiFree = m_uiCapacity - (uiCurrentWrite - m_uiReadIndexCache);
+        if (uiFree < uiNum)
         {
-            return(ERR_SPEC_CHANNEL_FULL);
+            m_uiReadIndexCache = m_uiReadIndex.load(std::memory_order_acquire);
+            uiFree = m_uiCapacity - (uiCurrentWrite - m_uiReadIndexCache);
         }
-        else
+        for (; uiWritten < uiNum && uiWritten < uiFree; ++uiWritten)
         {
-            m_vecFlags[uiCurrentWrite] = uiFlags;
-            m_vecData[uiCurrentWrite].first = uiStepSeq;
-            m_vecData[uiCurrentWrite].second = std::forward<Tdata>(oData);
-            m_uiWriteIndex.store(uiNextRecord, std::memory_order_release);
-            return(ERR_OK);
+            new (&m_pSlot[(uiCurrentWrite + uiWritten) & m_uiMask]) tagSlot(uiFlags, uiStepSeq,
+                    TakeHead(vecData[uiWritten]), TakeData(vecData[uiWritten]));
+        }
+        if (uiWritten > 0)
+        {
+            m_uiWriteIndex.store(uiCurrentWrite + uiWritten, std::memory_order_release);
+            if (uiCurrentWrite + uiWritten - m_uiReadIndexCache > m_uiPeakBacklog.load(std::memory_order_relaxed))
+            {
+                m_uiReadIndexCache = m_uiReadIndex.load(std::memory_order_acquire);
+                UpdatePeakBacklog(uiCurrentWrite + uiWritten - m_uiReadIndexCache);
+            }
         }
     }
+    if (uiWritten == uiNum)
+    {
+        vecData.clear();
+        return(uiWritten);
+    }
+    if (!m_bOverflow)
+    {
+        m_uiFullNum.fetch_add(uiNum - uiWritten, std::memory_order_relaxed);
+        vecData.erase(vecData.begin(), vecData.begin() + uiWritten);
+        return(uiWritten);
+    }
+    for (uint32 i = uiWritten; i < uiNum; ++i)
+    {
+        m_dequeOverflow.emplace_back(uiFlags, uiStepSeq, TakeHead(vecData[i]), TakeData(vecData[i]));
+    }
+    if (nullptr != m_pWatcher)
+    {
+        m_pWatcher->SetOverflow(true);
+    }
+    m_uiOverflowNum.fetch_add(uiNum - uiWritten, std::memory_order_relaxed);
+    UpdatePeakBacklog(m_uiCapacity + m_dequeOverflow.size());
+    vecData.clear();
+    return(uiNum);
 }
 
 template<typename Tdata, typename Thead>
-int SpecChannel<Tdata, Thead>::Write(uint32 uiFlags, uint32 uiStepSeq, Thead&& oHead, Tdata&& oData)
+bool SpecChannel<Tdata, Thead>::Read(uint32& uiFlags, uint32& uiStepSeq, Tdata& oData)
 {
-    auto const uiCurrentWrite = m_uiWriteIndex.load(std::memory_order_relaxed);
-    auto uiNextRecord = uiCurrentWrite + 1;
-    uiNextRecord = (uiNextRecord == m_uiSize) ? 0 : uiNextRecord;
-    if (m_uiEffectiveSize < m_uiSize)
-    {
-        m_vecFlags.push_back(uiFlags);
-        m_vecData.emplace_back(std::move(std::make_pair(uiStepSeq, std::forward<Tdata>(oData))));
-        m_vecHead.emplace_back(std::forward<Thead>(oHead));
-        m_uiWriteIndex.store(uiNextRecord, std::memory_order_release);
-        ++m_uiEffectiveSize;
+    tagSlot* pSlot = ReadSlot();
+    if (pSlot == nullptr)
+    {
+        return(false);
+    }
+    uiFlags = pSlot->uiFlags;
+    uiStepSeq = pSlot->uiStepSeq;
+    oData = std::move(pSlot->oData);
+    m_uiPeerStepSeq = uiStepSeq;
+    PopSlot(pSlot);
+    return(true);
+}
+
+template<typename Tdata, typename Thead>
+bool SpecChannel<Tdata, Thead>::Read(uint32& uiFlags, uint32& uiStepSeq, Thead& oHead, Tdata& oData)
+{
+    tagSlot* pSlot = ReadSlot();
+    if (pSlot == nullptr)
+    {
+        return(false);
+    }
+    uiFlags = pSlot->uiFlags;
+    uiStepSeq = pSlot->uiStepSeq;
+    oData = std::move(pSlot->oData);
+    oHead = std::move(pSlot->oHead);
+    m_uiPeerStepSeq = uiStepSeq;
+    PopSlot(pSlot);
+    return(true);
+}
+
+template<typename Tdata, typename Thead>
+int SpecChannel<Tdata, Thead>::WriteSlot(uint32 uiFlags, uint32 uiStepSeq, Thead&& oHead, Tdata&& oData)
+{
+    if (!m_dequeOverflow.empty() && !FlushOverflow())  // 保持顺序，溢出队列未清空时新消息也进入溢出队列
+    {
+        m_dequeOverflow.emplace_back(uiFlags, uiStepSeq, std::forward<Thead>(oHead), std::forward<Tdata>(oData));
+        m_uiOverflowNum.fetch_add(1, std::memory_order_relaxed);
+        UpdatePeakBacklog(m_uiCapacity + m_dequeOverflow.size());
         return(ERR_OK);
     }
-    else
+    auto const uiCurrentWrite = m_uiWriteIndex.load(std::memory_order_relaxed);
+    if (uiCurrentWrite - m_uiReadIndexCache >= m_uiCapacity)
     {
-        if (uiNextRecord == m_uiReadIndex.load(std::memory_order_acquire))  // queue is full
-        {
-            return(ERR_SPEC_CHANNEL_FULL);
-        }
-        else
+        m_uiReadIndexCache = m_uiReadIndex.load(std::memory_order_acquire);
+        if (uiCurrentWrite - m_uiReadIndexCache >= m_uiCapacity)  // queue is full
         {
-            m_vecFlags[uiCurrentWrite] = uiFlags;
-            m_vecData[uiCurrentWrite].first = uiStepSeq;
-            m_vecData[uiCurrentWrite].second = std::forward<Tdata>(oData);
-            m_vecHead[uiCurrentWrite] = std::forward<Thead>(oHead);
-            m_uiWriteIndex.store(uiNextRecord, std::memory_order_release);
+            if (!m_bOverflow)
+            {
+                m_uiFullNum.fetch_add(1, std::memory_order_relaxed);
+                return(ERR_SPEC_CHANNEL_FULL);
+            }
+            m_dequeOverflow.emplace_back(uiFlags, uiStepSeq, std::forward<Thead>(oHead), std::forward<Tdata>(oData));
+            if (nullptr != m_pWatcher)
+            {
+                m_pWatcher->SetOverflow(true);   // 由写入方Dispatcher在环形队列有空间时写入
+            }
+            m_uiOverflowNum.fetch_add(1, std::memory_order_relaxed);
+            UpdatePeakBacklog(m_uiCapacity + m_dequeOverflow.size());
             return(ERR_OK);
         }
     }
+    new (&m_pSlot[uiCurrentWrite & m_uiMask]) tagSlot(uiFlags, uiStepSeq,
+            std::forward<Thead>(oHead), std::forward<Tdata>(oData));
+    m_uiWriteIndex.store(uiCurrentWrite + 1, std::memory_order_release);
+    // 缓存的读序号可能已落后很多，据此算出的积压数只是上限，超过当前峰值时才重新读取读序号
+    if (uiCurrentWrite + 1 - m_uiReadIndexCache > m_uiPeakBacklog.load(std::memory_order_relaxed))
+    {
+        m_uiReadIndexCache = m_uiReadIndex.load(std::memory_order_acquire);
+        UpdatePeakBacklog(uiCurrentWrite + 1 - m_uiReadIndexCache);
+    }
+    return(ERR_OK);
 }
 
 template<typename Tdata, typename Thead>
-bool SpecChannel<Tdata, Thead>::Read(uint32& uiFlags, uint32& uiStepSeq, Tdata& oData)
+bool SpecChannel<Tdata, Thead>::FlushOverflow()
 {
-    auto const uiCurrentRead = m_uiReadIndex.load(std::memory_order_relaxed);
-    if (uiCurrentRead == m_uiWriteIndex.load(std::memory_order_acquire)) // queue is empty
+    // 按当前空闲空间成批移入环形队列，写序号只发布一次
+    auto const uiCurrentWrite = m_uiWriteIndex.load(std::memory_order_relaxed);
+    uint32 uiFree = m_uiCapacity - (uiCurrentWrite - m_uiReadIndexCache);
+    if (uiFree < m_dequeOverflow.size())
+    {
+        m_uiReadIndexCache = m_uiReadIndex.load(std::memory_order_acquire);
+        uiFree = m_uiCapacity - (uiCurrentWrite - m_uiReadIndexCache);
+    }
+    uint32 uiWritten = 0;
+    for (; uiWritten < uiFree && !m_dequeOverflow.empty(); ++uiWritten)
+    {
+        tagSlot& stFront = m_dequeOverflow.front();
+        new (&m_pSlot[(uiCurrentWrite + uiWritten) & m_uiMask]) tagSlot(stFront.uiFlags, stFront.uiStepSeq,
+                std::move(stFront.oHead), std::move(stFront.oData));
+        m_dequeOverflow.pop_front();
+    }
+    if (uiWritten > 0)
+    {
+        m_uiWriteIndex.store(uiCurrentWrite + uiWritten, std::memory_order_release);
+    }
+    if (!m_dequeOverflow.empty())
     {
         return(false);
     }
-
-    auto uiNextRecord = uiCurrentRead + 1;
-    uiNextRecord = (uiNextRecord == m_uiSize) ? 0 : uiNextRecord;
-    uiFlags = m_vecFlags[uiCurrentRead];
-    uiStepSeq = m_vecData[uiCurrentRead].first;
-    oData = std::move(m_vecData[uiCurrentRead].second);
-    m_uiPeerStepSeq = uiStepSeq;
-    m_uiReadIndex.store(uiNextRecord, std::memory_order_release);
+    if (nullptr != m_pWatcher)
+    {
+        m_pWatcher->SetOverflow(false);
+    }
     return(true);
 }
 
 template<typename Tdata, typename Thead>
-bool SpecChannel<Tdata, Thead>::Read(uint32& uiFlags, uint32& uiStepSeq, Thead& oHead, Tdata& oData)
+bool SpecChannel<Tdata, Thead>::IsBackPressure() const
+{
+    if (!m_dequeOverflow.empty())
+    {
+        return(true);
+    }
+    uint32 uiBacklog = m_uiWriteIndex.load(std::memory_order_relaxed) - m_uiReadIndex.load(std::memory_order_acquire);
+    return(uiBacklog >= m_uiCapacity - (m_uiCapacity >> 2));
+}
+
+template<typename Tdata, typename Thead>
+typename SpecChannel<Tdata, Thead>::tagSlot* SpecChannel<Tdata, Thead>::ReadSlot()
 {
     auto const uiCurrentRead = m_uiReadIndex.load(std::memory_order_relaxed);
-    if (uiCurrentRead == m_uiWriteIndex.load(std::memory_order_acquire)) // queue is empty
+    if (uiCurrentRead == m_uiWriteIndexCache)
     {
-        return(false);
+        m_uiWriteIndexCache = m_uiWriteIndex.load(std::memory_order_acquire);
+        if (uiCurrentRead == m_uiWriteIndexCache)   // queue is empty
+        {
+            if (!ClearNotifiedAndRecheck(uiCurrentRead))
+            {
+                return(nullptr);
+            }
+        }
     }
+    return(&m_pSlot[uiCurrentRead & m_uiMask]);
+}
 
-    auto uiNextRecord = uiCurrentRead + 1;
-    uiNextRecord = (uiNextRecord == m_uiSize) ? 0 : uiNextRecord;
-    uiFlags = m_vecFlags[uiCurrentRead];
-    uiStepSeq = m_vecData[uiCurrentRead].first;
-    oData = std::move(m_vecData[uiCurrentRead].second);
-    oHead = std::move(m_vecHead[uiCurrentRead]);
-    m_uiPeerStepSeq = uiStepSeq;
-    m_uiReadIndex.store(uiNextRecord, std::memory_order_release);
-    return(true);
+template<typename Tdata, typename Thead>
+void SpecChannel<Tdata, Thead>::PopSlot(tagSlot* pSlot)
+{
+    pSlot->~tagSlot();
+    m_uiReadIndex.store(m_uiReadIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template<typename Tdata, typename Thead>
+bool SpecChannel<Tdata, Thead>::ClearNotifiedAndRecheck(uint32 uiCurrentRead)
+{
+    if (nullptr == m_pWatcher)
+    {
+        return(false);
+    }
+    m_pWatcher->ClearNotified();
+    m_uiWriteIndexCache = m_uiWriteIndex.load(std::memory_order_acquire);
+    return(uiCurrentRead != m_uiWriteIndexCache);
 }
 
 template<typename Tdata, typename Thead>
@@ -25,6 +25,7 @@ bool SocketChannelMigrate::MigrateChannel(std::shared_ptr<SocketChannel> pSocket
     auto pNewChannel = std::make_shared<SocketChannel>();
     pNewChannel->m_bIsClient = pSocketChannel->m_bIsClient;
     pNewChannel->m_bWithSsl = pSocketChannel->m_bWithSsl;
+    pNewChannel->m_bAutoMigrate = pSocketChannel->m_bAutoMigrate;
     pNewChannel->m_pImpl = pSocketChannel->m_pImpl;
     pSocketChannel->m_pImpl = nullptr;
     pNewChannel->m_pWatcher = pSocketChannel->m_pWatcher;
@@ -62,7 +62,8 @@ int SocketChannelMigrate::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiF
     if (pChannel == nullptr)
     {
         pSpecChannel = std::make_shared<SpecChannel<SocketChannelPack>>(
-                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(), true);
+                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(Type(), uiFromLabor, uiToLabor),
+                true, pLaborShared->IsSpecChannelOverflow());
         if (pSpecChannel == nullptr)
         {
             pSocketChannel.reset(oPack.UnpackChannel().get()); // recover from migration failed
@@ -93,7 +94,7 @@ int SocketChannelMigrate::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiF
         int iResult = pSpecChannel->Write(uiFlags, uiStepSeq, std::move(oPack));
         if (iResult == ERR_OK)
         {
-            pLaborShared->GetDispatcher(uiToLabor)->AsyncSend(pSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+            pLaborShared->GetDispatcher(uiFromLabor)->AsyncSend(pLaborShared->GetDispatcher(uiToLabor), pSpecChannel->MutableWatcher());
         }
         else
         {
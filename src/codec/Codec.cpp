@@ -8,6 +8,7 @@
  * Modify history:
  ******************************************************************************/
 #include "Codec.hpp"
+#include "channel/SocketChannel.hpp"
 
 #include "util/encrypt/hconv.h"
 #include "util/encrypt/rc5.h"
@@ -16,7 +17,8 @@ namespace neb
 {
 
 Codec::Codec(std::shared_ptr<NetLogger> pLogger, E_CODEC_TYPE eCodecType, std::shared_ptr<SocketChannel> pBindChannel)
-    : m_pLogger(pLogger), m_iErrno(0), m_eCodecType(eCodecType), m_pBindChannel(pBindChannel)
+    : m_pLogger(pLogger), m_iErrno(0), m_eCodecType(eCodecType), m_pBindChannel(pBindChannel),
+      m_pSendStage(nullptr), m_pSendChain(nullptr)
 {
 }
 
@@ -239,5 +241,35 @@ bool Codec::AesDecrypt(const std::string& strSrc, std::string& strDest)
     return(CodecUtil::AesDecrypt(GetKey(), strSrc, strDest));
 }
 
+bool Codec::AppendBlock(CBuffer* pBuff, std::string&& strBlock)
+{
+    if (m_pSendChain == nullptr || pBuff == nullptr || pBuff != m_pSendStage)
+    {
+        return(false);
+    }
+    if (!m_pSendChain->Append(pBuff))
+    {
+        return(false);
+    }
+    return(m_pSendChain->Append(std::move(strBlock)));
+}
+
+bool Codec::AppendFile(CBuffer* pBuff, int iFileFd, uint64 ullOffset, uint64 ullLength)
+{
+    if (m_pSendChain == nullptr || pBuff == nullptr || pBuff != m_pSendStage)
+    {
+        return(false);
+    }
+    if (m_pBindChannel == nullptr || m_pBindChannel->WithSsl())
+    {
+        return(false);
+    }
+    if (!m_pSendChain->Append(pBuff))
+    {
+        return(false);
+    }
+    return(m_pSendChain->AppendFile(iFileFd, ullOffset, ullLength));
+}
+
 } /* namespace neb */
 
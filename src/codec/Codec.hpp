@@ -17,6 +17,7 @@
 #include <vector>
 #include <actor/cmd/CW.hpp>
 #include "util/CBuffer.hpp"
+#include "util/CBufferChain.hpp"
 #include "pb/msg.pb.h"
 #include "Error.hpp"
 #include "Definition.hpp"
@@ -153,6 +154,20 @@ protected:
     bool AesEncrypt(const std::string& strSrc, std::string& strDest);
     bool AesDecrypt(const std::string& strSrc, std::string& strDest);
 
+    /**
+     * @brief 把外部数据块（如已序列化的消息体）直接接到连接发送队列尾部，不拷贝
+     * @note 仅当pBuff是连接的编码缓冲区时可用，pBuff中已编码的数据先入队；
+     *       返回false时strBlock未被移动，调用方应自行把数据写入pBuff。
+     */
+    bool AppendBlock(CBuffer* pBuff, std::string&& strBlock);
+
+    /**
+     * @brief 把文件区间接到连接发送队列尾部，轮到时以sendfile()发送
+     * @note 使用条件同AppendBlock()，且连接不是SSL连接；返回false时调用方应自行
+     *       读取文件内容写入pBuff。
+     */
+    bool AppendFile(CBuffer* pBuff, int iFileFd, uint64 ullOffset, uint64 ullLength);
+
 private:
     void UnbindChannel()
     {
@@ -166,6 +181,8 @@ private:
     E_CODEC_TYPE m_eCodecType;
     std::shared_ptr<SocketChannel> m_pBindChannel;
     std::string m_strKey;       // 密钥
+    CBuffer* m_pSendStage;                      ///< 所绑定连接的编码缓冲区
+    CBufferChain* m_pSendChain;                 ///< 所绑定连接的分段发送队列
     static std::vector<E_CODEC_TYPE> m_vecAutoSwitchCodecType;   // 自动转换有效的编解码类型
 
     friend class SocketChannel;
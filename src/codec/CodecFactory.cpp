@@ -483,6 +483,13 @@ bool CodecFactory::OnSelfResponse(Dispatcher* pDispatcher, std::shared_ptr<SelfC
     return(IO<HttpStep>::OnResponse(pDispatcher, pSocketChannel, pChannel->GetStepSeq(), oHttpMsg));
 }
 
+bool CodecFactory::OnSelfResponse(Dispatcher* pDispatcher, std::shared_ptr<SelfChannel> pChannel, const HttpMsg& oHttpMsg, const HttpFile& stFile)
+{
+    HttpMsg oFileMsg(oHttpMsg);
+    CodecHttp::LoadFile(stFile, oFileMsg);
+    return(OnSelfResponse(pDispatcher, pChannel, oFileMsg));
+}
+
 bool CodecFactory::OnSelfRequest(Dispatcher* pDispatcher, uint32 uiStepSeq, std::shared_ptr<SelfChannel> pChannel, const RedisMsg& oRedisMsg)
 {
     pChannel->SetStepSeq(uiStepSeq);
@@ -524,12 +531,19 @@ E_CODEC_STATUS CodecFactory::OnNebulaEvent(Dispatcher* pDispatcher, std::shared_
 {
     E_CODEC_STATUS eCodecStatus = CODEC_STATUS_OK;
     int i = iStart;
+    uint32 uiMsgBudget = pDispatcher->m_pLabor->GetNodeInfo().uiMsgBudget;
     for (; ; ++i)
     {
         if (pChannel->IsMigrated())
         {
             break;
         }
+        if (uiMsgBudget > 0 && (uint32)(i - iStart) >= uiMsgBudget)
+        {
+            pDispatcher->DeferChannel(pChannel);
+            eCodecStatus = CODEC_STATUS_PAUSE;
+            break;
+        }
         MsgHead oMsgHead;
         MsgBody oMsgBody;
         if (0 == i)
@@ -579,12 +593,19 @@ E_CODEC_STATUS CodecFactory::OnHttpEvent(Dispatcher* pDispatcher, std::shared_pt
 {
     E_CODEC_STATUS eCodecStatus = CODEC_STATUS_OK;
     int i = iStart;
+    uint32 uiMsgBudget = pDispatcher->m_pLabor->GetNodeInfo().uiMsgBudget;
     for (; ; ++i)
     {
         if (pChannel->IsMigrated())
         {
             break;
         }
+        if (uiMsgBudget > 0 && (uint32)(i - iStart) >= uiMsgBudget)
+        {
+            pDispatcher->DeferChannel(pChannel);
+            eCodecStatus = CODEC_STATUS_PAUSE;
+            break;
+        }
         HttpMsg oHttpMsg;
         if (0 == i)
         {
@@ -672,12 +693,19 @@ E_CODEC_STATUS CodecFactory::OnRedisEvent(Dispatcher* pDispatcher, std::shared_p
 {
     E_CODEC_STATUS eCodecStatus = CODEC_STATUS_OK;
     int i = iStart;
+    uint32 uiMsgBudget = pDispatcher->m_pLabor->GetNodeInfo().uiMsgBudget;
     for (; ; ++i)
     {
         if (pChannel->IsMigrated())
         {
             break;
         }
+        if (uiMsgBudget > 0 && (uint32)(i - iStart) >= uiMsgBudget)
+        {
+            pDispatcher->DeferChannel(pChannel);
+            eCodecStatus = CODEC_STATUS_PAUSE;
+            break;
+        }
         RedisMsg oRedisMsg;
         if (0 == i)
         {
@@ -711,12 +739,19 @@ E_CODEC_STATUS CodecFactory::OnCassEvent(Dispatcher* pDispatcher, std::shared_pt
 {
     E_CODEC_STATUS eCodecStatus = CODEC_STATUS_OK;
     int i = iStart;
+    uint32 uiMsgBudget = pDispatcher->m_pLabor->GetNodeInfo().uiMsgBudget;
     for (; ; ++i)
     {
         if (pChannel->IsMigrated())
         {
             break;
         }
+        if (uiMsgBudget > 0 && (uint32)(i - iStart) >= uiMsgBudget)
+        {
+            pDispatcher->DeferChannel(pChannel);
+            eCodecStatus = CODEC_STATUS_PAUSE;
+            break;
+        }
         CassResponse oCassResponse;
         if (0 == i)
         {
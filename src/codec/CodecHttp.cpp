@@ -8,7 +8,12 @@
  * Modify history:
  ******************************************************************************/
 #include <algorithm>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "util/StringCoder.hpp"
+#include "util/CFileCache.hpp"
 #include "logger/NetLogger.hpp"
 #include "channel/SocketChannel.hpp"
 #include "CodecHttp.hpp"
@@ -76,14 +81,118 @@ static const char * status_string(int code)
     return 0;
 }
 
+static const char* s_szHttpDateFormat = "%a, %d %b %Y %H:%M:%S GMT";
+
+static std::string http_date(time_t lTime)
+{
+    char szDate[64] = {0};
+    struct tm stTm;
+    gmtime_r(&lTime, &stTm);
+    strftime(szDate, sizeof(szDate), s_szHttpDateFormat, &stTm);
+    return(szDate);
+}
+
+static bool parse_http_date(const std::string& strDate, time_t& lTime)
+{
+    struct tm stTm;
+    memset(&stTm, 0, sizeof(stTm));
+    if (strptime(strDate.c_str(), s_szHttpDateFormat, &stTm) == nullptr)
+    {
+        return(false);
+    }
+    lTime = timegm(&stTm);
+    return(true);
+}
+
+static bool parse_range_number(const std::string& strNumber, uint64_t& ullNumber)
+{
+    if (strNumber.empty() || strNumber.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return(false);
+    }
+    ullNumber = strtoull(strNumber.c_str(), nullptr, 10);
+    return(true);
+}
+
+/**
+ * @brief 解析单区间的Range请求头（多区间请求按无Range处理，返回完整内容）
+ * @return 1 有效区间[ullStart, ullEnd]，0 忽略Range，-1 区间不可满足
+ */
+static int parse_range(const std::string& strRange, uint64_t ullSize, uint64_t& ullStart, uint64_t& ullEnd)
+{
+    if (strRange.compare(0, 6, "bytes=") != 0 || strRange.find(',') != std::string::npos)
+    {
+        return(0);
+    }
+    std::string strSpec = strRange.substr(6);
+    strSpec.erase(0, strSpec.find_first_not_of(' '));
+    strSpec.erase(strSpec.find_last_not_of(' ') + 1);
+    size_t uiPos = strSpec.find('-');
+    if (uiPos == std::string::npos)
+    {
+        return(0);
+    }
+    std::string strFirst = strSpec.substr(0, uiPos);
+    std::string strLast = strSpec.substr(uiPos + 1);
+    uint64_t ullLast = 0;
+    if (strFirst.empty())   // bytes=-n 最后n个字节
+    {
+        if (!parse_range_number(strLast, ullLast))
+        {
+            return(0);
+        }
+        if (ullLast == 0 || ullSize == 0)
+        {
+            return(-1);
+        }
+        ullStart = (ullSize > ullLast) ? ullSize - ullLast : 0;
+        ullEnd = ullSize - 1;
+        return(1);
+    }
+    if (!parse_range_number(strFirst, ullStart))
+    {
+        return(0);
+    }
+    if (strLast.empty())
+    {
+        ullLast = ullSize - 1;
+    }
+    else if (!parse_range_number(strLast, ullLast) || ullLast < ullStart)
+    {
+        return(0);
+    }
+    if (ullStart >= ullSize)
+    {
+        return(-1);
+    }
+    ullEnd = (ullLast < ullSize - 1) ? ullLast : ullSize - 1;
+    return(1);
+}
+
 namespace neb
 {
 
+HttpFile::HttpFile(const HttpMsg& oRequest, const std::string& strFilePath)
+    : strPath(strFilePath), bHeadOnly(oRequest.method() == HTTP_HEAD)
+{
+    for (auto iter = oRequest.headers().begin(); iter != oRequest.headers().end(); ++iter)
+    {
+        if (strcasecmp(iter->first.c_str(), "Range") == 0)
+        {
+            strRange = iter->second;
+        }
+        else if (strcasecmp(iter->first.c_str(), "If-Modified-Since") == 0)
+        {
+            strIfModifiedSince = iter->second;
+        }
+    }
+}
+
 CodecHttp::CodecHttp(std::shared_ptr<NetLogger> pLogger, E_CODEC_TYPE eCodecType,
         std::shared_ptr<SocketChannel> pBindChannel, ev_tstamp dKeepAlive)
     : Codec(pLogger, eCodecType, pBindChannel),
       m_bIsDecoding(false), 
-      m_iHttpMajor(1), m_iHttpMinor(1), m_dKeepAlive(dKeepAlive)
+      m_iHttpMajor(1), m_iHttpMinor(1), m_dKeepAlive(dKeepAlive), m_ullFileLength(0)
 {
 }
 
@@ -104,7 +213,8 @@ int CodecHttp::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, uint3
     if (pChannel == nullptr)
     {
         pSpecChannel = std::make_shared<SpecChannel<HttpMsg>>(
-                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(), true);
+                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(Type(), uiFromLabor, uiToLabor),
+                true, pLaborShared->IsSpecChannelOverflow());
         if (pSpecChannel == nullptr)
         {
             return(ERR_SPEC_CHANNEL_CREATE);
@@ -129,7 +239,7 @@ int CodecHttp::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, uint3
         int iResult = pSpecChannel->Write(uiFlags, uiStepSeq, std::move(const_cast<HttpMsg&>(oHttpMsg)));
         if (iResult == ERR_OK)
         {
-            pLaborShared->GetDispatcher(uiToLabor)->AsyncSend(pSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+            pLaborShared->GetDispatcher(uiFromLabor)->AsyncSend(pLaborShared->GetDispatcher(uiToLabor), pSpecChannel->MutableWatcher());
         }
         return(iResult);
     }
@@ -144,6 +254,13 @@ int CodecHttp::Write(std::shared_ptr<SocketChannel> pChannel, uint32 uiFlags, ui
     return(Write(uiTo, uiFrom, uiFlags, uiStepSeq, oHttpMsg));
 }
 
+int CodecHttp::Write(std::shared_ptr<SocketChannel> pChannel, uint32 uiFlags, uint32 uiStepSeq, const HttpMsg& oHttpMsg, const HttpFile& stFile)
+{
+    HttpMsg oFileMsg(oHttpMsg);
+    LoadFile(stFile, oFileMsg);
+    return(Write(pChannel, uiFlags, uiStepSeq, oFileMsg));
+}
+
 E_CODEC_STATUS CodecHttp::Encode(CBuffer* pBuff, CBuffer* pSecondlyBuff)
 {
     return(CODEC_STATUS_OK);
@@ -520,7 +637,7 @@ E_CODEC_STATUS CodecHttp::Encode(const HttpMsg& oHttpMsg, CBuffer* pBuff)
         }
         else
         {
-            iWriteSize = pBuff->Printf("Content-Length: 0\r\n\r\n");
+            iWriteSize = pBuff->Printf("Content-Length: %llu\r\n\r\n", m_ullFileLength);
             if (iWriteSize < 0)
             {
                 pBuff->SetWriteIndex(pBuff->GetWriteIndex() - iHadEncodedSize);
@@ -548,6 +665,190 @@ E_CODEC_STATUS CodecHttp::Encode(const HttpMsg& oHttpMsg, CBuffer* pBuff, CBuffe
     return(Encode(oHttpMsg, pBuff));
 }
 
+E_CODEC_STATUS CodecHttp::Encode(const HttpMsg& oHttpMsg, const HttpFile& stFile, CBuffer* pBuff)
+{
+    if (HTTP_RESPONSE != oHttpMsg.type())
+    {
+        LOG4_WARNING("file can only be sent as a http response!");
+        m_mapAddingHttpHeader.clear();
+        return(CODEC_STATUS_ERR);
+    }
+    HttpMsg oFileMsg(oHttpMsg);
+    uint64 ullOffset = 0;
+    uint64 ullLength = 0;
+    int iFileFd = PrepareFile(stFile, oFileMsg, ullOffset, ullLength);
+    m_ullFileLength = ullLength;
+    E_CODEC_STATUS eStatus = Encode(oFileMsg, pBuff);
+    m_ullFileLength = 0;
+    if (CODEC_STATUS_OK != eStatus || iFileFd < 0 || ullLength == 0 || stFile.bHeadOnly)
+    {
+        return(eStatus);
+    }
+    if (AppendFile(pBuff, iFileFd, ullOffset, ullLength))
+    {
+        return(CODEC_STATUS_OK);
+    }
+    // SSL连接等不能sendfile()的情况，读取文件内容写入发送缓冲区
+    if (!ReadFile(iFileFd, ullOffset, ullLength, pBuff))
+    {
+        LOG4_ERROR("read file \"%s\" error %d!", stFile.strPath.c_str(), errno);
+        return(CODEC_STATUS_ERR);
+    }
+    return(CODEC_STATUS_OK);
+}
+
+E_CODEC_STATUS CodecHttp::Encode(const HttpMsg& oHttpMsg, const HttpFile& stFile, CBuffer* pBuff, CBuffer* pSecondlyBuff)
+{
+    return(Encode(oHttpMsg, stFile, pBuff));
+}
+
+bool CodecHttp::LoadFile(const HttpFile& stFile, HttpMsg& oHttpMsg)
+{
+    uint64 ullOffset = 0;
+    uint64 ullLength = 0;
+    int iFileFd = PrepareFile(stFile, oHttpMsg, ullOffset, ullLength);
+    if (iFileFd < 0 || ullLength == 0 || stFile.bHeadOnly)
+    {
+        return(true);
+    }
+    CBuffer oBuff;
+    if (!ReadFile(iFileFd, ullOffset, ullLength, &oBuff))
+    {
+        oHttpMsg.set_status_code(500);
+        return(false);
+    }
+    oHttpMsg.set_body(oBuff.GetRawReadBuffer(), oBuff.ReadableBytes());
+    return(true);
+}
+
+int CodecHttp::PrepareFile(const HttpFile& stFile, HttpMsg& oHttpMsg, uint64& ullOffset, uint64& ullLength)
+{
+    ullOffset = 0;
+    ullLength = 0;
+    oHttpMsg.clear_body();
+    oHttpMsg.mutable_headers()->erase("Transfer-Encoding");
+    int iFileFd = stFile.iFd;
+    uint64 ullFileSize = 0;
+    time_t lMtime = 0;
+    if (iFileFd >= 0)
+    {
+        struct stat stStat;
+        if (::fstat(iFileFd, &stStat) != 0)
+        {
+            oHttpMsg.set_status_code(500);
+            return(-1);
+        }
+        ullFileSize = stStat.st_size;
+        lMtime = stStat.st_mtime;
+    }
+    else
+    {
+        CFileCache::tagFile stOpenFile;
+        if (!CFileCache::Instance().Open(stFile.strPath, stOpenFile))
+        {
+            switch (errno)
+            {
+                case ENOENT:
+                case ENOTDIR:
+                    oHttpMsg.set_status_code(404);
+                    break;
+                case EACCES:
+                case EISDIR:
+                    oHttpMsg.set_status_code(403);
+                    break;
+                default:
+                    oHttpMsg.set_status_code(500);
+            }
+            return(-1);
+        }
+        iFileFd = stOpenFile.iFd;
+        ullFileSize = stOpenFile.uiSize;
+        lMtime = stOpenFile.lMtime;
+    }
+
+    uint64 ullBase = (stFile.ullOffset < ullFileSize) ? stFile.ullOffset : ullFileSize;
+    uint64 ullEntitySize = ullFileSize - ullBase;
+    if (stFile.ullLength > 0 && stFile.ullLength < ullEntitySize)
+    {
+        ullEntitySize = stFile.ullLength;
+    }
+    if (oHttpMsg.status_code() != 0 && oHttpMsg.status_code() != 200)
+    {
+        ullOffset = ullBase;
+        ullLength = ullEntitySize;
+        return(iFileFd);
+    }
+    oHttpMsg.set_status_code(200);
+    auto pHeaders = oHttpMsg.mutable_headers();
+    if (pHeaders->find("Last-Modified") == pHeaders->end())
+    {
+        (*pHeaders)["Last-Modified"] = http_date(lMtime);
+    }
+    (*pHeaders)["Accept-Ranges"] = "bytes";
+
+    time_t lIfModifiedSince = 0;
+    if (stFile.strIfModifiedSince.size() > 0
+            && parse_http_date(stFile.strIfModifiedSince, lIfModifiedSince)
+            && lMtime <= lIfModifiedSince)
+    {
+        oHttpMsg.set_status_code(304);
+        return(-1);
+    }
+    uint64_t ullStart = 0;
+    uint64_t ullEnd = 0;
+    char szContentRange[64] = {0};
+    switch (parse_range(stFile.strRange, ullEntitySize, ullStart, ullEnd))
+    {
+        case 1:
+            oHttpMsg.set_status_code(206);
+            snprintf(szContentRange, sizeof(szContentRange), "bytes %llu-%llu/%llu",
+                    (unsigned long long)ullStart, (unsigned long long)ullEnd, (unsigned long long)ullEntitySize);
+            (*pHeaders)["Content-Range"] = szContentRange;
+            ullOffset = ullBase + ullStart;
+            ullLength = ullEnd - ullStart + 1;
+            return(iFileFd);
+        case -1:
+            oHttpMsg.set_status_code(416);
+            snprintf(szContentRange, sizeof(szContentRange), "bytes */%llu", (unsigned long long)ullEntitySize);
+            (*pHeaders)["Content-Range"] = szContentRange;
+            return(-1);
+        default:
+            ullOffset = ullBase;
+            ullLength = ullEntitySize;
+            return(iFileFd);
+    }
+}
+
+bool CodecHttp::ReadFile(int iFd, uint64 ullOffset, uint64 ullLength, CBuffer* pBuff)
+{
+    if (!pBuff->EnsureWritableBytes(ullLength))
+    {
+        errno = ENOMEM;
+        return(false);
+    }
+    uint64 ullReadLen = 0;
+    while (ullReadLen < ullLength)
+    {
+        ssize_t n = ::pread(iFd, pBuff->GetRawWriteBuffer() + ullReadLen,
+                ullLength - ullReadLen, ullOffset + ullReadLen);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            if (n == 0)
+            {
+                errno = EIO;    // 文件已被截短
+            }
+            return(false);
+        }
+        ullReadLen += n;
+    }
+    pBuff->AdvanceWriteIndex(ullReadLen);
+    return(true);
+}
+
 E_CODEC_STATUS CodecHttp::Decode(CBuffer* pBuff, HttpMsg& oHttpMsg)
 {
     LOG4_TRACE(" ");
@@ -19,6 +19,27 @@
 namespace neb
 {
 
+/**
+ * @brief 文件响应
+ * @note 与HttpMsg一起传给IO<CodecHttp>::SendResponse()：响应头由编解码器生成，
+ *       文件内容不经过HttpMsg.body()和发送缓冲区，由sendfile()在socket可写时发送。
+ *       响应状态码为0或200时按If-Modified-Since和Range请求头生成304、206或416响应。
+ */
+struct HttpFile
+{
+    std::string strPath;                ///< 文件路径，经打开文件缓存打开，与iFd二选一
+    int iFd = -1;                       ///< 调用方已打开的文件，由调用方负责关闭
+    uint64 ullOffset = 0;               ///< 作为响应实体的文件区间起始位置，Range请求相对该区间
+    uint64 ullLength = 0;               ///< 作为响应实体的文件区间长度，0表示到文件尾
+    bool bHeadOnly = false;             ///< HEAD请求，只发送响应头
+    std::string strRange;               ///< 请求的Range头
+    std::string strIfModifiedSince;     ///< 请求的If-Modified-Since头
+
+    HttpFile() = default;
+    /** @brief 从请求中取出Range、If-Modified-Since头和请求方法 */
+    HttpFile(const HttpMsg& oRequest, const std::string& strFilePath);
+};
+
 class CodecHttp: public Codec
 {
 public:
@@ -36,10 +57,13 @@ public:
 
     // response
     static int Write(std::shared_ptr<SocketChannel> pChannel, uint32 uiFlags, uint32 uiStepSeq, const HttpMsg& oHttpMsg);
+    static int Write(std::shared_ptr<SocketChannel> pChannel, uint32 uiFlags, uint32 uiStepSeq, const HttpMsg& oHttpMsg, const HttpFile& stFile);
 
     E_CODEC_STATUS Encode(CBuffer* pBuff, CBuffer* pSecondlyBuff = nullptr);
     E_CODEC_STATUS Encode(const HttpMsg& oHttpMsg, CBuffer* pBuff);
     E_CODEC_STATUS Encode(const HttpMsg& oHttpMsg, CBuffer* pBuff, CBuffer* pSecondlyBuff);
+    E_CODEC_STATUS Encode(const HttpMsg& oHttpMsg, const HttpFile& stFile, CBuffer* pBuff);
+    E_CODEC_STATUS Encode(const HttpMsg& oHttpMsg, const HttpFile& stFile, CBuffer* pBuff, CBuffer* pSecondlyBuff);
     E_CODEC_STATUS Decode(CBuffer* pBuff, HttpMsg& oHttpMsg);
     E_CODEC_STATUS Decode(CBuffer* pBuff, HttpMsg& oHttpMsg, CBuffer* pReactBuff);
 
@@ -59,6 +83,11 @@ public:
 
     bool CloseRightAway() const;
 
+    /**
+     * @brief 读取文件响应的内容到oHttpMsg.body()，用于不能sendfile()的通道（如线程间通道）
+     */
+    static bool LoadFile(const HttpFile& stFile, HttpMsg& oHttpMsg);
+
 protected:
     static int OnMessageBegin(http_parser *parser);
     static int OnUrl(http_parser *parser, const char *at, size_t len);
@@ -76,6 +105,13 @@ protected:
         return(&m_oParsingHttpMsg);
     }
 
+    /**
+     * @brief 打开文件并根据条件请求头确定响应状态码、响应头和需要发送的文件区间
+     * @return 需要发送文件内容时返回文件描述符（归打开文件缓存或调用方所有），否则返回-1
+     */
+    static int PrepareFile(const HttpFile& stFile, HttpMsg& oHttpMsg, uint64& ullOffset, uint64& ullLength);
+    static bool ReadFile(int iFd, uint64 ullOffset, uint64 ullLength, CBuffer* pBuff);
+
 private:
     bool m_bIsDecoding;         // 是否編解碼完成
     int32 m_iHttpMajor;
@@ -86,6 +122,7 @@ private:
     HttpMsg m_oParsingHttpMsg;      // TODO 如果是较大的http包只解了一部分，要记录断点位置，收到信的数据再从断点位置开始解
     std::string m_strHttpString;
     std::unordered_map<std::string, std::string> m_mapAddingHttpHeader;       ///< encode前添加的http头，encode之后要清空
+    uint64 m_ullFileLength;         ///< 文件响应的Content-Length（文件内容不在body中），encode之后要清零
 };
 
 } /* namespace neb */
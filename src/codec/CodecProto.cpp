@@ -38,7 +38,8 @@ int CodecProto::Write(uint32 uiCodecType, uint32 uiFromLabor, uint32 uiToLabor,
     if (pChannel == nullptr)
     {
         pSpecChannel = std::make_shared<SpecChannel<MsgBody, MsgHead>>(
-                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(), true);
+                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(uiCodecType, uiFromLabor, uiToLabor),
+                true, pLaborShared->IsSpecChannelOverflow());
         if (pSpecChannel == nullptr)
         {
             return(ERR_SPEC_CHANNEL_CREATE);
@@ -63,7 +64,7 @@ int CodecProto::Write(uint32 uiCodecType, uint32 uiFromLabor, uint32 uiToLabor,
         int iResult = pSpecChannel->Write(uiFlags, uiStepSeq, std::forward<MsgHead>(oMsgHead), std::forward<MsgBody>(oMsgBody));
         if (iResult == ERR_OK)
         {
-            pLaborShared->GetDispatcher(uiToLabor)->AsyncSend(pSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+            pLaborShared->GetDispatcher(uiFromLabor)->AsyncSend(pLaborShared->GetDispatcher(uiToLabor), pSpecChannel->MutableWatcher());
         }
         return(iResult);
     }
@@ -111,6 +112,10 @@ E_CODEC_STATUS CodecProto::Encode(int32 iCmd, uint32 uiSeq, const MsgBody& oMsgB
         return(ChannelSticky(oMsgHead, oMsgBody));
     }
     oMsgBody.SerializeToString(&strTmpData);
+    if ((uint32)iMsgBodyLen > CBufferChain::COALESCE_SIZE && AppendBlock(pBuff, std::move(strTmpData)))
+    {
+        return(ChannelSticky(oMsgHead, oMsgBody));
+    }
     iWriteLen = pBuff->Write(strTmpData.c_str(), iMsgBodyLen);
     iHadWriteLen += iWriteLen;
     if (iWriteLen == iMsgBodyLen)
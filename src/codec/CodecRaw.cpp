@@ -38,7 +38,8 @@ int CodecRaw::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, uint32
     if (pChannel == nullptr)
     {
         pSpecChannel = std::make_shared<SpecChannel<Bytes>>(
-                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(), true);
+                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(Type(), uiFromLabor, uiToLabor),
+                true, pLaborShared->IsSpecChannelOverflow());
         if (pSpecChannel == nullptr)
         {
             return(ERR_SPEC_CHANNEL_CREATE);
@@ -67,7 +68,7 @@ int CodecRaw::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, uint32
         int iResult = pSpecChannel->Write(uiFlags, uiStepSeq, std::move(oBytes));
         if (iResult == ERR_OK)
         {
-            pLaborShared->GetDispatcher(uiToLabor)->AsyncSend(pSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+            pLaborShared->GetDispatcher(uiFromLabor)->AsyncSend(pLaborShared->GetDispatcher(uiToLabor), pSpecChannel->MutableWatcher());
         }
         return(iResult);
     }
@@ -42,7 +42,8 @@ int CodecResp::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, uint3
     if (pChannel == nullptr)
     {
         pSpecChannel = std::make_shared<SpecChannel<RedisReply>>(
-                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(), true);
+                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(Type(), uiFromLabor, uiToLabor),
+                true, pLaborShared->IsSpecChannelOverflow());
         if (pSpecChannel == nullptr)
         {
             return(ERR_SPEC_CHANNEL_CREATE);
@@ -67,7 +68,7 @@ int CodecResp::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, uint3
         int iResult = pSpecChannel->Write(uiFlags, uiStepSeq, std::move(const_cast<RedisReply&>(oReply)));
         if (iResult == ERR_OK)
         {
-            pLaborShared->GetDispatcher(uiToLabor)->AsyncSend(pSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+            pLaborShared->GetDispatcher(uiFromLabor)->AsyncSend(pLaborShared->GetDispatcher(uiToLabor), pSpecChannel->MutableWatcher());
         }
         return(iResult);
     }
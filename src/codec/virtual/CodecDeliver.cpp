@@ -33,7 +33,8 @@ int CodecDeliver::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, ui
     if (pChannel == nullptr)
     {
         pSpecChannel = std::make_shared<SpecChannel<Package>>(
-                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(), true);
+                uiFromLabor, uiToLabor, pLaborShared->GetSpecChannelQueueSize(Type(), uiFromLabor, uiToLabor),
+                true, pLaborShared->IsSpecChannelOverflow());
         if (pSpecChannel == nullptr)
         {
             return(ERR_SPEC_CHANNEL_CREATE);
@@ -58,7 +59,7 @@ int CodecDeliver::Write(uint32 uiFromLabor, uint32 uiToLabor, uint32 uiFlags, ui
         int iResult = pSpecChannel->Write(uiFlags, uiStepSeq, std::forward<Package>(oPackage));
         if (iResult == ERR_OK)
         {
-            pLaborShared->GetDispatcher(uiToLabor)->AsyncSend(pSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+            pLaborShared->GetDispatcher(uiFromLabor)->AsyncSend(pLaborShared->GetDispatcher(uiToLabor), pSpecChannel->MutableWatcher());
         }
         return(iResult);
     }
@@ -13,13 +13,15 @@ namespace neb
 {
 
 ActorWatcher::ActorWatcher()
-    : m_pTimerWatcher(nullptr), m_pActor(nullptr)
+    : m_pActor(nullptr)
 {
+    m_stTimer.pData = this;
 }
 
 ActorWatcher::ActorWatcher(std::shared_ptr<Actor> pActor)
-    : m_pTimerWatcher(nullptr), m_pActor(pActor)
+    : m_pActor(pActor)
 {
+    m_stTimer.pData = this;
 }
 
 ActorWatcher::~ActorWatcher()
@@ -27,20 +29,6 @@ ActorWatcher::~ActorWatcher()
     Reset();
 }
 
-ev_timer* ActorWatcher::MutableTimerWatcher()
-{
-    if (nullptr == m_pTimerWatcher)
-    {
-        m_pTimerWatcher = new ev_timer();
-        if (nullptr != m_pTimerWatcher)
-        {
-            memset(m_pTimerWatcher, 0, sizeof(ev_timer));
-            m_pTimerWatcher->data = this;
-        }
-    }
-    return(m_pTimerWatcher);
-}
-
 void ActorWatcher::Set(std::shared_ptr<Actor> pActor)
 {
     if (m_pActor == nullptr)
@@ -52,11 +40,7 @@ void ActorWatcher::Set(std::shared_ptr<Actor> pActor)
 void ActorWatcher::Reset()
 {
     m_pActor = nullptr;
-    if (nullptr != m_pTimerWatcher)
-    {
-        delete m_pTimerWatcher;
-        m_pTimerWatcher = nullptr;
-    }
+    m_stTimer.Cancel();
 }
 
 } /* namespace neb */
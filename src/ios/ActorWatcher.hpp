@@ -11,15 +11,7 @@
 #define SRC_IOS_ACTORWATCHER_HPP_
 
 #include <memory>
-
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wstrict-aliasing"
-#endif
-#include "ev.h"
-#ifdef __GNUC__
-#pragma GCC diagnostic pop
-#endif
+#include "util/CTimingWheel.hpp"
 
 namespace neb
 {
@@ -33,7 +25,10 @@ public:
     ActorWatcher(std::shared_ptr<Actor> pActor);
     virtual ~ActorWatcher();
 
-    ev_timer* MutableTimerWatcher();
+    CTimingWheel::tagTimer* MutableTimer()
+    {
+        return(&m_stTimer);
+    }
 
     inline std::shared_ptr<Actor> GetActor() const
     {
@@ -44,7 +39,7 @@ public:
     void Reset();
 
 private:
-    ev_timer* m_pTimerWatcher;
+    CTimingWheel::tagTimer m_stTimer;       ///< 挂在Dispatcher时间轮上的超时定时器
     std::shared_ptr<Actor> m_pActor;
 };
 
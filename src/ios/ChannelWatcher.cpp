@@ -14,15 +14,15 @@ namespace neb
 {
 
 ChannelWatcher::ChannelWatcher()
-    : m_pTimerWatcher(nullptr), m_pIoWatcher(nullptr),
-      m_pSocketChannel(nullptr)
+    : m_pIoWatcher(nullptr), m_pSocketChannel(nullptr)
 {
+    m_stTimer.pData = this;
 }
 
 ChannelWatcher::ChannelWatcher(std::shared_ptr<SocketChannel> pChannel)
-    : m_pTimerWatcher(nullptr), m_pIoWatcher(nullptr),
-      m_pSocketChannel(pChannel)
+    : m_pIoWatcher(nullptr), m_pSocketChannel(pChannel)
 {
+    m_stTimer.pData = this;
 }
 
 ChannelWatcher::~ChannelWatcher()
@@ -49,20 +49,6 @@ ev_io* ChannelWatcher::MutableIoWatcher()
     return(m_pIoWatcher);
 }
 
-ev_timer* ChannelWatcher::MutableTimerWatcher()
-{
-    if (nullptr == m_pTimerWatcher)
-    {
-        m_pTimerWatcher = new ev_timer();
-        if (nullptr != m_pTimerWatcher)
-        {
-            memset(m_pTimerWatcher, 0, sizeof(ev_timer));
-            m_pTimerWatcher->data = this;
-        }
-    }
-    return(m_pTimerWatcher);
-}
-
 void ChannelWatcher::Set(std::shared_ptr<SocketChannel> pChannel)
 {
     if (m_pSocketChannel == nullptr)
@@ -74,11 +60,7 @@ void ChannelWatcher::Set(std::shared_ptr<SocketChannel> pChannel)
 void ChannelWatcher::Reset()
 {
     m_pSocketChannel = nullptr;
-    if (nullptr != m_pTimerWatcher)
-    {
-        delete m_pTimerWatcher;
-        m_pTimerWatcher = nullptr;
-    }
+    m_stTimer.Cancel();
     if (nullptr != m_pIoWatcher)
     {
         delete m_pIoWatcher;
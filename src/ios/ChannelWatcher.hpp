@@ -20,6 +20,7 @@
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
+#include "util/CTimingWheel.hpp"
 
 namespace neb
 {
@@ -34,7 +35,10 @@ public:
     virtual ~ChannelWatcher();
 
     ev_io* MutableIoWatcher();
-    ev_timer* MutableTimerWatcher();
+    CTimingWheel::tagTimer* MutableTimer()
+    {
+        return(&m_stTimer);
+    }
 
     inline std::shared_ptr<SocketChannel> GetSocketChannel() const
     {
@@ -45,7 +49,7 @@ public:
     void Reset();
 
 private:
-    ev_timer* m_pTimerWatcher;
+    CTimingWheel::tagTimer m_stTimer;       ///< 挂在Dispatcher空闲连接时间轮上的IO超时定时器
     ev_io* m_pIoWatcher;
     std::shared_ptr<SocketChannel> m_pSocketChannel;
 };
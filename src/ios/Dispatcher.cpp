@@ -10,6 +10,9 @@
 
 #include "Dispatcher.hpp"
 #include <algorithm>
+#include <cmath>
+#include <sys/resource.h>
+#include <linux/filter.h>
 #include "Definition.hpp"
 #include "labor/Manager.hpp"
 #include "labor/Worker.hpp"
@@ -22,18 +25,24 @@
 #include "codec/CodecFactory.hpp"
 #include "channel/SocketChannelImpl.hpp"
 #include "channel/migrate/SocketChannelMigrate.hpp"
+#include "util/CBufferPool.hpp"
+#include "util/CComputePool.hpp"
 #include "pb/neb_sys.pb.h"
 
 namespace neb
 {
 
+const uint32 Dispatcher::LOOP_LAG_BUCKET[Dispatcher::LOOP_LAG_BUCKET_NUM] = {1, 5, 10, 50, 100, 500, UINT32_MAX};
+
 Dispatcher::Dispatcher(Labor* pLabor, std::shared_ptr<NetLogger> pLogger)
-   : m_pErrBuff(NULL), m_pLabor(pLabor), m_loop(NULL), m_lLastCheckNodeTime(0),
-     m_pLogger(pLogger), m_pSessionNode(nullptr)
+   : m_pErrBuff(NULL), m_pLabor(pLabor), m_loop(NULL), m_lLastCheckNodeTime(0), m_dUnitTimeStart(0.0), m_uiBufferReclaimNum(0), m_uiMsgBudgetHitNum(0),
+     m_pLogger(pLogger), m_pSessionNode(nullptr), m_uiChannelNum(0), m_pCorkWatcher(nullptr), m_pAsyncNotifyWatcher(nullptr),
+     m_pSpecChannelOverflowWatcher(nullptr), m_pZeroCopyLingerWatcher(nullptr), m_pDeferWatcher(nullptr),
+     m_pTimingWheelWatcher(nullptr), m_ullTimingWheelArmedTick(UINT64_MAX), m_pIoTimeoutSweepWatcher(nullptr),
+     m_pLoopCheckWatcher(nullptr), m_pLoopPrepareWatcher(nullptr), m_pRingWatcher(nullptr), m_pRingPrepareWatcher(nullptr),
+     m_ullRingRequestId(0), m_bRingAccept(false), m_bRingRecv(false), m_uiBusyPollSpin(0), m_bLoopBreak(false)
 {
     m_pErrBuff = (char*)malloc(gc_iErrBuffLen);
-
-    m_loop = ev_loop_new(EVFLAG_FORKCHECK | EVFLAG_SIGNALFD);
 }
 
 Dispatcher::~Dispatcher()
@@ -45,9 +54,11 @@ void Dispatcher::IoCallback(struct ev_loop* loop, struct ev_io* watcher, int rev
 {
     if (watcher->data != NULL)
     {
+        uint64 ullStartTime = GetCoarseMicroTime();
         auto pWatcher = static_cast<ChannelWatcher*>(watcher->data);
         auto pChannel = pWatcher->GetSocketChannel();
         Dispatcher* pDispatcher = pChannel->m_pImpl->GetLabor()->GetDispatcher();
+        pChannel->ReapZeroCopy();   // 零拷贝完成通知在socket错误队列中，不读取会持续触发事件
         if (revents & EV_READ)
         {
             pDispatcher->OnIoRead(pChannel);
@@ -60,14 +71,15 @@ void Dispatcher::IoCallback(struct ev_loop* loop, struct ev_io* watcher, int rev
         {
             pDispatcher->OnIoError(pChannel);
         }
+        pDispatcher->LoopCallbackDone("IoCallback", ullStartTime, pChannel.get());
     }
 }
 
-void Dispatcher::IoTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+void Dispatcher::IoTimeoutCallback(void* pData)
 {
-    if (watcher->data != NULL)
+    if (pData != NULL)
     {
-        auto pWatcher = static_cast<ChannelWatcher*>(watcher->data);
+        auto pWatcher = static_cast<ChannelWatcher*>(pData);
         auto pChannel = pWatcher->GetSocketChannel();
         Dispatcher* pDispatcher = pChannel->m_pImpl->GetLabor()->GetDispatcher();
         if (pChannel->GetFd() < 3)      // TODO 查找fd为0回调到这里的原因
@@ -78,6 +90,19 @@ void Dispatcher::IoTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int
     }
 }
 
+void Dispatcher::IoTimeoutSweepCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        Dispatcher* pDispatcher = (Dispatcher*)watcher->data;
+        pDispatcher->m_oIoTimeoutWheel.Expire(GetMonotonicMicroTime() / 1000000);
+        if (pDispatcher->m_oIoTimeoutWheel.Size() == 0)
+        {
+            ev_timer_stop(loop, watcher);
+        }
+    }
+}
+
 void Dispatcher::PeriodicTaskCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
 {
     if (watcher->data != NULL)
@@ -108,18 +133,87 @@ void Dispatcher::AsyncCallback(struct ev_loop* loop, struct ev_async* watcher, i
 {
     if (watcher->data != NULL)
     {
+        uint64 ullStartTime = GetCoarseMicroTime();
         auto pWatcher = static_cast<SpecChannelWatcher*>(watcher->data);
         auto pChannel = pWatcher->GetSocketChannel();
         CodecFactory::OnEvent(pWatcher, pChannel);
+        Dispatcher* pDispatcher = (Dispatcher*)ev_userdata(loop);
+        if (pDispatcher != nullptr)
+        {
+            pDispatcher->LoopCallbackDone("AsyncCallback", ullStartTime, pChannel.get());
+        }
+    }
+}
+
+void Dispatcher::CorkCallback(struct ev_loop* loop, ev_prepare* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        Dispatcher* pDispatcher = (Dispatcher*)(watcher->data);
+        pDispatcher->FlushCorkChannel();
+    }
+}
+
+void Dispatcher::AsyncNotifyCallback(struct ev_loop* loop, ev_prepare* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        Dispatcher* pDispatcher = (Dispatcher*)(watcher->data);
+        pDispatcher->FlushAsyncNotify();
+    }
+}
+
+void Dispatcher::SpecChannelOverflowCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        Dispatcher* pDispatcher = (Dispatcher*)(watcher->data);
+        pDispatcher->FlushSpecChannelOverflow();
+    }
+}
+
+void Dispatcher::ZeroCopyLingerCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        Dispatcher* pDispatcher = (Dispatcher*)(watcher->data);
+        pDispatcher->ReapZeroCopyLinger();
+    }
+}
+
+void Dispatcher::ComputeDoneCallback(struct ev_loop* loop, struct ev_async* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        uint64 ullStartTime = GetCoarseMicroTime();
+        Dispatcher* pDispatcher = (Dispatcher*)(watcher->data);
+        pDispatcher->OnComputeDone();
+        pDispatcher->LoopCallbackDone("ComputeDoneCallback", ullStartTime, (Actor*)nullptr);
+    }
+}
+
+void Dispatcher::RingCallback(struct ev_loop* loop, struct ev_io* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        ((Dispatcher*)watcher->data)->ReapRing();
+    }
+}
+
+void Dispatcher::RingPrepareCallback(struct ev_loop* loop, ev_prepare* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        ((Dispatcher*)watcher->data)->SubmitRing();
     }
 }
 
-void Dispatcher::ClientConnFrequencyTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+void Dispatcher::DeferCallback(struct ev_loop* loop, ev_idle* watcher, int revents)
 {
     if (watcher->data != NULL)
     {
-        tagClientConnWatcherData* pData = (tagClientConnWatcherData*)watcher->data;
-        pData->pDispatcher->OnClientConnFrequencyTimeout(pData, watcher);
+        Dispatcher* pDispatcher = (Dispatcher*)(watcher->data);
+        pDispatcher->HandleDeferredChannel();
     }
 }
 
@@ -150,6 +244,16 @@ bool Dispatcher::OnIoRead(std::shared_ptr<SocketChannel> pChannel)
             return(DataRecvAndHandle(pChannel));
         }
     }
+    else if (Labor::LABOR_WORKER == m_pLabor->GetLaborType())
+    {
+        auto& mapAccessFd = ((Worker*)m_pLabor)->GetWorkerInfo().mapAccessFdFamily;
+        auto iter = mapAccessFd.find(pChannel->GetFd());
+        if (iter != mapAccessFd.end())
+        {
+            return(AcceptClientConn(iter->first, iter->second));
+        }
+        return(DataRecvAndHandle(pChannel));
+    }
     else
     {
         return(DataRecvAndHandle(pChannel));
@@ -279,10 +383,12 @@ bool Dispatcher::OnIoWrite(std::shared_ptr<SocketChannel> pChannel)
     if (CODEC_STATUS_OK == eCodecStatus)
     {
         RemoveIoWriteEvent(pChannel);
+        CheckSendWatermark(pChannel);
     }
     else if (CODEC_STATUS_PAUSE == eCodecStatus || CODEC_STATUS_WANT_WRITE == eCodecStatus)
     {
         AddIoWriteEvent(pChannel);
+        CheckSendWatermark(pChannel);
     }
     else if (CODEC_STATUS_WANT_READ == eCodecStatus)
     {
@@ -304,13 +410,32 @@ bool Dispatcher::OnIoError(std::shared_ptr<SocketChannel> pChannel)
 
 bool Dispatcher::OnIoTimeout(std::shared_ptr<SocketChannel> pChannel)
 {
-    ev_tstamp after = pChannel->GetLastRecvTime() - ev_now(m_loop) + pChannel->GetKeepAlive();
+    // 用单调时间计算空闲时长，系统时间被调整时不会提前或推迟超时
+    uint64 ullNow = GetMonotonicMicroTime();
+    uint64 ullRecvTime = pChannel->GetMonotonicRecvTime();
+    ev_tstamp after = pChannel->GetKeepAlive()
+            - ((ullNow > ullRecvTime) ? (ev_tstamp)(ullNow - ullRecvTime) / 1000000 : 0.0);
     if (after > 0)    // IO在定时时间内被重新刷新过，重新设置定时器
     {
-        ev_timer_stop (m_loop, pChannel->MutableWatcher()->MutableTimerWatcher());
-        ev_timer_set (pChannel->MutableWatcher()->MutableTimerWatcher(), after + ev_time() - ev_now(m_loop), 0);
-        ev_timer_start (m_loop, pChannel->MutableWatcher()->MutableTimerWatcher());
-        return(true);
+        ev_tstamp dReclaimIdle = m_pLabor->GetNodeInfo().dBufferReclaimIdle;
+        if (dReclaimIdle > 0.0)    // 空闲连接释放收发缓冲区，并让定时器在下次可能空闲到期时再检查
+        {
+            uint64 ullActiveTime = pChannel->GetMonotonicActiveTime();
+            ev_tstamp dIdle = (ullNow > ullActiveTime) ? (ev_tstamp)(ullNow - ullActiveTime) / 1000000 : 0.0;
+            if (dIdle >= dReclaimIdle)
+            {
+                if (pChannel->GetBufferBytes() > 0 && pChannel->ReleaseBuffer())
+                {
+                    ++m_uiBufferReclaimNum;
+                }
+                after = (dReclaimIdle < after) ? dReclaimIdle : after;
+            }
+            else
+            {
+                after = (dReclaimIdle - dIdle < after) ? (dReclaimIdle - dIdle) : after;
+            }
+        }
+        return(AddIoTimeout(pChannel, after));
     }
 
     LOG4_TRACE("fd %d, seq %u, last recv time %f, now time %f, keep alive %f",
@@ -332,32 +457,62 @@ bool Dispatcher::OnIoTimeout(std::shared_ptr<SocketChannel> pChannel)
     return(true);
 }
 
-bool Dispatcher::OnClientConnFrequencyTimeout(tagClientConnWatcherData* pData, ev_timer* watcher)
+void Dispatcher::EventRun()
 {
-    bool bRes = false;
-    auto iter = m_mapClientConnFrequency.find(std::string(pData->pAddr));
-    if (iter == m_mapClientConnFrequency.end())
+    uint32 uiMaxSpin = m_pLabor->GetNodeInfo().uiBusyPollSpin;
+    if (0 == uiMaxSpin)
     {
-        bRes = false;
+        ev_run (m_loop, 0);
+        return;
     }
-    else
+    LOG4_INFO("busy poll %u us before blocking.", uiMaxSpin);
+    m_uiBusyPollSpin = uiMaxSpin;
+    m_bLoopBreak = false;
+    while (!m_bLoopBreak)
     {
-        m_mapClientConnFrequency.erase(iter);
-        bRes = true;
-    }
-
-    DelEvent(watcher);
-    pData->pDispatcher = nullptr;
-    delete pData;
-    watcher->data = NULL;
-    delete watcher;
-    watcher = NULL;
-    return(bRes);
-}
+        bool bSpinHit = false;
+        uint64 ullSpinStart = GetMonotonicMicroTime();
+        uint64 ullNow = ullSpinStart;
+        while (ullNow - ullSpinStart < m_uiBusyPollSpin && !m_bLoopBreak)
+        {
+            uint64 ullPollStart = ullNow;
+            ev_run (m_loop, EVRUN_NOWAIT);
+            ullNow = GetMonotonicMicroTime();
+            if (m_stLoopStat.uiIterationCallbackNum > 0)
+            {
+                bSpinHit = true;
+                ullSpinStart = ullNow;      // 取到事件，重新开始自旋
+            }
+            else
+            {
+                m_stLoopStat.ullSpinTime += ullNow - ullPollStart;
+            }
+        }
+        if (m_bLoopBreak)
+        {
+            break;
+        }
 
-void Dispatcher::EventRun()
-{
-    ev_run (m_loop, 0);
+        uint64 ullSleepStart = GetMonotonicMicroTime();
+        ev_run (m_loop, EVRUN_ONCE);
+        // ullIterationStart为poll返回的时间
+        uint64 ullSleep = (m_stLoopStat.ullIterationStart > ullSleepStart)
+                ? (m_stLoopStat.ullIterationStart - ullSleepStart) : 0;
+        m_stLoopStat.ullSleepTime += ullSleep;
+        if (ullSleep < uiMaxSpin)     // 自旋更久就能取到事件
+        {
+            uint32 uiSpin = m_uiBusyPollSpin * 2;
+            if (uiSpin < BUSY_POLL_MIN_SPIN)
+            {
+                uiSpin = BUSY_POLL_MIN_SPIN;
+            }
+            m_uiBusyPollSpin = (uiSpin > uiMaxSpin) ? uiMaxSpin : uiSpin;
+        }
+        else if (!bSpinHit)
+        {
+            m_uiBusyPollSpin /= 2;
+        }
+    }
 }
 
 bool Dispatcher::AddIoTimeout(std::shared_ptr<SocketChannel> pChannel, ev_tstamp dTimeout)
@@ -368,28 +523,33 @@ bool Dispatcher::AddIoTimeout(std::shared_ptr<SocketChannel> pChannel, ev_tstamp
         LOG4_INFO("no io timeout");
         return(true);
     }
+    if (m_pIoTimeoutSweepWatcher == nullptr)
+    {
+        m_pIoTimeoutSweepWatcher = (ev_timer*)malloc(sizeof(ev_timer));
+        if (m_pIoTimeoutSweepWatcher == nullptr)
+        {
+            LOG4_ERROR("malloc ev_timer failed!");
+            return(false);
+        }
+        ev_timer_init(m_pIoTimeoutSweepWatcher, IoTimeoutSweepCallback, 1.0, 1.0);
+        m_pIoTimeoutSweepWatcher->data = (void*)this;
+    }
     auto pWatcher = pChannel->MutableWatcher();
     pWatcher->Set(pChannel);
-    ev_timer* timer_watcher = pWatcher->MutableTimerWatcher();
-    if (NULL == timer_watcher)
+    CTimingWheel::tagTimer* pTimer = pWatcher->MutableTimer();
+    pTimer->pFunc = IoTimeoutCallback;
+    uint64 ullNow = GetMonotonicMicroTime();
+    if (m_oIoTimeoutWheel.Size() == 0)
     {
-        return(false);
+        m_oIoTimeoutWheel.Expire(ullNow / 1000000);    // 空闲期间时间轮未推进
     }
-    else
+    // 单调时间按秒向上取整放入对应的槽，刷新只是在槽之间移动链表节点
+    m_oIoTimeoutWheel.Add(pTimer, (ullNow + (uint64)(dTimeout * 1000000) + 999999) / 1000000);
+    if (!ev_is_active(m_pIoTimeoutSweepWatcher))
     {
-        if (ev_is_active(timer_watcher))
-        {
-            ev_timer_stop(m_loop, timer_watcher);
-            ev_timer_set(timer_watcher, dTimeout + ev_time() - ev_now(m_loop), 0);
-            ev_timer_start (m_loop, timer_watcher);
-        }
-        else
-        {
-            ev_timer_init (timer_watcher, IoTimeoutCallback, dTimeout + ev_time() - ev_now(m_loop), 0.);
-            ev_timer_start (m_loop, timer_watcher);
-        }
-        return(true);
+        ev_timer_again(m_loop, m_pIoTimeoutSweepWatcher);
     }
+    return(true);
 }
 
 bool Dispatcher::SendDataReport(int32 iCmd, uint32 uiSeq, const MsgBody& oMsgBody)
@@ -742,10 +902,89 @@ bool Dispatcher::DelEvent(ev_timer* timer_watcher)
     return(true);
 }
 
+bool Dispatcher::AddTimer(CTimingWheel::tagTimer* pTimer, CTimingWheel::timeout_callback pFunc, ev_tstamp dTimeout)
+{
+    if (nullptr == pTimer)
+    {
+        return(false);
+    }
+    pTimer->pFunc = pFunc;
+    return(RefreshTimer(pTimer, dTimeout));
+}
+
+bool Dispatcher::RefreshTimer(CTimingWheel::tagTimer* pTimer, ev_tstamp dTimeout)
+{
+    if (nullptr == pTimer)
+    {
+        return(false);
+    }
+    if (m_pTimingWheelWatcher == nullptr)
+    {
+        m_pTimingWheelWatcher = (ev_timer*)malloc(sizeof(ev_timer));
+        if (m_pTimingWheelWatcher == nullptr)
+        {
+            LOG4_ERROR("malloc ev_timer failed!");
+            return(false);
+        }
+        ev_timer_init(m_pTimingWheelWatcher, TimingWheelCallback, 0., 0.);
+        m_pTimingWheelWatcher->data = (void*)this;
+    }
+    // 时间轮tick取自CLOCK_MONOTONIC（毫秒），不受系统时间调整影响
+    uint64 ullNow = GetMonotonicMicroTime();
+    if (m_oTimingWheel.Size() == 0)
+    {
+        m_oTimingWheel.Expire(ullNow / 1000);  // 空闲期间时间轮未推进
+    }
+    if (dTimeout < 0)
+    {
+        dTimeout = 0;
+    }
+    m_oTimingWheel.Add(pTimer, (ullNow + (uint64)ceil(dTimeout * 1000000) + 999) / 1000);
+    ScheduleTimingWheel();
+    return(true);
+}
+
+bool Dispatcher::DelTimer(CTimingWheel::tagTimer* pTimer)
+{
+    if (nullptr == pTimer)
+    {
+        return(false);
+    }
+    pTimer->Cancel();
+    if (m_oTimingWheel.Size() == 0 && m_pTimingWheelWatcher != nullptr)
+    {
+        ev_timer_stop(m_loop, m_pTimingWheelWatcher);
+        m_ullTimingWheelArmedTick = UINT64_MAX;
+    }
+    return(true);
+}
+
+void Dispatcher::ScheduleTimingWheel()
+{
+    uint64 ullNextTick = m_oTimingWheel.NextTick();
+    if (ev_is_active(m_pTimingWheelWatcher) && ullNextTick >= m_ullTimingWheelArmedTick)
+    {
+        return;     // 已设置的ev_timer会更早到期，到期后重新计算
+    }
+    ev_timer_stop(m_loop, m_pTimingWheelWatcher);
+    m_ullTimingWheelArmedTick = ullNextTick;
+    if (ullNextTick == UINT64_MAX)
+    {
+        return;
+    }
+    uint64 ullNow = GetMonotonicMicroTime();
+    ev_tstamp dAfter = 0;
+    if (ullNextTick * 1000 > ullNow)
+    {
+        dAfter = (ev_tstamp)(ullNextTick * 1000 - ullNow) / 1000000;
+    }
+    ev_timer_set(m_pTimingWheelWatcher, dAfter + ev_time() - ev_now(m_loop), 0.);
+    ev_timer_start(m_loop, m_pTimingWheelWatcher);
+}
+
 void Dispatcher::AddChannelToLoop(std::shared_ptr<SocketChannel> pChannel)
 {
-    auto iter = m_mapSocketChannel.find(pChannel->GetFd());
-    if (iter == m_mapSocketChannel.end())
+    if (GetChannel(pChannel->GetFd()) == nullptr)
     {
         pChannel->SetBonding(m_pLabor, GetLogger(), pChannel);
         pChannel->MutableWatcher()->Set(pChannel);
@@ -753,11 +992,11 @@ void Dispatcher::AddChannelToLoop(std::shared_ptr<SocketChannel> pChannel)
             ? m_pLabor->GetNodeInfo().dConnectionProtection : m_pLabor->GetNodeInfo().dIoTimeout;
         AddIoTimeout(pChannel, dIoTimeout);
         AddIoReadEvent(pChannel);
-        m_mapSocketChannel.insert(std::make_pair(pChannel->GetFd(), pChannel));
+        InsertChannel(pChannel->GetFd(), pChannel);
     }
 }
 
-bool Dispatcher::CreateListenFd(const std::string& strHost, int32 iPort, int iBacklog, int& iFd, int& iFamily)
+bool Dispatcher::CreateListenFd(const std::string& strHost, int32 iPort, int iBacklog, int& iFd, int& iFamily, bool bReusePort)
 {
     int reuse = 1;
     int timeout = 1;
@@ -795,6 +1034,13 @@ bool Dispatcher::CreateListenFd(const std::string& strHost, int32 iPort, int iBa
             iFd = -1;
             continue;
         }
+        if (bReusePort && -1 == ::setsockopt(iFd,
+                    SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(int)))
+        {
+            close(iFd);
+            iFd = -1;
+            continue;
+        }
         if (-1 == ::setsockopt(iFd,
                     IPPROTO_TCP, TCP_DEFER_ACCEPT, &timeout, sizeof(int)))
         {
@@ -816,6 +1062,36 @@ bool Dispatcher::CreateListenFd(const std::string& strHost, int32 iPort, int iBa
             continue;
         }
 
+        if (SOCK_STREAM == pAddrCurrent->ai_socktype)
+        {
+            // Linux下accept()得到的连接继承监听fd的这些选项，无需逐个连接设置
+            int iKeepAlive = 1;
+            int iKeepIdle = 60;
+            int iKeepInterval = 5;
+            int iKeepCount = 3;
+            int iTcpNoDelay = 1;
+            if (setsockopt(iFd, SOL_SOCKET, SO_KEEPALIVE, (void*)&iKeepAlive, sizeof(iKeepAlive)) < 0)
+            {
+                LOG4_WARNING("fail to set SO_KEEPALIVE");
+            }
+            if (setsockopt(iFd, IPPROTO_TCP, TCP_KEEPIDLE, (void*) &iKeepIdle, sizeof(iKeepIdle)) < 0)
+            {
+                LOG4_WARNING("fail to set SO_KEEPIDLE");
+            }
+            if (setsockopt(iFd, IPPROTO_TCP, TCP_KEEPINTVL, (void *)&iKeepInterval, sizeof(iKeepInterval)) < 0)
+            {
+                LOG4_WARNING("fail to set SO_KEEPINTVL");
+            }
+            if (setsockopt(iFd, IPPROTO_TCP, TCP_KEEPCNT, (void*)&iKeepCount, sizeof (iKeepCount)) < 0)
+            {
+                LOG4_WARNING("fail to set SO_KEEPCNT");
+            }
+            if (setsockopt(iFd, IPPROTO_TCP, TCP_NODELAY, (void*)&iTcpNoDelay, sizeof(iTcpNoDelay)) < 0)
+            {
+                LOG4_WARNING("fail to set TCP_NODELAY");
+            }
+        }
+        x_sock_set_block(iFd, 0);   // 监听fd非阻塞，批量accept直到EAGAIN
         iFamily = pAddrCurrent->ai_family;
         break;
     }
@@ -835,91 +1111,1417 @@ bool Dispatcher::CreateListenFd(const std::string& strHost, int32 iPort, int iBa
 
 std::shared_ptr<SocketChannel> Dispatcher::GetChannel(int iFd)
 {
-    auto iter = m_mapSocketChannel.find(iFd);
-    if (iter != m_mapSocketChannel.end())
+    if (iFd >= 0 && (size_t)iFd < m_vecSocketChannel.size())
     {
-        return(iter->second);
+        return(m_vecSocketChannel[iFd]);
     }
     return(nullptr);
 }
 
 int32 Dispatcher::GetConnectionNum() const
 {
-    return((int32)m_mapSocketChannel.size());
+    return((int32)m_uiChannelNum);
 }
 
-bool Dispatcher::Init()
+bool Dispatcher::InsertChannel(int iFd, std::shared_ptr<SocketChannel> pChannel)
 {
-#if __cplusplus >= 201401L
-    m_pSessionNode = std::make_unique<Nodes>();
-#else
-    m_pSessionNode = std::unique_ptr<Nodes>(new Nodes());
-#endif
-    SetChannelPingStep(CODEC_PROTO, "neb::StepNebulaChannelPing");
-    SetChannelPingStep(CODEC_NEBULA, "neb::StepNebulaChannelPing");
-    SetChannelPingStep(CODEC_RESP, "neb::StepRedisChannelPing");
+    if (iFd < 0)
+    {
+        return(false);
+    }
+    if ((size_t)iFd >= m_vecSocketChannel.size())
+    {
+        m_vecSocketChannel.resize(iFd + 1);
+    }
+    if (m_vecSocketChannel[iFd] != nullptr)
+    {
+        return(false);
+    }
+    m_vecSocketChannel[iFd] = pChannel;
+    ++m_uiChannelNum;
     return(true);
 }
 
-void Dispatcher::AsyncSend(ev_async* pWatcher)
+void Dispatcher::EraseChannel(std::shared_ptr<SocketChannel> pChannel)
 {
-    ev_async_send(m_loop, pWatcher);
+    int iFd = pChannel->GetFd();
+    if (iFd >= 0 && (size_t)iFd < m_vecSocketChannel.size() && m_vecSocketChannel[iFd] == pChannel)
+    {
+        m_vecSocketChannel[iFd] = nullptr;
+        --m_uiChannelNum;
+        LOG4_TRACE("erase channel %d channel_seq %u from m_vecSocketChannel.", iFd, pChannel->GetSequence());
+    }
 }
 
-void Dispatcher::Destroy()
+void Dispatcher::GetSendQueueStat(uint64& ullTotalBytes, uint64& ullMaxBytes, uint32& uiReadSuspendedNum) const
 {
-    m_mapSocketChannel.clear();
-    m_mapNamedSocketChannel.clear();
-    if (m_loop != NULL)
-    {
-        ev_loop_destroy(m_loop);
-        m_loop = NULL;
-    }
-    if (m_pErrBuff != NULL)
+    ullTotalBytes = 0;
+    ullMaxBytes = 0;
+    uiReadSuspendedNum = 0;
+    for (auto& pChannel : m_vecSocketChannel)
     {
-        free(m_pErrBuff);
-        m_pErrBuff = NULL;
+        if (pChannel == nullptr)
+        {
+            continue;
+        }
+        uint64 ullBytes = pChannel->GetSendQueueBytes();
+        ullTotalBytes += ullBytes;
+        if (ullBytes > ullMaxBytes)
+        {
+            ullMaxBytes = ullBytes;
+        }
+        if (pChannel->IsReadSuspended())
+        {
+            ++uiReadSuspendedNum;
+        }
     }
-    m_pLabor = nullptr;
 }
 
-std::shared_ptr<SocketChannel> Dispatcher::CreateSocketChannel(int iFd, E_CODEC_TYPE eCodecType, bool bIsClient, bool bWithSsl)
+void Dispatcher::ResetUnitTimeMsgNum()
 {
-    LOG4_TRACE("iFd %d, codec_type %d, with_ssl = %d", iFd, eCodecType, bWithSsl);
-
-    auto iter = m_mapSocketChannel.find(iFd);
-    if (iter == m_mapSocketChannel.end())
+    for (auto& pChannel : m_vecSocketChannel)
     {
-        auto pChannel = CodecFactory::CreateChannel(m_pLabor, m_pLogger, iFd, eCodecType, bIsClient, bWithSsl);
         if (pChannel != nullptr)
         {
-            m_mapSocketChannel.insert(std::make_pair(iFd, pChannel));
-            LOG4_TRACE("new channel[%d] with codec type %d", pChannel->GetFd(), pChannel->GetCodecType());
+            pChannel->ResetUnitTimeMsgNum();
         }
-        return(pChannel);
     }
-    else
+    m_dUnitTimeStart = ev_now(m_loop);
+}
+
+std::shared_ptr<SocketChannel> Dispatcher::GetRebalanceChannel(double dMinMsgRate, double dMaxMsgRate)
+{
+    ev_tstamp dUnitTime = ev_now(m_loop) - m_dUnitTimeStart;
+    if (dUnitTime < 1.0)
     {
-        LOG4_WARNING("fd %d is exist!", iFd);
-        return(iter->second);
+        dUnitTime = 1.0;
+    }
+    const std::unordered_map<int, int>* pMapListenFd = nullptr;
+    if (Labor::LABOR_WORKER == m_pLabor->GetLaborType())
+    {
+        pMapListenFd = &((Worker*)m_pLabor)->GetWorkerInfo().mapAccessFdFamily;
     }
+    std::shared_ptr<SocketChannel> pHeaviestChannel = nullptr;
+    double dHeaviestRate = 0.0;
+    for (size_t i = 0; i < m_vecSocketChannel.size(); ++i)
+    {
+        auto& pChannel = m_vecSocketChannel[i];
+        if (pChannel == nullptr || pChannel->IsClient() || !pChannel->IsAutoMigrate() || pChannel->m_bRingIo
+                || CHANNEL_STATUS_ESTABLISHED != pChannel->GetChannelStatus()
+                || !pChannel->PipelineIsEmpty())
+        {
+            continue;
+        }
+        if (pMapListenFd != nullptr && pMapListenFd->find((int)i) != pMapListenFd->end())
+        {
+            continue;
+        }
+        double dMsgRate = pChannel->GetUnitTimeMsgNum() / dUnitTime;
+        if (dMsgRate >= dMinMsgRate && dMsgRate < dMaxMsgRate && dMsgRate > dHeaviestRate)
+        {
+            dHeaviestRate = dMsgRate;
+            pHeaviestChannel = pChannel;
+        }
+    }
+    ResetUnitTimeMsgNum();
+    return(pHeaviestChannel);
 }
 
-bool Dispatcher::DiscardSocketChannel(std::shared_ptr<SocketChannel> pChannel, bool bChannelNotice)
+bool Dispatcher::Init()
 {
-    if (pChannel == nullptr)
+    if (!NewLoop(m_pLabor->GetNodeInfo().strIoBackend))
     {
-        LOG4_TRACE("pChannel not exist!");
         return(false);
     }
+    struct rlimit stRlimit;
+    if (getrlimit(RLIMIT_NOFILE, &stRlimit) == 0 && stRlimit.rlim_cur != RLIM_INFINITY)
+    {
+        // 只预留地址空间，实际按最大fd增长
+        size_t uiReserve = MAX_CHANNEL_TABLE_RESERVE;
+        if (stRlimit.rlim_cur < uiReserve)
+        {
+            uiReserve = stRlimit.rlim_cur;
+        }
+        m_vecSocketChannel.reserve(uiReserve);
+    }
+    m_dUnitTimeStart = ev_now(m_loop);
+#if __cplusplus >= 201401L
+    m_pSessionNode = std::make_unique<Nodes>();
+#else
+    m_pSessionNode = std::unique_ptr<Nodes>(new Nodes());
+#endif
+    SetChannelPingStep(CODEC_PROTO, "neb::StepNebulaChannelPing");
+    SetChannelPingStep(CODEC_NEBULA, "neb::StepNebulaChannelPing");
+    SetChannelPingStep(CODEC_RESP, "neb::StepRedisChannelPing");
 
-    auto named_iter = m_mapNamedSocketChannel.find(pChannel->GetIdentify());
-    if (named_iter != m_mapNamedSocketChannel.end())
+    // 事件循环迭代耗时统计：check在poll返回后最先执行，prepare在下一次poll前最后执行
+    ev_set_userdata(m_loop, (void*)this);
+    m_pLoopCheckWatcher = (ev_check*)malloc(sizeof(ev_check));
+    m_pLoopPrepareWatcher = (ev_prepare*)malloc(sizeof(ev_prepare));
+    if (m_pLoopCheckWatcher == nullptr || m_pLoopPrepareWatcher == nullptr)
     {
-       for (auto it = named_iter->second.begin();
-           it != named_iter->second.end(); ++it)
-       {
-           if ((*it)->GetSequence() == pChannel->GetSequence())
+        LOG4_ERROR("malloc loop monitor watcher failed!");
+        return(false);
+    }
+    ev_check_init(m_pLoopCheckWatcher, LoopCheckCallback);
+    ev_set_priority(m_pLoopCheckWatcher, EV_MAXPRI);
+    m_pLoopCheckWatcher->data = (void*)this;
+    ev_check_start(m_loop, m_pLoopCheckWatcher);
+    ev_prepare_init(m_pLoopPrepareWatcher, LoopPrepareCallback);
+    ev_set_priority(m_pLoopPrepareWatcher, EV_MINPRI);
+    m_pLoopPrepareWatcher->data = (void*)this;
+    ev_prepare_start(m_loop, m_pLoopPrepareWatcher);
+    if (m_pLabor->GetNodeInfo().strIoBackend == "io_uring")
+    {
+        InitRing();
+    }
+    return(true);
+}
+
+void Dispatcher::OnLoopIterationDone()
+{
+    if (m_stLoopStat.ullIterationStart == 0)
+    {
+        return;     // 第一次poll之前
+    }
+    uint64 ullDuration = GetMonotonicMicroTime() - m_stLoopStat.ullIterationStart;
+    ++m_stLoopStat.ullIterationNum;
+    m_stLoopStat.ullCallbackNum += m_stLoopStat.uiIterationCallbackNum;
+    if (ullDuration > m_stLoopStat.ullMaxIteration)
+    {
+        m_stLoopStat.ullMaxIteration = ullDuration;
+    }
+    for (uint32 i = 0; i < LOOP_LAG_BUCKET_NUM; ++i)
+    {
+        if (ullDuration <= (uint64)LOOP_LAG_BUCKET[i] * 1000)
+        {
+            ++m_stLoopStat.auiLagHistogram[i];
+            break;
+        }
+    }
+    if (ullDuration >= m_stLoopStat.ullStallThreshold)
+    {
+        ++m_stLoopStat.uiStallNum;
+        LOG4_WARNING("event loop stall %.3f ms, %u callbacks, slowest %s(%s) %.3f ms.",
+                ullDuration / 1000.0, m_stLoopStat.uiIterationCallbackNum,
+                m_stLoopStat.szSlowestCallback, m_stLoopStat.strSlowestOwner.c_str(),
+                m_stLoopStat.ullSlowestCallback / 1000.0);
+    }
+    m_stLoopStat.ullIterationStart = 0;
+}
+
+std::string Dispatcher::GetCallbackOwner(SocketChannel* pChannel)
+{
+    if (pChannel == nullptr)
+    {
+        return("");
+    }
+    return("codec " + std::to_string((int)pChannel->GetCodecType()));
+}
+
+std::string Dispatcher::GetCallbackOwner(Actor* pActor)
+{
+    if (pActor == nullptr)
+    {
+        return("");
+    }
+    return(pActor->GetActorName());
+}
+
+void Dispatcher::AddSlowCallback(const char* szCallback, const std::string& strOwner, uint64 ullElapsed)
+{
+    std::string strKey = szCallback;
+    if (strOwner.size() > 0)
+    {
+        strKey += " " + strOwner;
+    }
+    tagSlowCallback& stSlow = m_stLoopStat.mapSlowCallback[strKey];
+    ++stSlow.uiNum;
+    if (ullElapsed > stSlow.ullMaxTime)
+    {
+        stSlow.ullMaxTime = ullElapsed;
+    }
+}
+
+void Dispatcher::OnSlowCallback(const char* szCallback, uint64 ullElapsed, SocketChannel* pChannel)
+{
+    AddSlowCallback(szCallback, GetCallbackOwner(pChannel), ullElapsed);
+    if (pChannel == nullptr)
+    {
+        LOG4_WARNING("slow %s %.3f ms.", szCallback, ullElapsed / 1000.0);
+        return;
+    }
+    LOG4_WARNING("slow %s %.3f ms: channel fd %d, seq %u, codec %d, identify \"%s\", remote addr \"%s\".",
+            szCallback, ullElapsed / 1000.0, pChannel->GetFd(), pChannel->GetSequence(),
+            pChannel->GetCodecType(), pChannel->GetIdentify().c_str(), pChannel->GetRemoteAddr().c_str());
+}
+
+void Dispatcher::OnSlowCallback(const char* szCallback, uint64 ullElapsed, Actor* pActor)
+{
+    AddSlowCallback(szCallback, GetCallbackOwner(pActor), ullElapsed);
+    if (pActor == nullptr)
+    {
+        LOG4_WARNING("slow %s %.3f ms.", szCallback, ullElapsed / 1000.0);
+        return;
+    }
+    LOG4_WARNING("slow %s %.3f ms: %s, seq %u, trace id %s.",
+            szCallback, ullElapsed / 1000.0, pActor->GetActorName().c_str(),
+            pActor->GetSequence(), pActor->GetTraceId().c_str());
+}
+
+void Dispatcher::ResetLoopStat()
+{
+    m_stLoopStat.ullIterationNum = 0;
+    m_stLoopStat.ullCallbackNum = 0;
+    m_stLoopStat.ullMaxIteration = 0;
+    m_stLoopStat.uiStallNum = 0;
+    m_stLoopStat.ullSpinTime = 0;
+    m_stLoopStat.ullSleepTime = 0;
+    m_stLoopStat.mapSlowCallback.clear();
+    for (uint32 i = 0; i < LOOP_LAG_BUCKET_NUM; ++i)
+    {
+        m_stLoopStat.auiLagHistogram[i] = 0;
+    }
+}
+
+bool Dispatcher::NewLoop(const std::string& strIoBackend)
+{
+    unsigned int uiFlags = EVFLAG_FORKCHECK | EVFLAG_SIGNALFD;
+    unsigned int uiBackend = 0;
+    if (strIoBackend == "epoll" || strIoBackend == "io_uring")
+    {
+        // io_uring模式下连接的收发和监听fd的accept由InitRing()创建的io_uring完成，
+        // 事件循环仍用epoll驱动定时器、异步通知、环fd以及不走io_uring的连接（SSL、客户端连接）
+        uiBackend = EVBACKEND_EPOLL;
+    }
+    else if (strIoBackend.size() > 0 && strIoBackend != "auto")
+    {
+        LOG4_WARNING("unknown io_backend \"%s\", use the default backend.", strIoBackend.c_str());
+    }
+    if (uiBackend != 0 && !(ev_supported_backends() & uiBackend))
+    {
+        LOG4_WARNING("io backend %s is not supported by libev on this platform, use the default backend.",
+                IoBackendName(uiBackend));
+        uiBackend = 0;
+    }
+    if (uiBackend != 0)
+    {
+        m_loop = ev_loop_new(uiFlags | uiBackend);
+        if (m_loop == NULL)
+        {
+            LOG4_WARNING("failed to init io backend %s, use the default backend.", IoBackendName(uiBackend));
+        }
+    }
+    if (m_loop == NULL)
+    {
+        m_loop = ev_loop_new(uiFlags);
+    }
+    if (m_loop == NULL)
+    {
+        LOG4_ERROR("ev_loop_new() failed!");
+        return(false);
+    }
+    LOG4_INFO("io backend %s", IoBackendName(ev_backend(m_loop)));
+    return(true);
+}
+
+bool Dispatcher::InitRing()
+{
+    std::unique_ptr<CIoUring> pRing(new CIoUring());
+    if (!pRing->Init())
+    {
+        LOG4_WARNING("io_uring is not available, error %d: %s, use libev backend %s.",
+                pRing->GetErrno(), strerror_r(pRing->GetErrno(), m_pErrBuff, gc_iErrBuffLen),
+                IoBackendName(ev_backend(m_loop)));
+        return(false);
+    }
+    m_pRingWatcher = (ev_io*)malloc(sizeof(ev_io));
+    m_pRingPrepareWatcher = (ev_prepare*)malloc(sizeof(ev_prepare));
+    if (m_pRingWatcher == nullptr || m_pRingPrepareWatcher == nullptr)
+    {
+        LOG4_ERROR("malloc io_uring watcher failed, use libev backend %s.", IoBackendName(ev_backend(m_loop)));
+        free(m_pRingWatcher);
+        free(m_pRingPrepareWatcher);
+        m_pRingWatcher = nullptr;
+        m_pRingPrepareWatcher = nullptr;
+        return(false);
+    }
+    ev_io_init(m_pRingWatcher, RingCallback, pRing->GetFd(), EV_READ);
+    m_pRingWatcher->data = (void*)this;
+    ev_io_start(m_loop, m_pRingWatcher);
+    ev_prepare_init(m_pRingPrepareWatcher, RingPrepareCallback);
+    ev_set_priority(m_pRingPrepareWatcher, EV_MINPRI);  // 在其他prepare之后，包含其中产生的请求
+    m_pRingPrepareWatcher->data = (void*)this;
+    ev_prepare_start(m_loop, m_pRingPrepareWatcher);
+    m_pRing = std::move(pRing);
+    m_bRingAccept = true;
+    m_bRingRecv = true;
+    LOG4_INFO("io_uring enabled, %u recv buffers of %u bytes.",
+            (uint32)CIoUring::DEFAULT_BUFFER_NUM, m_pRing->GetBufferSize());
+    return(true);
+}
+
+bool Dispatcher::IsListenFd(int iFd) const
+{
+    if (Labor::LABOR_MANAGER == m_pLabor->GetLaborType())
+    {
+        const auto& stManagerInfo = ((Manager*)m_pLabor)->GetManagerInfo();
+        return(iFd == stManagerInfo.iS2SListenFd
+                || (stManagerInfo.iC2SListenFd > 2 && iFd == stManagerInfo.iC2SListenFd)
+                || stManagerInfo.setAccessFd.find(iFd) != stManagerInfo.setAccessFd.end());
+    }
+    else if (Labor::LABOR_WORKER == m_pLabor->GetLaborType())
+    {
+        auto& mapAccessFd = ((Worker*)m_pLabor)->GetWorkerInfo().mapAccessFdFamily;
+        return(mapAccessFd.find(iFd) != mapAccessFd.end());
+    }
+    return(false);
+}
+
+bool Dispatcher::RingAccept(std::shared_ptr<SocketChannel> pChannel)
+{
+    if (!m_bRingAccept)
+    {
+        return(false);
+    }
+    if (pChannel->m_ullRingRecvId != 0)
+    {
+        auto iter = m_mapRingRequest.find(pChannel->m_ullRingRecvId);
+        if (iter != m_mapRingRequest.end() && iter->second.bCanceled)
+        {
+            iter->second.bRearm = true;
+        }
+        return(true);
+    }
+    uint64 ullRequestId = ++m_ullRingRequestId;
+    if (!m_pRing->PrepareAccept(pChannel->GetFd(), ullRequestId))
+    {
+        LOG4_WARNING("io_uring submission queue is full, accept fd %d with libev.", pChannel->GetFd());
+        return(false);
+    }
+    tagRingRequest& stRequest = m_mapRingRequest[ullRequestId];
+    stRequest.ucType = RING_ACCEPT;
+    stRequest.iFd = pChannel->GetFd();
+    stRequest.pChannel = pChannel;
+    pChannel->m_ullRingRecvId = ullRequestId;
+    m_mapRingAccepted[pChannel->GetFd()];   // 此后Accept()从已接受队列取连接
+    return(true);
+}
+
+bool Dispatcher::RingRecv(std::shared_ptr<SocketChannel> pChannel)
+{
+    if (!m_bRingRecv || pChannel->IsClient() || pChannel->WithSsl() || pChannel->IsMigrated())
+    {
+        return(false);
+    }
+    if (pChannel->m_ullRingRecvId != 0)
+    {
+        auto iter = m_mapRingRequest.find(pChannel->m_ullRingRecvId);
+        if (iter != m_mapRingRequest.end() && iter->second.bCanceled)
+        {
+            iter->second.bRearm = true;
+        }
+        return(true);
+    }
+    if (!pChannel->m_bRingIo)
+    {
+        ev_io* io_watcher = pChannel->MutableWatcher()->MutableIoWatcher();
+        if ((io_watcher != NULL && ev_is_active(io_watcher)) || !pChannel->SetRingIo(true))
+        {
+            return(false);      // 已经由libev读写的连接不切换
+        }
+    }
+    uint64 ullRequestId = ++m_ullRingRequestId;
+    if (!m_pRing->PrepareRecv(pChannel->GetFd(), ullRequestId))
+    {
+        LOG4_WARNING("io_uring submission queue is full, recv fd %d with libev.", pChannel->GetFd());
+        pChannel->SetRingIo(false);
+        return(false);
+    }
+    tagRingRequest& stRequest = m_mapRingRequest[ullRequestId];
+    stRequest.ucType = RING_RECV;
+    stRequest.iFd = pChannel->GetFd();
+    stRequest.pChannel = pChannel;
+    pChannel->m_ullRingRecvId = ullRequestId;
+    return(true);
+}
+
+bool Dispatcher::RingSend(std::shared_ptr<SocketChannel> pChannel)
+{
+    if (m_pRing == nullptr || CHANNEL_STATUS_ESTABLISHED != pChannel->GetChannelStatus())
+    {
+        return(false);
+    }
+    if (pChannel->m_ullRingSendId != 0)
+    {
+        return(true);   // 完成后OnRingSend()继续发送
+    }
+    uint64 ullRequestId = ++m_ullRingRequestId;
+    tagRingRequest& stRequest = m_mapRingRequest[ullRequestId];    // 元素地址在完成前不变，可供内核引用
+    memset(&stRequest.stSendMsg, 0, sizeof(stRequest.stSendMsg));
+    stRequest.stSendMsg.msg_iov = stRequest.stSendIov;
+    stRequest.stSendMsg.msg_iovlen = pChannel->PinRingSend(stRequest.stSendIov, CBufferChain::MAX_IOV);
+    if (0 == stRequest.stSendMsg.msg_iovlen)
+    {
+        pChannel->RingSendDone(0);
+        m_mapRingRequest.erase(ullRequestId);
+        return(false);  // 队首是文件段（sendfile）或没有内存中的数据，等待可写
+    }
+    if (!m_pRing->PrepareSendMsg(pChannel->GetFd(), &stRequest.stSendMsg, ullRequestId))
+    {
+        pChannel->RingSendDone(0);
+        m_mapRingRequest.erase(ullRequestId);
+        return(false);
+    }
+    stRequest.ucType = RING_SEND;
+    stRequest.iFd = pChannel->GetFd();
+    stRequest.pChannel = pChannel;
+    stRequest.pSendChannel = pChannel;
+    pChannel->m_ullRingSendId = ullRequestId;
+    pChannel->SetRingSendPending(true);
+    return(true);
+}
+
+void Dispatcher::RingCancel(uint64 ullRequestId)
+{
+    auto iter = m_mapRingRequest.find(ullRequestId);
+    if (iter == m_mapRingRequest.end())
+    {
+        return;
+    }
+    iter->second.bRearm = false;
+    if (!iter->second.bCanceled)
+    {
+        iter->second.bCanceled = true;
+        m_pRing->PrepareCancel(ullRequestId, 0);
+    }
+}
+
+void Dispatcher::CancelRingIo(std::shared_ptr<SocketChannel> pChannel)
+{
+    // 请求持有socket的引用，不取消的话close()之后连接也不会关闭
+    if (pChannel->m_ullRingRecvId != 0)
+    {
+        RingCancel(pChannel->m_ullRingRecvId);
+    }
+    if (pChannel->m_ullRingSendId != 0)
+    {
+        RingCancel(pChannel->m_ullRingSendId);
+    }
+}
+
+void Dispatcher::ReapRing()
+{
+    m_vecRingCompletion.clear();
+    m_pRing->Reap(m_vecRingCompletion, RING_REAP_BATCH);
+    for (size_t i = 0; i < m_vecRingCompletion.size(); ++i)
+    {
+        const CIoUring::tagCompletion& stCompletion = m_vecRingCompletion[i];
+        auto iter = m_mapRingRequest.find(stCompletion.ullUserData);
+        if (iter == m_mapRingRequest.end())     // 取消请求本身的完成事件
+        {
+            if (stCompletion.HasBuffer())
+            {
+                m_pRing->RecycleBuffer(stCompletion.BufferId());
+            }
+            continue;
+        }
+        switch (iter->second.ucType)
+        {
+            case RING_ACCEPT:
+                OnRingAccept(stCompletion.ullUserData, stCompletion);
+                break;
+            case RING_RECV:
+                OnRingRecv(stCompletion.ullUserData, stCompletion);
+                break;
+            case RING_SEND:
+                OnRingSend(stCompletion.ullUserData, stCompletion);
+                break;
+            default:
+                m_mapRingRequest.erase(iter);
+        }
+    }
+    FlushRingAccepted();
+}
+
+void Dispatcher::OnRingAccept(uint64 ullRequestId, const CIoUring::tagCompletion& stCompletion)
+{
+    auto iter = m_mapRingRequest.find(ullRequestId);
+    int iListenFd = iter->second.iFd;
+    if (stCompletion.iResult >= 0)
+    {
+        m_mapRingAccepted[iListenFd].push_back(stCompletion.iResult);
+    }
+    if (stCompletion.More())
+    {
+        return;
+    }
+    auto pChannel = iter->second.pChannel.lock();
+    bool bRearm = !iter->second.bCanceled || iter->second.bRearm;
+    m_mapRingRequest.erase(iter);
+    if (pChannel == nullptr || pChannel->m_ullRingRecvId != ullRequestId)
+    {
+        return;
+    }
+    pChannel->m_ullRingRecvId = 0;
+    if (stCompletion.iResult < 0 && -ECANCELED != stCompletion.iResult)
+    {
+        LOG4_WARNING("io_uring accept on fd %d terminated, error %d: %s", iListenFd, -stCompletion.iResult,
+                strerror_r(-stCompletion.iResult, m_pErrBuff, gc_iErrBuffLen));
+        if (-EINVAL == stCompletion.iResult)   // 内核不支持多次完成的accept（5.19以下）
+        {
+            m_bRingAccept = false;
+        }
+    }
+    if (bRearm && CHANNEL_STATUS_CLOSED != pChannel->GetChannelStatus())
+    {
+        AddIoReadEvent(pChannel);
+    }
+}
+
+void Dispatcher::OnRingRecv(uint64 ullRequestId, const CIoUring::tagCompletion& stCompletion)
+{
+    auto iter = m_mapRingRequest.find(ullRequestId);
+    auto pChannel = iter->second.pChannel.lock();
+    bool bRearm = !iter->second.bCanceled || iter->second.bRearm;
+    if (!stCompletion.More())
+    {
+        m_mapRingRequest.erase(iter);
+        if (pChannel != nullptr && pChannel->m_ullRingRecvId == ullRequestId)
+        {
+            pChannel->m_ullRingRecvId = 0;
+        }
+        else
+        {
+            bRearm = false;
+        }
+    }
+    else
+    {
+        bRearm = false;
+    }
+    if (pChannel == nullptr || CHANNEL_STATUS_CLOSED == pChannel->GetChannelStatus())
+    {
+        if (stCompletion.HasBuffer())
+        {
+            m_pRing->RecycleBuffer(stCompletion.BufferId());
+        }
+        return;
+    }
+    if (-ENOBUFS == stCompletion.iResult || -ECANCELED == stCompletion.iResult)
+    {
+        ;   // 缓冲区环暂时用尽或已取消读，数据仍在socket中
+    }
+    else if (-EINVAL == stCompletion.iResult)
+    {
+        LOG4_WARNING("io_uring multishot recv is not supported by the kernel, use libev.");
+        m_bRingRecv = false;    // 内核不支持多次完成的recv（6.0以下），此后的连接都走libev
+        pChannel->SetRingIo(false);
+    }
+    else
+    {
+        uint64 ullStartTime = GetCoarseMicroTime();
+        pChannel->FeedRecv(stCompletion.HasBuffer() ? m_pRing->GetBuffer(stCompletion.BufferId()) : nullptr,
+                stCompletion.iResult);
+        OnIoRead(pChannel);
+        pChannel->FeedRecv(nullptr, -EAGAIN);   // 丢弃未被读取的结果（缓冲区即将放回缓冲区环）
+        LoopCallbackDone("RingRecv", ullStartTime, pChannel.get());
+        if (stCompletion.iResult <= 0)
+        {
+            bRearm = false;
+        }
+    }
+    if (stCompletion.HasBuffer())
+    {
+        m_pRing->RecycleBuffer(stCompletion.BufferId());
+    }
+    if (bRearm && CHANNEL_STATUS_CLOSED != pChannel->GetChannelStatus() && !pChannel->IsReadSuspended())
+    {
+        AddIoReadEvent(pChannel);
+    }
+}
+
+void Dispatcher::OnRingSend(uint64 ullRequestId, const CIoUring::tagCompletion& stCompletion)
+{
+    auto iter = m_mapRingRequest.find(ullRequestId);
+    std::shared_ptr<SocketChannel> pChannel = std::move(iter->second.pSendChannel);
+    m_mapRingRequest.erase(iter);
+    pChannel->m_ullRingSendId = 0;
+    pChannel->SetRingSendPending(false);
+    if (CHANNEL_STATUS_CLOSED == pChannel->GetChannelStatus() || stCompletion.iResult <= 0)
+    {
+        pChannel->RingSendDone(0);      // 内核已不再引用发送段，连接已关闭时在此释放
+    }
+    else
+    {
+        pChannel->RingSendDone(stCompletion.iResult);
+    }
+    if (CHANNEL_STATUS_CLOSED == pChannel->GetChannelStatus() || -ECANCELED == stCompletion.iResult)
+    {
+        return;
+    }
+    uint64 ullStartTime = GetCoarseMicroTime();
+    if (stCompletion.iResult >= 0 || -EAGAIN == stCompletion.iResult || -EINTR == stCompletion.iResult)
+    {
+        OnIoWrite(pChannel);    // 继续发送队列中剩余的数据，发不完时再次提交
+    }
+    else
+    {
+        LOG4_ERROR("io_uring send to %s[fd %d] error %d: %s", pChannel->GetIdentify().c_str(),
+                pChannel->GetFd(), -stCompletion.iResult,
+                strerror_r(-stCompletion.iResult, m_pErrBuff, gc_iErrBuffLen));
+        pChannel->SetChannelStatus(CHANNEL_STATUS_BROKEN);
+        DiscardSocketChannel(pChannel);
+    }
+    LoopCallbackDone("RingSend", ullStartTime, pChannel.get());
+}
+
+void Dispatcher::FlushRingAccepted()
+{
+    std::vector<int> vecListenFd;
+    for (auto iter = m_mapRingAccepted.begin(); iter != m_mapRingAccepted.end(); ++iter)
+    {
+        if (!iter->second.empty())
+        {
+            vecListenFd.push_back(iter->first);
+        }
+    }
+    for (auto fd_it = vecListenFd.begin(); fd_it != vecListenFd.end(); ++fd_it)
+    {
+        std::deque<int>& dequeAccepted = m_mapRingAccepted[*fd_it];
+        auto pChannel = GetChannel(*fd_it);
+        // 连接已被内核接受，不受accept_batch限制，全部处理完
+        while (pChannel != nullptr && !dequeAccepted.empty())
+        {
+            size_t uiAcceptedNum = dequeAccepted.size();
+            OnIoRead(pChannel);
+            if (dequeAccepted.size() == uiAcceptedNum)
+            {
+                break;
+            }
+        }
+        while (!dequeAccepted.empty())  // 监听fd已关闭
+        {
+            close(dequeAccepted.front());
+            dequeAccepted.pop_front();
+        }
+    }
+}
+
+void Dispatcher::SubmitRing()
+{
+    if (m_pRing != nullptr && m_pRing->Pending() > 0 && m_pRing->Submit() < 0)
+    {
+        LOG4_WARNING("io_uring submit error %d: %s, retry before next poll.", m_pRing->GetErrno(),
+                strerror_r(m_pRing->GetErrno(), m_pErrBuff, gc_iErrBuffLen));
+    }
+}
+
+const char* Dispatcher::IoBackendName(unsigned int uiBackend)
+{
+    switch (uiBackend)
+    {
+        case EVBACKEND_SELECT:
+            return("select");
+        case EVBACKEND_POLL:
+            return("poll");
+        case EVBACKEND_EPOLL:
+            return("epoll");
+        case EVBACKEND_KQUEUE:
+            return("kqueue");
+#ifdef EVBACKEND_LINUXAIO
+        case EVBACKEND_LINUXAIO:
+            return("linuxaio");
+#endif
+#ifdef EVBACKEND_IOURING
+        case EVBACKEND_IOURING:
+            return("io_uring");
+#endif
+        default:
+            return("unknown");
+    }
+}
+
+void Dispatcher::AsyncSend(ev_async* pWatcher)
+{
+    ev_async_send(m_loop, pWatcher);
+}
+
+void Dispatcher::AsyncSend(Dispatcher* pToDispatcher, SpecChannelWatcher* pWatcher)
+{
+    if (pWatcher->IsOverflow() && !pWatcher->IsOverflowWatched())
+    {
+        if (m_pSpecChannelOverflowWatcher == nullptr)
+        {
+            m_pSpecChannelOverflowWatcher = (ev_timer*)malloc(sizeof(ev_timer));
+            if (m_pSpecChannelOverflowWatcher != nullptr)
+            {
+                ev_timer_init(m_pSpecChannelOverflowWatcher, SpecChannelOverflowCallback, 0.001, 0.001);
+                m_pSpecChannelOverflowWatcher->data = (void*)this;
+            }
+        }
+        if (m_pSpecChannelOverflowWatcher == nullptr)
+        {
+            LOG4_ERROR("malloc ev_timer failed, spec channel overflow will be flushed by next write.");
+        }
+        else
+        {
+            pWatcher->SetOverflowWatched(true);
+            m_vecSpecChannelOverflow.push_back(std::make_pair(pToDispatcher, pWatcher));
+            if (!ev_is_active(m_pSpecChannelOverflowWatcher))
+            {
+                ev_timer_again(m_loop, m_pSpecChannelOverflowWatcher);
+            }
+        }
+    }
+    if (!pWatcher->SetNotified())
+    {
+        return;     // 消费方尚未读空，无需再次通知
+    }
+    if (m_pAsyncNotifyWatcher == nullptr)
+    {
+        m_pAsyncNotifyWatcher = (ev_prepare*)malloc(sizeof(ev_prepare));
+        if (m_pAsyncNotifyWatcher == nullptr)
+        {
+            LOG4_ERROR("malloc ev_prepare failed, notify immediately.");
+            pToDispatcher->AsyncSend(pWatcher->MutableAsyncWatcher());
+            return;
+        }
+        ev_prepare_init(m_pAsyncNotifyWatcher, AsyncNotifyCallback);
+        ev_set_priority(m_pAsyncNotifyWatcher, EV_MINPRI);  // 在其他prepare之后，包含其中产生的写入
+        m_pAsyncNotifyWatcher->data = (void*)this;
+    }
+    m_vecAsyncNotify.push_back(std::make_pair(pToDispatcher, pWatcher->MutableAsyncWatcher()));
+    if (!ev_is_active(m_pAsyncNotifyWatcher))
+    {
+        ev_prepare_start(m_loop, m_pAsyncNotifyWatcher);
+    }
+}
+
+bool Dispatcher::AsyncCompute(uint32 uiStepSeq, std::function<int32(std::string&)>&& fnCompute,
+        std::shared_ptr<std::atomic<bool>> pCanceled)
+{
+    if (m_pComputeSink == nullptr)
+    {
+        m_pComputeSink = std::make_shared<tagComputeSink>();
+        m_pComputeSink->pLoop = m_loop;
+        ev_async_init(&m_pComputeSink->oWatcher, ComputeDoneCallback);
+        m_pComputeSink->oWatcher.data = (void*)this;
+        ev_async_start(m_loop, &m_pComputeSink->oWatcher);
+    }
+    std::shared_ptr<tagComputeSink> pSink = m_pComputeSink;
+    auto fnTask = [pSink, uiStepSeq, pCanceled, fnCompute = std::move(fnCompute)]()
+    {
+        tagComputeResult stResult;
+        stResult.uiStepSeq = uiStepSeq;
+        if (pCanceled->load(std::memory_order_relaxed))
+        {
+            stResult.bCanceled = true;
+        }
+        else
+        {
+            try
+            {
+                stResult.iErrno = fnCompute(stResult.strResult);
+            }
+            catch (std::exception& e)
+            {
+                stResult.iErrno = ERR_COMPUTE_EXCEPTION;
+                stResult.strResult = e.what();
+            }
+        }
+        std::lock_guard<std::mutex> oLock(pSink->oMutex);
+        if (pSink->bClosed)
+        {
+            return;
+        }
+        bool bNotify = pSink->vecResult.empty();   // 未处理的结果已有通知
+        pSink->vecResult.push_back(std::move(stResult));
+        if (bNotify)
+        {
+            ev_async_send(pSink->pLoop, &pSink->oWatcher);
+        }
+    };
+    if (!CComputePool::Instance().Submit(std::move(fnTask), (uint32)m_pLabor->gettid()))
+    {
+        ++m_stComputeStat.uiRejectNum;
+        LOG4_ERROR("compute pool disabled (compute_pool.thread_num = 0) or full, step seq %u.", uiStepSeq);
+        return(false);
+    }
+    ++m_stComputeStat.uiSubmitNum;
+    ++m_stComputeStat.uiInFlight;
+    if (m_stComputeStat.uiInFlight > m_stComputeStat.uiPeakInFlight)
+    {
+        m_stComputeStat.uiPeakInFlight = m_stComputeStat.uiInFlight;
+    }
+    return(true);
+}
+
+void Dispatcher::OnComputeDone()
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_pComputeSink->oMutex);
+        m_vecComputeResult.swap(m_pComputeSink->vecResult);
+    }
+    for (auto& stResult : m_vecComputeResult)
+    {
+        --m_stComputeStat.uiInFlight;
+        if (stResult.bCanceled)
+        {
+            ++m_stComputeStat.uiCancelNum;
+            continue;
+        }
+        ++m_stComputeStat.uiDoneNum;
+        m_pLabor->GetActorBuilder()->OnComputeResult(stResult.uiStepSeq, stResult.iErrno, stResult.strResult);
+    }
+    m_vecComputeResult.clear();
+}
+
+void Dispatcher::ResetComputeStat()
+{
+    m_stComputeStat.uiSubmitNum = 0;
+    m_stComputeStat.uiRejectNum = 0;
+    m_stComputeStat.uiDoneNum = 0;
+    m_stComputeStat.uiCancelNum = 0;
+    m_stComputeStat.uiPeakInFlight = m_stComputeStat.uiInFlight;
+}
+
+void Dispatcher::AddCorkChannel(std::shared_ptr<SocketChannel> pChannel)
+{
+    if (pChannel->m_bCorkPending)
+    {
+        return;
+    }
+    if (m_pCorkWatcher == nullptr)
+    {
+        m_pCorkWatcher = (ev_prepare*)malloc(sizeof(ev_prepare));
+        if (m_pCorkWatcher == nullptr)
+        {
+            LOG4_ERROR("malloc ev_prepare failed, send immediately.");
+            SendSocketChannel(pChannel);
+            return;
+        }
+        ev_prepare_init(m_pCorkWatcher, CorkCallback);
+        m_pCorkWatcher->data = (void*)this;
+    }
+    pChannel->m_bCorkPending = true;
+    m_vecCorkChannel.push_back(pChannel);
+    if (!ev_is_active(m_pCorkWatcher))
+    {
+        ev_prepare_start(m_loop, m_pCorkWatcher);
+    }
+}
+
+bool Dispatcher::FlushSocketChannel(std::shared_ptr<SocketChannel> pChannel)
+{
+    if (pChannel->m_bCorkPending)   // 从待发送列表移除，m_bCorkPending与是否在列表中保持一致
+    {
+        auto iter = std::find(m_vecCorkChannel.begin(), m_vecCorkChannel.end(), pChannel);
+        if (iter != m_vecCorkChannel.end())
+        {
+            *iter = m_vecCorkChannel.back();
+            m_vecCorkChannel.pop_back();
+        }
+        pChannel->m_bCorkPending = false;
+    }
+    return(SendSocketChannel(pChannel));
+}
+
+bool Dispatcher::SendSocketChannel(std::shared_ptr<SocketChannel> pChannel)
+{
+    if (CHANNEL_STATUS_CLOSED == pChannel->GetChannelStatus() || pChannel->IsMigrated())
+    {
+        return(false);
+    }
+    auto eCodecStatus = pChannel->Send();
+    if (CODEC_STATUS_OK == eCodecStatus)
+    {
+        CheckSendWatermark(pChannel);
+        return(true);
+    }
+    else if (CODEC_STATUS_PAUSE == eCodecStatus || CODEC_STATUS_WANT_WRITE == eCodecStatus)
+    {
+        AddIoWriteEvent(pChannel);
+        CheckSendWatermark(pChannel);
+        return(true);
+    }
+    else if (CODEC_STATUS_WANT_READ == eCodecStatus)
+    {
+        RemoveIoWriteEvent(pChannel);
+        return(true);
+    }
+    else
+    {
+        LOG4_INFO("%s channel[%d]", pChannel->GetIdentify().c_str(), pChannel->GetFd());
+        DiscardSocketChannel(pChannel);
+        return(false);
+    }
+}
+
+void Dispatcher::CheckSendWatermark(std::shared_ptr<SocketChannel> pChannel)
+{
+    uint32 uiHighWatermark = pChannel->GetSendHighWatermark();
+    if (0 == uiHighWatermark)
+    {
+        return;
+    }
+    size_t uiQueueBytes = pChannel->GetSendQueueBytes();
+    if (!pChannel->m_bReadSuspended)
+    {
+        if (uiQueueBytes >= uiHighWatermark)
+        {
+            LOG4_WARNING("%s channel[%d] send queue %u bytes reach high watermark %u, stop reading.",
+                    pChannel->GetIdentify().c_str(), pChannel->GetFd(), (uint32)uiQueueBytes, uiHighWatermark);
+            pChannel->m_bReadSuspended = true;
+            RemoveIoReadEvent(pChannel);
+            m_pLabor->GetActorBuilder()->WatermarkNotice(pChannel, true);
+        }
+    }
+    else if (uiQueueBytes <= pChannel->GetSendLowWatermark())
+    {
+        LOG4_INFO("%s channel[%d] send queue %u bytes fall to low watermark %u, resume reading.",
+                pChannel->GetIdentify().c_str(), pChannel->GetFd(), (uint32)uiQueueBytes, pChannel->GetSendLowWatermark());
+        pChannel->m_bReadSuspended = false;
+        AddIoReadEvent(pChannel);
+        m_pLabor->GetActorBuilder()->WatermarkNotice(pChannel, false);
+    }
+}
+
+void Dispatcher::FlushCorkChannel()
+{
+    std::vector<std::shared_ptr<SocketChannel>> vecCorkChannel;
+    vecCorkChannel.swap(m_vecCorkChannel);
+    for (auto& pChannel : vecCorkChannel)
+    {
+        if (!pChannel->m_bCorkPending)
+        {
+            continue;   // 已在本轮由FlushSocketChannel()立即发送
+        }
+        pChannel->m_bCorkPending = false;
+        SendSocketChannel(pChannel);
+    }
+    if (m_vecCorkChannel.empty() && m_pCorkWatcher != nullptr)
+    {
+        ev_prepare_stop(m_loop, m_pCorkWatcher);
+    }
+}
+
+void Dispatcher::FlushAsyncNotify()
+{
+    for (auto& oNotify : m_vecAsyncNotify)
+    {
+        oNotify.first->AsyncSend(oNotify.second);
+    }
+    m_vecAsyncNotify.clear();
+    if (m_pAsyncNotifyWatcher != nullptr)
+    {
+        ev_prepare_stop(m_loop, m_pAsyncNotifyWatcher);
+    }
+}
+
+void Dispatcher::FlushSpecChannelOverflow()
+{
+    for (size_t i = 0; i < m_vecSpecChannelOverflow.size();)
+    {
+        auto oOverflow = m_vecSpecChannelOverflow[i];
+        auto pChannel = std::static_pointer_cast<SpecChannelBase>(oOverflow.second->GetSocketChannel());
+        bool bFlushed = (pChannel == nullptr) || pChannel->FlushOverflow();
+        if (pChannel != nullptr)
+        {
+            AsyncSend(oOverflow.first, oOverflow.second);
+        }
+        if (bFlushed)
+        {
+            oOverflow.second->SetOverflowWatched(false);
+            m_vecSpecChannelOverflow[i] = m_vecSpecChannelOverflow.back();
+            m_vecSpecChannelOverflow.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    if (m_vecSpecChannelOverflow.empty() && m_pSpecChannelOverflowWatcher != nullptr)
+    {
+        ev_timer_stop(m_loop, m_pSpecChannelOverflowWatcher);
+    }
+}
+
+void Dispatcher::LingerZeroCopy(std::shared_ptr<SocketChannel> pChannel)
+{
+    tagZeroCopyLinger stLinger;
+    try
+    {
+        stLinger.pChain.reset(new CBufferChain());
+    }
+    catch(std::bad_alloc& e)
+    {
+        LOG4_ERROR("new CBufferChain failed, zerocopy segments of fd %d are released before completion.",
+                pChannel->GetFd());
+        return;
+    }
+    if (!pChannel->TakeZeroCopyPending(*stLinger.pChain))
+    {
+        return;
+    }
+    // 副本fd使socket在Close()之后仍然存在，需主动shutdown()以保持原有的断开语义
+    stLinger.iFd = fcntl(pChannel->GetFd(), F_DUPFD_CLOEXEC, 0);
+    if (stLinger.iFd >= 0)
+    {
+        shutdown(stLinger.iFd, SHUT_RDWR);
+        stLinger.dDeadline = ev_now(m_loop) + ZEROCOPY_LINGER_TIMEOUT;
+    }
+    else
+    {
+        LOG4_WARNING("dup fd %d failed, errno %d, hold zerocopy segments for %us.",
+                pChannel->GetFd(), errno, ZEROCOPY_LINGER_GRACE);
+        stLinger.dDeadline = ev_now(m_loop) + ZEROCOPY_LINGER_GRACE;
+    }
+    if (m_pZeroCopyLingerWatcher == nullptr)
+    {
+        m_pZeroCopyLingerWatcher = (ev_timer*)malloc(sizeof(ev_timer));
+        if (m_pZeroCopyLingerWatcher == nullptr)
+        {
+            LOG4_ERROR("malloc ev_timer failed, zerocopy segments of fd %d are released before completion.",
+                    pChannel->GetFd());
+            if (stLinger.iFd >= 0)
+            {
+                close(stLinger.iFd);
+            }
+            return;
+        }
+        ev_timer_init(m_pZeroCopyLingerWatcher, ZeroCopyLingerCallback, 0.01, 0.01);
+        m_pZeroCopyLingerWatcher->data = (void*)this;
+    }
+    m_vecZeroCopyLinger.push_back(std::move(stLinger));
+    if (!ev_is_active(m_pZeroCopyLingerWatcher))
+    {
+        ev_timer_again(m_loop, m_pZeroCopyLingerWatcher);
+    }
+}
+
+void Dispatcher::ReapZeroCopyLinger()
+{
+    ev_tstamp dNow = ev_now(m_loop);
+    for (size_t i = 0; i < m_vecZeroCopyLinger.size();)
+    {
+        tagZeroCopyLinger& stLinger = m_vecZeroCopyLinger[i];
+        if (stLinger.iFd >= 0)
+        {
+            stLinger.pChain->ReapZeroCopy(stLinger.iFd);
+        }
+        bool bDone = !stLinger.pChain->ZeroCopyPending();
+        if (!bDone && dNow >= stLinger.dDeadline)
+        {
+            if (stLinger.iFd >= 0)
+            {
+                // 对端长时间不收数据：复位连接让内核丢弃发送队列，再等待一段时间后释放
+                struct linger stLingerOpt = {1, 0};
+                setsockopt(stLinger.iFd, SOL_SOCKET, SO_LINGER, &stLingerOpt, sizeof(stLingerOpt));
+                close(stLinger.iFd);
+                stLinger.iFd = -1;
+                stLinger.dDeadline = dNow + ZEROCOPY_LINGER_GRACE;
+            }
+            else
+            {
+                bDone = true;
+            }
+        }
+        if (bDone)
+        {
+            if (stLinger.iFd >= 0)
+            {
+                close(stLinger.iFd);
+            }
+            m_vecZeroCopyLinger[i] = std::move(m_vecZeroCopyLinger.back());
+            m_vecZeroCopyLinger.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    if (m_vecZeroCopyLinger.empty() && m_pZeroCopyLingerWatcher != nullptr)
+    {
+        ev_timer_stop(m_loop, m_pZeroCopyLingerWatcher);
+    }
+}
+
+void Dispatcher::DeferChannel(std::shared_ptr<SocketChannel> pChannel)
+{
+    ++m_uiMsgBudgetHitNum;
+    if (pChannel->m_bDeferPending)
+    {
+        return;
+    }
+    if (m_pDeferWatcher == nullptr)
+    {
+        m_pDeferWatcher = (ev_idle*)malloc(sizeof(ev_idle));
+        if (m_pDeferWatcher == nullptr)
+        {
+            LOG4_ERROR("malloc ev_idle failed, the channel will be handled on next read event.");
+            return;
+        }
+        ev_idle_init(m_pDeferWatcher, DeferCallback);
+        // 空闲watcher仅在没有同等或更高优先级事件时触发，设为最高优先级保证每轮事件循环都会执行
+        ev_set_priority(m_pDeferWatcher, EV_MAXPRI);
+        m_pDeferWatcher->data = (void*)this;
+    }
+    pChannel->m_bDeferPending = true;
+    m_vecDeferredChannel.push_back(pChannel);
+    if (!ev_is_active(m_pDeferWatcher))
+    {
+        ev_idle_start(m_loop, m_pDeferWatcher);
+    }
+}
+
+void Dispatcher::HandleDeferredChannel()
+{
+    std::vector<std::shared_ptr<SocketChannel>> vecDeferredChannel;
+    vecDeferredChannel.swap(m_vecDeferredChannel);
+    for (auto& pChannel : vecDeferredChannel)
+    {
+        pChannel->m_bDeferPending = false;
+        if (CHANNEL_STATUS_CLOSED == pChannel->GetChannelStatus() || pChannel->IsMigrated())
+        {
+            continue;
+        }
+        m_pLastActivityChannel = pChannel;
+        // 与迁移过来的连接相同，只处理接收缓冲区中已有的数据，不从socket读取
+        MigrateChannelRecvAndHandle(pChannel);
+    }
+    if (m_vecDeferredChannel.empty() && m_pDeferWatcher != nullptr)
+    {
+        ev_idle_stop(m_loop, m_pDeferWatcher);
+    }
+}
+
+void Dispatcher::TimingWheelCallback(struct ev_loop* loop, ev_timer* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        Dispatcher* pDispatcher = (Dispatcher*)watcher->data;
+        pDispatcher->m_ullTimingWheelArmedTick = UINT64_MAX;
+        pDispatcher->m_oTimingWheel.Expire(GetMonotonicMicroTime() / 1000);
+        pDispatcher->ScheduleTimingWheel();
+    }
+}
+
+void Dispatcher::LoopCheckCallback(struct ev_loop* loop, ev_check* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        Dispatcher* pDispatcher = (Dispatcher*)watcher->data;
+        tagLoopStat& stStat = pDispatcher->m_stLoopStat;
+        stStat.ullIterationStart = GetMonotonicMicroTime();
+        stStat.uiIterationCallbackNum = 0;
+        stStat.ullSlowestCallback = 0;
+        stStat.szSlowestCallback = "";
+        stStat.strSlowestOwner.clear();
+        ev_tstamp dThreshold = pDispatcher->m_pLabor->GetNodeInfo().dLoopStallThreshold;
+        stStat.ullStallThreshold = (dThreshold > 0) ? (uint64)(dThreshold * 1000000) : UINT64_MAX;
+    }
+}
+
+void Dispatcher::LoopPrepareCallback(struct ev_loop* loop, ev_prepare* watcher, int revents)
+{
+    if (watcher->data != NULL)
+    {
+        ((Dispatcher*)watcher->data)->OnLoopIterationDone();
+    }
+}
+
+void Dispatcher::Destroy()
+{
+    m_vecCorkChannel.clear();
+    m_vecAsyncNotify.clear();
+    m_vecSpecChannelOverflow.clear();
+    for (auto iter = m_vecZeroCopyLinger.begin(); iter != m_vecZeroCopyLinger.end(); ++iter)
+    {
+        if (iter->iFd >= 0)
+        {
+            close(iter->iFd);
+        }
+    }
+    m_vecZeroCopyLinger.clear();
+    m_vecDeferredChannel.clear();
+    m_vecSocketChannel.clear();
+    m_uiChannelNum = 0;
+    m_mapNamedSocketChannel.clear();
+    if (m_pComputeSink != nullptr)
+    {
+        std::lock_guard<std::mutex> oLock(m_pComputeSink->oMutex);
+        m_pComputeSink->bClosed = true;
+        m_pComputeSink->vecResult.clear();
+    }
+    if (m_loop != NULL)
+    {
+        if (m_pComputeSink != nullptr)
+        {
+            ev_async_stop(m_loop, &m_pComputeSink->oWatcher);
+        }
+        if (m_pCorkWatcher != nullptr)
+        {
+            ev_prepare_stop(m_loop, m_pCorkWatcher);
+        }
+        if (m_pAsyncNotifyWatcher != nullptr)
+        {
+            ev_prepare_stop(m_loop, m_pAsyncNotifyWatcher);
+        }
+        if (m_pSpecChannelOverflowWatcher != nullptr)
+        {
+            ev_timer_stop(m_loop, m_pSpecChannelOverflowWatcher);
+        }
+        if (m_pZeroCopyLingerWatcher != nullptr)
+        {
+            ev_timer_stop(m_loop, m_pZeroCopyLingerWatcher);
+        }
+        if (m_pDeferWatcher != nullptr)
+        {
+            ev_idle_stop(m_loop, m_pDeferWatcher);
+        }
+        if (m_pTimingWheelWatcher != nullptr)
+        {
+            ev_timer_stop(m_loop, m_pTimingWheelWatcher);
+        }
+        if (m_pIoTimeoutSweepWatcher != nullptr)
+        {
+            ev_timer_stop(m_loop, m_pIoTimeoutSweepWatcher);
+        }
+        if (m_pLoopCheckWatcher != nullptr)
+        {
+            ev_check_stop(m_loop, m_pLoopCheckWatcher);
+        }
+        if (m_pLoopPrepareWatcher != nullptr)
+        {
+            ev_prepare_stop(m_loop, m_pLoopPrepareWatcher);
+        }
+        if (m_pRingWatcher != nullptr)
+        {
+            ev_io_stop(m_loop, m_pRingWatcher);
+        }
+        if (m_pRingPrepareWatcher != nullptr)
+        {
+            ev_prepare_stop(m_loop, m_pRingPrepareWatcher);
+        }
+        ev_loop_destroy(m_loop);
+        m_loop = NULL;
+    }
+    m_pComputeSink = nullptr;
+    if (m_pCorkWatcher != nullptr)
+    {
+        free(m_pCorkWatcher);
+        m_pCorkWatcher = nullptr;
+    }
+    if (m_pAsyncNotifyWatcher != nullptr)
+    {
+        free(m_pAsyncNotifyWatcher);
+        m_pAsyncNotifyWatcher = nullptr;
+    }
+    if (m_pSpecChannelOverflowWatcher != nullptr)
+    {
+        free(m_pSpecChannelOverflowWatcher);
+        m_pSpecChannelOverflowWatcher = nullptr;
+    }
+    if (m_pZeroCopyLingerWatcher != nullptr)
+    {
+        free(m_pZeroCopyLingerWatcher);
+        m_pZeroCopyLingerWatcher = nullptr;
+    }
+    if (m_pDeferWatcher != nullptr)
+    {
+        free(m_pDeferWatcher);
+        m_pDeferWatcher = nullptr;
+    }
+    if (m_pTimingWheelWatcher != nullptr)
+    {
+        free(m_pTimingWheelWatcher);
+        m_pTimingWheelWatcher = nullptr;
+    }
+    if (m_pIoTimeoutSweepWatcher != nullptr)
+    {
+        free(m_pIoTimeoutSweepWatcher);
+        m_pIoTimeoutSweepWatcher = nullptr;
+    }
+    if (m_pLoopCheckWatcher != nullptr)
+    {
+        free(m_pLoopCheckWatcher);
+        m_pLoopCheckWatcher = nullptr;
+    }
+    if (m_pLoopPrepareWatcher != nullptr)
+    {
+        free(m_pLoopPrepareWatcher);
+        m_pLoopPrepareWatcher = nullptr;
+    }
+    m_pRing = nullptr;      // 关闭环fd，内核取消未完成的请求后才释放请求持有的数据
+    m_mapRingRequest.clear();
+    for (auto iter = m_mapRingAccepted.begin(); iter != m_mapRingAccepted.end(); ++iter)
+    {
+        for (auto fd_it = iter->second.begin(); fd_it != iter->second.end(); ++fd_it)
+        {
+            close(*fd_it);
+        }
+    }
+    m_mapRingAccepted.clear();
+    if (m_pRingWatcher != nullptr)
+    {
+        free(m_pRingWatcher);
+        m_pRingWatcher = nullptr;
+    }
+    if (m_pRingPrepareWatcher != nullptr)
+    {
+        free(m_pRingPrepareWatcher);
+        m_pRingPrepareWatcher = nullptr;
+    }
+    if (m_pErrBuff != NULL)
+    {
+        free(m_pErrBuff);
+        m_pErrBuff = NULL;
+    }
+    m_pLabor = nullptr;
+}
+
+std::shared_ptr<SocketChannel> Dispatcher::CreateSocketChannel(int iFd, E_CODEC_TYPE eCodecType, bool bIsClient, bool bWithSsl)
+{
+    LOG4_TRACE("iFd %d, codec_type %d, with_ssl = %d", iFd, eCodecType, bWithSsl);
+
+    auto pExistChannel = GetChannel(iFd);
+    if (pExistChannel == nullptr)
+    {
+        auto pChannel = CodecFactory::CreateChannel(m_pLabor, m_pLogger, iFd, eCodecType, bIsClient, bWithSsl);
+        if (pChannel != nullptr)
+        {
+            InsertChannel(iFd, pChannel);
+            if (!bIsClient && m_pLabor->GetNodeInfo().iSoBusyPoll > 0)
+            {
+                SetBusyPoll(iFd, m_pLabor->GetNodeInfo().iSoBusyPoll);
+            }
+            LOG4_TRACE("new channel[%d] with codec type %d", pChannel->GetFd(), pChannel->GetCodecType());
+        }
+        return(pChannel);
+    }
+    else
+    {
+        LOG4_WARNING("fd %d is exist!", iFd);
+        return(pExistChannel);
+    }
+}
+
+bool Dispatcher::DiscardSocketChannel(std::shared_ptr<SocketChannel> pChannel, bool bChannelNotice)
+{
+    if (pChannel == nullptr)
+    {
+        LOG4_TRACE("pChannel not exist!");
+        return(false);
+    }
+
+    auto named_iter = m_mapNamedSocketChannel.find(pChannel->GetIdentify());
+    if (named_iter != m_mapNamedSocketChannel.end())
+    {
+       for (auto it = named_iter->second.begin();
+           it != named_iter->second.end(); ++it)
+       {
+           if ((*it)->GetSequence() == pChannel->GetSequence())
            {
                named_iter->second.erase(it);
                LOG4_TRACE("erase channel %d from m_mapNamedSocketChannel.", pChannel->GetFd());
@@ -932,6 +2534,7 @@ bool Dispatcher::DiscardSocketChannel(std::shared_ptr<SocketChannel> pChannel, b
        }
     }
 
+    CancelRingIo(pChannel);
     bool bCloseResult = false;
     if (pChannel->WithSsl())
     {
@@ -943,6 +2546,7 @@ bool Dispatcher::DiscardSocketChannel(std::shared_ptr<SocketChannel> pChannel, b
     }
     else
     {
+        LingerZeroCopy(pChannel);
         bCloseResult = pChannel->Close();
     }
     if (bCloseResult)
@@ -964,19 +2568,9 @@ bool Dispatcher::DiscardSocketChannel(std::shared_ptr<SocketChannel> pChannel, b
             m_pLabor->GetActorBuilder()->ChannelNotice(pChannel, pChannel->GetIdentify(), pChannel->GetClientData());
         }
         ev_io_stop (m_loop, pChannel->MutableWatcher()->MutableIoWatcher());
-        if (nullptr != pChannel->MutableWatcher()->MutableTimerWatcher())
-        {
-            ev_timer_stop (m_loop, pChannel->MutableWatcher()->MutableTimerWatcher());
-        }
         pChannel->MutableWatcher()->Reset();
 
-        auto channel_iter = m_mapSocketChannel.find(pChannel->GetFd());
-        if (channel_iter != m_mapSocketChannel.end())
-        {
-            m_mapSocketChannel.erase(channel_iter);
-            LOG4_TRACE("erase channel %d channel_seq %u from m_mapSocketChannel.",
-                    pChannel->GetFd(), pChannel->GetSequence());
-        }
+        EraseChannel(pChannel);
         return(true);
     }
     else
@@ -997,6 +2591,11 @@ bool Dispatcher::MigrateSocketChannel(uint32 uiFromLabor, uint32 uiToLabor, std:
         LOG4_ERROR("client channel can not be migrate.");
         return(false);
     }
+    if (pChannel->m_bRingIo)
+    {
+        LOG4_WARNING("channel[%d] with io_uring requests can not be migrate.", pChannel->GetFd());
+        return(false);
+    }
 
     auto named_iter = m_mapNamedSocketChannel.find(pChannel->m_pImpl->GetIdentify());
     if (named_iter != m_mapNamedSocketChannel.end())
@@ -1018,23 +2617,16 @@ bool Dispatcher::MigrateSocketChannel(uint32 uiFromLabor, uint32 uiToLabor, std:
     }
 
     ev_io_stop (m_loop, pChannel->MutableWatcher()->MutableIoWatcher());
-    if (nullptr != pChannel->MutableWatcher()->MutableTimerWatcher())
-    {
-        ev_timer_stop (m_loop, pChannel->MutableWatcher()->MutableTimerWatcher());
-    }
+    pChannel->MutableWatcher()->MutableTimer()->Cancel();
 
-    auto channel_iter = m_mapSocketChannel.find(pChannel->GetFd());
-    if (channel_iter != m_mapSocketChannel.end())
-    {
-        m_mapSocketChannel.erase(channel_iter);
-        LOG4_TRACE("erase channel %d channel_seq %u from m_mapSocketChannel.",
-                pChannel->GetFd(), pChannel->GetSequence());
-    }
+    EraseChannel(pChannel);
     LOG4_INFO("migrate channel[%d] with codec_type %d from labor %u to labor %u",
             pChannel->GetFd(), pChannel->GetCodecType(), uiFromLabor, uiToLabor);
+    int64 llBufferBytes = (int64)pChannel->GetBufferBytes();
     int iResult = SocketChannelMigrate::Write(uiFromLabor, uiToLabor, gc_uiCmdReq, m_pLabor->GetSequence(), pChannel);
     if (ERR_OK == iResult)
     {
+        CBufferPool::Instance().AddInUseBytes(-llBufferBytes);    // 迁入方在CmdChannelMigrate中计入
         return(true);
     }
     LOG4_WARNING("failed to migrate channel");
@@ -1042,7 +2634,7 @@ bool Dispatcher::MigrateSocketChannel(uint32 uiFromLabor, uint32 uiToLabor, std:
     pChannel->SetBonding(m_pLabor, GetLogger(), pChannel);
     pChannel->SetMigrated(false);
     pChannel->MutableWatcher()->Set(pChannel);
-    m_mapSocketChannel.insert(std::make_pair(pChannel->GetFd(), pChannel));
+    InsertChannel(pChannel->GetFd(), pChannel);
     ev_tstamp dIoTimeout = (m_pLabor->GetNodeInfo().dConnectionProtection > 0)
             ? m_pLabor->GetNodeInfo().dConnectionProtection : m_pLabor->GetNodeInfo().dIoTimeout;
     AddIoTimeout(pChannel, dIoTimeout);
@@ -1055,6 +2647,11 @@ bool Dispatcher::AddIoReadEvent(std::shared_ptr<SocketChannel> pChannel)
     LOG4_TRACE("fd[%d], seq[%u]", pChannel->GetFd(), pChannel->GetSequence());
     auto pWatcher = pChannel->MutableWatcher();
     pWatcher->Set(pChannel);
+    if (m_pRing != nullptr && pChannel->GetFd() >= 0
+            && (IsListenFd(pChannel->GetFd()) ? RingAccept(pChannel) : RingRecv(pChannel)))
+    {
+        return(true);
+    }
     ev_io* io_watcher = pWatcher->MutableIoWatcher();
     if (NULL == io_watcher || pChannel->GetFd() < 0)
     {
@@ -1082,6 +2679,10 @@ bool Dispatcher::AddIoWriteEvent(std::shared_ptr<SocketChannel> pChannel)
     LOG4_TRACE("%d, %u", pChannel->GetFd(), pChannel->GetSequence());
     auto pWatcher = pChannel->MutableWatcher();
     pWatcher->Set(pChannel);
+    if (pChannel->m_bRingIo && RingSend(pChannel))
+    {
+        return(true);
+    }
     ev_io* io_watcher = pWatcher->MutableIoWatcher();
     if (NULL == io_watcher || pChannel->GetFd() < 0)
     {
@@ -1122,155 +2723,152 @@ bool Dispatcher::RemoveIoWriteEvent(std::shared_ptr<SocketChannel> pChannel)
     return(true);
 }
 
-void Dispatcher::SetChannelStatus(std::shared_ptr<SocketChannel> pChannel, E_CHANNEL_STATUS eStatus)
-{
-    pChannel->SetChannelStatus(eStatus);
-}
-
-bool Dispatcher::AddClientConnFrequencyTimeout(const char* pAddr, ev_tstamp dTimeout)
+bool Dispatcher::RemoveIoReadEvent(std::shared_ptr<SocketChannel> pChannel)
 {
-    LOG4_TRACE(" ");
-    ev_timer* timeout_watcher = new ev_timer();
-    if (timeout_watcher == NULL)
+    LOG4_TRACE("%d, %u", pChannel->GetFd(), pChannel->GetSequence());
+    if (pChannel->m_ullRingRecvId != 0)
     {
-        LOG4_ERROR("new timeout_watcher error!");
-        return(false);
+        RingCancel(pChannel->m_ullRingRecvId);
+        return(true);
     }
-    tagClientConnWatcherData* pData = new tagClientConnWatcherData();
-    if (pData == NULL)
+    auto pWatcher = pChannel->MutableWatcher();
+    pWatcher->Set(pChannel);
+    ev_io* io_watcher = pWatcher->MutableIoWatcher();
+    if (NULL == io_watcher || pChannel->GetFd() < 0)
     {
-        LOG4_ERROR("new tagClientConnWatcherData error!");
-        delete timeout_watcher;
         return(false);
     }
-    ev_timer_init (timeout_watcher, ClientConnFrequencyTimeoutCallback, dTimeout + ev_time() - ev_now(m_loop), 0.);
-    pData->pDispatcher = this;
-    snprintf(pData->pAddr, gc_iAddrLen, "%s", pAddr);
-    timeout_watcher->data = (void*)pData;
-    ev_timer_start (m_loop, timeout_watcher);
+    if (EV_READ & io_watcher->events)
+    {
+        ev_io_stop(m_loop, io_watcher);
+        ev_io_set(io_watcher, io_watcher->fd, io_watcher->events & (~EV_READ));
+        ev_io_start (m_loop, io_watcher);
+    }
     return(true);
 }
 
-bool Dispatcher::AcceptFdAndTransfer(int iFd, int iFamily, int iBonding)
+void Dispatcher::SetChannelStatus(std::shared_ptr<SocketChannel> pChannel, E_CHANNEL_STATUS eStatus)
 {
-    char szClientAddr[64] = {0};
+    pChannel->SetChannelStatus(eStatus);
+}
+
+int Dispatcher::Accept(int iListenFd, int iFamily, char* szClientAddr, size_t uiClientAddrSize, int& iClientPort, bool bAddrPermit)
+{
+    // 保活及TCP_NODELAY选项已在监听fd上设置，由新连接继承；非阻塞和CLOEXEC由accept4()一并设置
+    struct sockaddr_storage stClientAddr;
+    socklen_t clientAddrSize = sizeof(stClientAddr);
     int iAcceptFd = -1;
-    int iClientPort = 0;
-    if (AF_INET == iFamily)
+    const NodeInfo& stNodeInfo = m_pLabor->GetNodeInfo();
+    bAddrPermit = bAddrPermit && stNodeInfo.iAddrPermitNum > 0 && stNodeInfo.dAddrStatInterval > 0;
+    while (true)
     {
-        struct sockaddr_in stClientAddr;
-        socklen_t clientAddrSize = sizeof(stClientAddr);
-        iAcceptFd = accept(iFd, (struct sockaddr*) &stClientAddr, &clientAddrSize);
-        if (iAcceptFd < 0)
-        {
-            LOG4_ERROR("error %d: %s", errno, strerror_r(errno, m_pErrBuff, gc_iErrBuffLen));
-            return(false);
-        }
-        int iKeepAlive = 1;
-        int iKeepIdle = 60;
-        int iKeepInterval = 5;
-        int iKeepCount = 3;
-        int iTcpNoDelay = 1;
-        if (setsockopt(iAcceptFd, SOL_SOCKET, SO_KEEPALIVE, (void*)&iKeepAlive, sizeof(iKeepAlive)) < 0)
-        {
-            LOG4_WARNING("fail to set SO_KEEPALIVE");
-        }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPIDLE, (void*) &iKeepIdle, sizeof(iKeepIdle)) < 0)
+        do
         {
-            LOG4_WARNING("fail to set SO_KEEPIDLE");
-        }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPINTVL, (void *)&iKeepInterval, sizeof(iKeepInterval)) < 0)
-        {
-            LOG4_WARNING("fail to set SO_KEEPINTVL");
-        }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPCNT, (void*)&iKeepCount, sizeof (iKeepCount)) < 0)
+            clientAddrSize = sizeof(stClientAddr);
+            iAcceptFd = AcceptFd(iListenFd, (struct sockaddr*)&stClientAddr, &clientAddrSize);
+        } while (iAcceptFd < 0 && (EINTR == errno || ECONNABORTED == errno));
+        if (iAcceptFd < 0)
         {
-            LOG4_WARNING("fail to set SO_KEEPALIVE");
+            if (EAGAIN != errno && EWOULDBLOCK != errno)
+            {
+                int iErrno = errno;
+                LOG4_ERROR("error %d: %s", iErrno, strerror_r(iErrno, m_pErrBuff, gc_iErrBuffLen));
+                errno = iErrno;
+            }
+            return(-1);
         }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_NODELAY, (void*)&iTcpNoDelay, sizeof(iTcpNoDelay)) < 0)
+        if (!bAddrPermit || m_oAddrPermit.Acquire(CTokenBucketTable::MakeKey(stClientAddr),
+                stNodeInfo.iAddrPermitNum / stNodeInfo.dAddrStatInterval, stNodeInfo.iAddrPermitNum, ev_now(m_loop)))
         {
-            LOG4_WARNING("fail to set TCP_NODELAY");
+            break;
         }
-        x_sock_set_block(iAcceptFd, 0);
-        inet_ntop(AF_INET, &stClientAddr.sin_addr, szClientAddr, sizeof(szClientAddr));
-        iClientPort = CodecUtil::N2H(stClientAddr.sin_port);
-        LOG4_TRACE("accept connect from \"%s\"", szClientAddr);
+        close(iAcceptFd);
+        LOG4_TRACE("client connection exceed addr_permit %d in %f seconds, closed.",
+                stNodeInfo.iAddrPermitNum, stNodeInfo.dAddrStatInterval);
     }
-    else    // AF_INET6
+    if (AF_INET6 == stClientAddr.ss_family)
     {
-        struct sockaddr_in6 stClientAddr;
-        socklen_t clientAddrSize = sizeof(stClientAddr);
-        iAcceptFd = accept(iFd, (struct sockaddr*) &stClientAddr, &clientAddrSize);
-        if (iAcceptFd < 0)
-        {
-            LOG4_ERROR("error %d: %s", errno, strerror_r(errno, m_pErrBuff, gc_iErrBuffLen));
-            return(false);
-        }
-        int iKeepAlive = 1;
-        int iKeepIdle = 60;
-        int iKeepInterval = 5;
-        int iKeepCount = 3;
-        int iTcpNoDelay = 1;
-        if (setsockopt(iAcceptFd, SOL_SOCKET, SO_KEEPALIVE, (void*)&iKeepAlive, sizeof(iKeepAlive)) < 0)
-        {
-            LOG4_WARNING("fail to set SO_KEEPALIVE");
-        }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPIDLE, (void*) &iKeepIdle, sizeof(iKeepIdle)) < 0)
-        {
-            LOG4_WARNING("fail to set SO_KEEPIDLE");
-        }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPINTVL, (void *)&iKeepInterval, sizeof(iKeepInterval)) < 0)
-        {
-            LOG4_WARNING("fail to set SO_KEEPINTVL");
-        }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPCNT, (void*)&iKeepCount, sizeof (iKeepCount)) < 0)
-        {
-            LOG4_WARNING("fail to set SO_KEEPALIVE");
-        }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_NODELAY, (void*)&iTcpNoDelay, sizeof(iTcpNoDelay)) < 0)
-        {
-            LOG4_WARNING("fail to set TCP_NODELAY");
-        }
-        x_sock_set_block(iAcceptFd, 0);
-        inet_ntop(AF_INET6, &stClientAddr.sin6_addr, szClientAddr, sizeof(szClientAddr));
-        iClientPort = CodecUtil::N2H(stClientAddr.sin6_port);
-        LOG4_TRACE("accept connect from \"%s\"", szClientAddr);
+        struct sockaddr_in6* pAddr = (struct sockaddr_in6*)&stClientAddr;
+        inet_ntop(AF_INET6, &pAddr->sin6_addr, szClientAddr, uiClientAddrSize);
+        iClientPort = CodecUtil::N2H(pAddr->sin6_port);
+    }
+    else    // AF_INET
+    {
+        struct sockaddr_in* pAddr = (struct sockaddr_in*)&stClientAddr;
+        inet_ntop(AF_INET, &pAddr->sin_addr, szClientAddr, uiClientAddrSize);
+        iClientPort = CodecUtil::N2H(pAddr->sin_port);
     }
+    LOG4_TRACE("accept connect from \"%s\"", szClientAddr);
+    return(iAcceptFd);
+}
 
-    auto iter = m_mapClientConnFrequency.find(std::string(szClientAddr));
-    if (iter == m_mapClientConnFrequency.end())
+int Dispatcher::AcceptFd(int iListenFd, struct sockaddr* pAddr, socklen_t* pAddrLen)
+{
+    auto iter = m_mapRingAccepted.find(iListenFd);
+    if (iter == m_mapRingAccepted.end() || (iter->second.empty() && !m_bRingAccept))
     {
-        m_mapClientConnFrequency.insert(std::make_pair(std::string(szClientAddr), 1));
-        AddClientConnFrequencyTimeout(szClientAddr, m_pLabor->GetNodeInfo().dAddrStatInterval);
+        return(accept4(iListenFd, pAddr, pAddrLen, SOCK_NONBLOCK | SOCK_CLOEXEC));
     }
-    else
+    if (iter->second.empty())
     {
-        iter->second++;
-        if (((Manager*)m_pLabor)->GetManagerInfo().iC2SListenFd > 2 && iter->second > (uint32)m_pLabor->GetNodeInfo().iAddrPermitNum)
-        {
-            LOG4_WARNING("client addr %s had been connected more than %u times in %f seconds, it's not permitted",
-                            szClientAddr, m_pLabor->GetNodeInfo().iAddrPermitNum, m_pLabor->GetNodeInfo().dAddrStatInterval);
-            close(iAcceptFd);
-            return(false);
-        }
+        errno = EAGAIN;
+        return(-1);
     }
-
-    int iWorkerId = -1;
-    switch (m_pLabor->GetNodeInfo().iConnectionDispatch)
+    int iAcceptFd = iter->second.front();
+    iter->second.pop_front();
+    if (getpeername(iAcceptFd, pAddr, pAddrLen) < 0)
     {
-        case DISPATCH_ROUND_ROBIN:
-            iWorkerId = ((Manager*)m_pLabor)->GetSessionManager()->GetDispatchWorkerId(iFd);
-            break;
-        case DISPATCH_CLIENT_ADDR_HASH:
-            iWorkerId = ((Manager*)m_pLabor)->GetSessionManager()->GetDispatchWorkerId(iFd, szClientAddr, iClientPort);
-            break;
-        default:
-            iWorkerId = ((Manager*)m_pLabor)->GetSessionManager()->GetDispatchWorkerId(iFd);
+        close(iAcceptFd);
+        errno = ECONNABORTED;   // 对端已复位，与accept4()一样跳过
+        return(-1);
     }
-    if (iWorkerId > 0)
+    return(iAcceptFd);
+}
+
+bool Dispatcher::AcceptFdAndTransfer(int iFd, int iFamily, int iBonding)
+{
+    struct tagFdBatch
+    {
+        std::string strData;
+        std::string strFdList;      ///< 本批次全部fd，接收方解析失败时据此关闭
+        std::vector<int> vecFd;
+    };
+    std::unordered_map<int, tagFdBatch> mapFdBatch;     ///< 本次接收的连接按Worker汇总后一次转交
+    uint32 uiAcceptBatch = m_pLabor->GetNodeInfo().uiAcceptBatch;
+    uint32 uiAcceptNum = 0;
+    char szClientAddr[64] = {0};
+    int iClientPort = 0;
+    int iAcceptFd = -1;
+    while (uiAcceptBatch == 0 || uiAcceptNum < uiAcceptBatch)
     {
-        MsgHead oMsgHead;
-        MsgBody oMsgBody;
+        iAcceptFd = Accept(iFd, iFamily, szClientAddr, sizeof(szClientAddr), iClientPort, true);
+        if (iAcceptFd < 0)
+        {
+            break;
+        }
+        ++uiAcceptNum;
+
+        int iWorkerId = -1;
+        switch (m_pLabor->GetNodeInfo().iConnectionDispatch)
+        {
+            case DISPATCH_ROUND_ROBIN:
+                iWorkerId = ((Manager*)m_pLabor)->GetSessionManager()->GetDispatchWorkerId(iFd);
+                break;
+            case DISPATCH_CLIENT_ADDR_HASH:
+                iWorkerId = ((Manager*)m_pLabor)->GetSessionManager()->GetDispatchWorkerId(iFd, szClientAddr, iClientPort);
+                break;
+            case DISPATCH_MIN_LOAD:
+                iWorkerId = ((Manager*)m_pLabor)->GetSessionManager()->GetMinLoadWorkerId(iFd);
+                break;
+            default:
+                iWorkerId = ((Manager*)m_pLabor)->GetSessionManager()->GetDispatchWorkerId(iFd);
+        }
+        if (iWorkerId <= 0)
+        {
+            LOG4_ERROR("no available worker");
+            close(iAcceptFd);
+            continue;
+        }
         FdTransfer oFdTransferInfo;
         std::string strFdTransferInfo;
         oFdTransferInfo.set_fd(iAcceptFd);
@@ -1279,65 +2877,136 @@ bool Dispatcher::AcceptFdAndTransfer(int iFd, int iFamily, int iBonding)
         oFdTransferInfo.set_client_port(iClientPort);
         oFdTransferInfo.set_codec_type(m_pLabor->GetNodeInfo().eCodec);
         oFdTransferInfo.SerializeToString(&strFdTransferInfo);
-        oMsgBody.set_data(strFdTransferInfo);
+        // 每个FdTransfer前加4字节（网络字节序）长度
+        uint32 uiLength = CodecUtil::H2N((uint32)strFdTransferInfo.size());
+        tagFdBatch& stBatch = mapFdBatch[iWorkerId];
+        stBatch.strData.append((const char*)&uiLength, sizeof(uiLength));
+        stBatch.strData.append(strFdTransferInfo);
+        uint32 uiFd = CodecUtil::H2N((uint32)iAcceptFd);
+        stBatch.strFdList.append((const char*)&uiFd, sizeof(uiFd));
+        stBatch.vecFd.push_back(iAcceptFd);
+    }
+
+    uint32 uiManagerLaborId = m_pLabor->GetNodeInfo().uiWorkerNum + 1;
+    for (auto it = mapFdBatch.begin(); it != mapFdBatch.end(); ++it)
+    {
+        MsgHead oMsgHead;
+        MsgBody oMsgBody;
+        oMsgBody.set_data(std::move(it->second.strData));
+        oMsgBody.set_add_on(std::move(it->second.strFdList));
         oMsgHead.set_cmd(CMD_REQ_FD_TRANSFER);
-        uint32 uiManagerLaborId = m_pLabor->GetNodeInfo().uiWorkerNum + 1;
-        LOG4_INFO("transfer fd %d from labor %u to labor %u", iAcceptFd, uiManagerLaborId, iWorkerId);
-        int iResult = CodecNebulaInNode::Write(uiManagerLaborId, iWorkerId, gc_uiCmdReq, m_pLabor->GetSequence(), oMsgHead, oMsgBody);
-        if (ERR_OK == iResult)
+        LOG4_INFO("transfer %u fd from labor %u to labor %d", (uint32)it->second.vecFd.size(), uiManagerLaborId, it->first);
+        int iResult = CodecNebulaInNode::Write(uiManagerLaborId, it->first, gc_uiCmdReq, m_pLabor->GetSequence(), oMsgHead, oMsgBody);
+        if (ERR_OK != iResult)
         {
-            return(true);
-        }
-        else
-        {
-            LOG4_ERROR("transfer fd %d to worker %d error %d", iAcceptFd, iWorkerId, iResult);
-            return(false);
+            LOG4_ERROR("transfer %u fd to worker %d error %d", (uint32)it->second.vecFd.size(), it->first, iResult);
+            for (auto fd_it = it->second.vecFd.begin(); fd_it != it->second.vecFd.end(); ++fd_it)
+            {
+                close(*fd_it);
+            }
         }
     }
-    LOG4_ERROR("no available worker");
-    close(iAcceptFd);
-    return(false);
+    return(uiAcceptNum > 0);
 }
 
-bool Dispatcher::AcceptServerConn(int iFd)
+bool Dispatcher::AttachReusePortCpuBpf(int iFd, uint32 uiGroupSize)
 {
-    struct sockaddr_in stClientAddr;
-    socklen_t clientAddrSize = sizeof(stClientAddr);
-    int iAcceptFd = accept(iFd, (struct sockaddr*) &stClientAddr, &clientAddrSize);
-    if (iAcceptFd < 0)
+    if (uiGroupSize == 0)
     {
-        LOG4_ERROR("error %d: %s", errno, strerror_r(errno, m_pErrBuff, gc_iErrBuffLen));
         return(false);
     }
-    else
+    // 监听socket按Worker序号加入reuseport组，Worker i绑定在CPU i上（cpu_affinity），
+    // 故收到SYN的CPU c对应组内序号(c + N - 1) % N
+    struct sock_filter astCode[] = {
+        { BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32)(SKF_AD_OFF + SKF_AD_CPU) },
+        { BPF_ALU | BPF_ADD | BPF_K, 0, 0, uiGroupSize - 1 },
+        { BPF_ALU | BPF_MOD | BPF_K, 0, 0, uiGroupSize },
+        { BPF_RET | BPF_A, 0, 0, 0 },
+    };
+    struct sock_fprog stProg;
+    stProg.len = sizeof(astCode) / sizeof(astCode[0]);
+    stProg.filter = astCode;
+    if (-1 == ::setsockopt(iFd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &stProg, sizeof(stProg)))
+    {
+        LOG4_WARNING("SO_ATTACH_REUSEPORT_CBPF error %d: %s", errno, strerror_r(errno, m_pErrBuff, gc_iErrBuffLen));
+        return(false);
+    }
+    return(true);
+}
+
+bool Dispatcher::AcceptClientConn(int iFd, int iFamily)
+{
+    uint32 uiAcceptBatch = m_pLabor->GetNodeInfo().uiAcceptBatch;
+    uint32 uiAcceptNum = 0;
+    char szClientAddr[64] = {0};
+    int iClientPort = 0;
+    int iAcceptFd = -1;
+    while (uiAcceptBatch == 0 || uiAcceptNum < uiAcceptBatch)
     {
-        /* tcp连接检测 */
-        int iKeepAlive = 1;
-        int iKeepIdle = 60;
-        int iKeepInterval = 5;
-        int iKeepCount = 3;
-        int iTcpNoDelay = 1;
-        if (setsockopt(iAcceptFd, SOL_SOCKET, SO_KEEPALIVE, (void*)&iKeepAlive, sizeof(iKeepAlive)) < 0)
+        iAcceptFd = Accept(iFd, iFamily, szClientAddr, sizeof(szClientAddr), iClientPort, true);
+        if (iAcceptFd < 0)
+        {
+            break;
+        }
+        ++uiAcceptNum;
+
+        E_CODEC_TYPE eCodec = m_pLabor->GetNodeInfo().eCodec;
+        std::shared_ptr<SocketChannel> pNewChannel = nullptr;
+        if ((CODEC_NEBULA != eCodec) && (CODEC_NEBULA_IN_NODE != eCodec) && m_pLabor->WithSsl())
+        {
+            pNewChannel = CreateSocketChannel(iAcceptFd, eCodec, false, true);
+        }
+        else
         {
-            LOG4_WARNING("fail to set SO_KEEPALIVE");
+            pNewChannel = CreateSocketChannel(iAcceptFd, eCodec, false, false);
         }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPIDLE, (void*) &iKeepIdle, sizeof(iKeepIdle)) < 0)
+        if (nullptr == pNewChannel)     // 没有足够资源分配给新连接，直接close掉
         {
-            LOG4_WARNING("fail to set SO_KEEPIDLE");
+            close(iAcceptFd);
+            continue;
         }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPINTVL, (void *)&iKeepInterval, sizeof(iKeepInterval)) < 0)
+        pNewChannel->SetRemoteAddr(szClientAddr);
+        AddIoReadEvent(pNewChannel);
+        if (CODEC_NEBULA == eCodec)
         {
-            LOG4_WARNING("fail to set SO_KEEPINTVL");
+            AddIoTimeout(pNewChannel, m_pLabor->GetNodeInfo().dIoTimeout);
+            pNewChannel->SetKeepAlive(m_pLabor->GetNodeInfo().dIoTimeout);
+            std::shared_ptr<Step> pStepTellWorker
+                = m_pLabor->GetActorBuilder()->MakeSharedStep(nullptr, "neb::StepTellWorker", pNewChannel);
+            if (nullptr != pStepTellWorker)
+            {
+                pStepTellWorker->Emit(ERR_OK);
+            }
         }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_KEEPCNT, (void*)&iKeepCount, sizeof (iKeepCount)) < 0)
+        else
         {
-            LOG4_WARNING("fail to set SO_KEEPALIVE");
+            pNewChannel->SetChannelStatus(CHANNEL_STATUS_ESTABLISHED);
+            ev_tstamp dIoTimeout = (m_pLabor->GetNodeInfo().dConnectionProtection > 0)
+                    ? m_pLabor->GetNodeInfo().dConnectionProtection : m_pLabor->GetNodeInfo().dIoTimeout;
+            AddIoTimeout(pNewChannel, dIoTimeout);
+            pNewChannel->SetKeepAlive(dIoTimeout);
         }
-        if (setsockopt(iAcceptFd, IPPROTO_TCP, TCP_NODELAY, (void*)&iTcpNoDelay, sizeof(iTcpNoDelay)) < 0)
+        m_pLabor->IoStatAddConnection(IO_STAT_DOWNSTREAM_NEW_CONNECTION);
+    }
+    return(uiAcceptNum > 0);
+}
+
+bool Dispatcher::AcceptServerConn(int iFd)
+{
+    uint32 uiAcceptBatch = m_pLabor->GetNodeInfo().uiAcceptBatch;
+    uint32 uiAcceptNum = 0;
+    char szClientAddr[64] = {0};
+    int iClientPort = 0;
+    int iAcceptFd = -1;
+    while (uiAcceptBatch == 0 || uiAcceptNum < uiAcceptBatch)
+    {
+        iAcceptFd = Accept(iFd, ((Manager*)m_pLabor)->GetManagerInfo().iS2SFamily,
+                szClientAddr, sizeof(szClientAddr), iClientPort);
+        if (iAcceptFd < 0)
         {
-            LOG4_WARNING("fail to set TCP_NODELAY");
+            break;
         }
-        x_sock_set_block(iAcceptFd, 0);
+        ++uiAcceptNum;
         std::shared_ptr<SocketChannel> pChannel = CreateSocketChannel(iAcceptFd, CODEC_NEBULA);
         if (NULL != pChannel)
         {
@@ -1347,8 +3016,12 @@ bool Dispatcher::AcceptServerConn(int iFd)
             AddIoReadEvent(pChannel);
             m_pLabor->IoStatAddConnection(IO_STAT_DOWNSTREAM_NEW_CONNECTION);
         }
+        else
+        {
+            close(iAcceptFd);
+        }
     }
-    return(false);
+    return(uiAcceptNum > 0);
 }
 
 bool Dispatcher::PingChannel(std::shared_ptr<SocketChannel> pChannel)
@@ -1388,8 +3061,31 @@ void Dispatcher::CheckFailedNode()
     }
 }
 
+bool Dispatcher::MsgPermit(uint64 ullUin)
+{
+    const NodeInfo& stNodeInfo = m_pLabor->GetNodeInfo();
+    if (stNodeInfo.iMsgPermitNum <= 0 || stNodeInfo.dMsgStatInterval <= 0)
+    {
+        return(true);
+    }
+    return(m_oMsgPermit.Acquire(CTokenBucketTable::MakeKey(ullUin),
+            stNodeInfo.iMsgPermitNum / stNodeInfo.dMsgStatInterval, stNodeInfo.iMsgPermitNum, ev_now(m_loop)));
+}
+
+void Dispatcher::SetBusyPoll(int iFd, int iBusyPoll)
+{
+#ifdef SO_BUSY_POLL
+    if (setsockopt(iFd, SOL_SOCKET, SO_BUSY_POLL, &iBusyPoll, sizeof(iBusyPoll)) < 0)
+    {
+        // 超过net.core.busy_read需要CAP_NET_ADMIN
+        LOG4_WARNING("fd %d setsockopt SO_BUSY_POLL %d failed, errno %d", iFd, iBusyPoll, errno);
+    }
+#endif
+}
+
 void Dispatcher::EvBreak()
 {
+    m_bLoopBreak = true;
     ev_break (m_loop, EVBREAK_ALL);
 }
 
@@ -18,6 +18,7 @@ extern "C" {
 #include <stdlib.h>
 #include <netdb.h>
 #include <errno.h>
+#include <time.h>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
@@ -43,10 +44,19 @@ extern "C" {
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+#include <deque>
 #include <sstream>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
 
 #include "util/process_helper.h"
+#include "util/CTimingWheel.hpp"
+#include "util/CTokenBucketTable.hpp"
+#include "util/CBufferChain.hpp"
+#include "util/CIoUring.hpp"
 #include "pb/msg.pb.h"
 #include "labor/Labor.hpp"
 #include "channel/SocketChannel.hpp"
@@ -65,7 +75,7 @@ class LoadStress;  // not in Nebula project
 class Actor;
 class ActorBuilder;
 class CmdFdTransfer;
-struct tagClientConnWatcherData;
+class SpecChannelWatcher;
 template<typename T> class IO;
 
 typedef void (*signal_callback)(struct ev_loop*,ev_signal*,int);
@@ -77,26 +87,48 @@ enum E_DISPATCHER
 {
     DISPATCH_ROUND_ROBIN = 0,
     DISPATCH_CLIENT_ADDR_HASH = 1,
+    DISPATCH_MIN_LOAD = 2,          ///< 从两个随机Worker中选负载较低者
 };
 
 class Dispatcher
 {
 public:
-    struct tagClientConnWatcherData
+    static const uint32 LOOP_LAG_BUCKET_NUM = 7;
+    static const uint32 LOOP_LAG_BUCKET[LOOP_LAG_BUCKET_NUM];     ///< 迭代耗时分布上界（毫秒），最后一个为无上界
+
+    struct tagSlowCallback
     {
-        char* pAddr;
-        Dispatcher* pDispatcher;     // 不在结构体析构时回收
+        uint32 uiNum = 0;                               ///< 耗时超过阈值的次数
+        uint64 ullMaxTime = 0;                          ///< 最长耗时（微秒）
+    };
 
-        tagClientConnWatcherData() : pAddr(NULL), pDispatcher(nullptr)
-        {
-            pAddr = (char*)malloc(gc_iAddrLen);
-        }
+    struct tagLoopStat
+    {
+        uint64 ullIterationNum = 0;
+        uint64 ullCallbackNum = 0;
+        uint64 ullMaxIteration = 0;                     ///< 最长的一次迭代耗时（微秒）
+        uint32 uiStallNum = 0;                          ///< 耗时超过阈值的迭代数
+        uint32 auiLagHistogram[LOOP_LAG_BUCKET_NUM] = {0};
+        uint64 ullSpinTime = 0;                         ///< 低延迟模式下自旋轮询未取到事件的时间（微秒）
+        uint64 ullSleepTime = 0;                        ///< 低延迟模式下阻塞等待事件的时间（微秒）
+        std::unordered_map<std::string, tagSlowCallback> mapSlowCallback;  ///< 超过阈值的回调，按“回调 编解码类型/Actor类名”分类
+        // 当前迭代
+        uint64 ullIterationStart = 0;
+        uint64 ullStallThreshold = UINT64_MAX;          ///< 卡顿阈值（微秒）
+        uint32 uiIterationCallbackNum = 0;
+        uint64 ullSlowestCallback = 0;
+        const char* szSlowestCallback = "";
+        std::string strSlowestOwner;                    ///< 最慢回调的编解码类型或Actor类名
+    };
 
-        ~tagClientConnWatcherData()
-        {
-            free(pAddr);
-            pAddr = nullptr;
-        }
+    struct tagComputeStat
+    {
+        uint32 uiSubmitNum = 0;
+        uint32 uiRejectNum = 0;                         ///< 线程池未启用或排队已满
+        uint32 uiDoneNum = 0;
+        uint32 uiCancelNum = 0;                         ///< Step已结束，未执行的任务
+        uint32 uiInFlight = 0;                          ///< 已提交未回调的任务数
+        uint32 uiPeakInFlight = 0;
     };
 
     Dispatcher(Labor* pLabor, std::shared_ptr<NetLogger> pLogger);
@@ -105,23 +137,39 @@ public:
 
 public:
     static void IoCallback(struct ev_loop* loop, struct ev_io* watcher, int revents);
-    static void IoTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
+    static void IoTimeoutCallback(void* pData);
+    static void IoTimeoutSweepCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
     static void PeriodicTaskCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
     static void SignalCallback(struct ev_loop* loop, struct ev_signal* watcher, int revents);
     static void AsyncCallback(struct ev_loop* loop, struct ev_async* watcher, int revents);
-    static void ClientConnFrequencyTimeoutCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
+    static void CorkCallback(struct ev_loop* loop, ev_prepare* watcher, int revents);
+    static void AsyncNotifyCallback(struct ev_loop* loop, ev_prepare* watcher, int revents);
+    static void SpecChannelOverflowCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
+    static void ZeroCopyLingerCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
+    static void ComputeDoneCallback(struct ev_loop* loop, struct ev_async* watcher, int revents);
+    static void DeferCallback(struct ev_loop* loop, ev_idle* watcher, int revents);
+    static void TimingWheelCallback(struct ev_loop* loop, ev_timer* watcher, int revents);
+    static void LoopCheckCallback(struct ev_loop* loop, ev_check* watcher, int revents);
+    static void LoopPrepareCallback(struct ev_loop* loop, ev_prepare* watcher, int revents);
+    static void RingCallback(struct ev_loop* loop, struct ev_io* watcher, int revents);
+    static void RingPrepareCallback(struct ev_loop* loop, ev_prepare* watcher, int revents);
 
     bool OnIoRead(std::shared_ptr<SocketChannel> pChannel);
     bool OnIoWrite(std::shared_ptr<SocketChannel> pChannel);
     bool OnIoError(std::shared_ptr<SocketChannel> pChannel);
     bool OnIoTimeout(std::shared_ptr<SocketChannel> pChannel);
-    bool OnClientConnFrequencyTimeout(tagClientConnWatcherData* pData, ev_timer* watcher);
     bool DataRecvAndHandle(std::shared_ptr<SocketChannel> pChannel);
     bool MigrateChannelRecvAndHandle(std::shared_ptr<SocketChannel> pChannel);
 
     template <typename ...Targs>
     void Logger(int iLogLevel, const char* szFileName, unsigned int uiFileLine, const char* szFunction, Targs&&... args);
 
+    /**
+     * @brief 运行事件循环
+     * @note 配置了低延迟模式（NodeInfo::uiBusyPollSpin）时，阻塞等待前先以非阻塞方式自旋轮询，
+     *       自旋期间取到事件则继续自旋；自旋未取到事件且随后阻塞等待超过自旋时长时自旋时长减半，
+     *       阻塞等待短于配置的自旋时长时加倍，空闲时退避到直接阻塞等待。
+     */
     void EventRun();
 
 public:
@@ -170,16 +218,95 @@ public:
      * 确保不再有来自迁出线程的响应包发送到迁出的socket channel，否则该响应将无法送达。
      */
     bool MigrateSocketChannel(uint32 uiFromLabor, uint32 uiToLabor, std::shared_ptr<SocketChannel> pChannel);
-    bool CreateListenFd(const std::string& strHost, int32 iPort, int iBacklog, int& iFd, int& iFamily);
+    bool CreateListenFd(const std::string& strHost, int32 iPort, int iBacklog, int& iFd, int& iFamily, bool bReusePort = false);
+    /**
+     * @brief 为reuseport组挂载按CPU选择监听socket的BPF程序，使连接由处理其SYN的CPU上的Worker接收
+     */
+    bool AttachReusePortCpuBpf(int iFd, uint32 uiGroupSize);
     std::shared_ptr<SocketChannel> GetChannel(int iFd);
     void AddChannelToLoop(std::shared_ptr<SocketChannel> pChannel);
     void AsyncSend(ev_async* pWatcher);
 
+    /**
+     * @brief 通知pToDispatcher读取SpecChannel（由写入方所在Dispatcher调用）
+     * @note 仅在消费方未被通知过（SpecChannel由空变为非空）时产生通知，通知合并到本轮事件循环
+     *       结束前统一发出，同一轮写入的多条消息只唤醒消费方一次。SpecChannel溢出队列非空时，
+     *       由本Dispatcher每毫秒尝试把溢出消息写入环形队列，直到溢出队列清空
+     */
+    void AsyncSend(Dispatcher* pToDispatcher, SpecChannelWatcher* pWatcher);
+
+    /**
+     * @brief 把计算任务提交到计算线程池，完成后在本Dispatcher回调ActorBuilder::OnComputeResult()
+     * @note 计算线程把结果放入本Dispatcher的完成队列，完成队列由空变为非空时ev_async_send()
+     *       唤醒本事件循环。pCanceled为true时任务不再执行，只回传取消结果
+     */
+    bool AsyncCompute(uint32 uiStepSeq, std::function<int32(std::string&)>&& fnCompute,
+            std::shared_ptr<std::atomic<bool>> pCanceled);
+
+    /**
+     * @brief 把合并发送连接加入待发送列表，在本轮事件循环结束前统一发送
+     */
+    void AddCorkChannel(std::shared_ptr<SocketChannel> pChannel);
+    /**
+     * @brief 立即发送连接发送队列中的数据（合并发送连接的“立即发送”）
+     */
+    bool FlushSocketChannel(std::shared_ptr<SocketChannel> pChannel);
+    /**
+     * @brief 检查连接待发送数据水位
+     * @note 超过高水位时停止从该连接读取并通知业务层（CMD_REQ_CHANNEL_WATERMARK），降到低水位时恢复读取并通知
+     */
+    void CheckSendWatermark(std::shared_ptr<SocketChannel> pChannel);
+    /**
+     * @brief 连接消息处理预算用尽，把接收缓冲区中剩余消息的处理延后到下一轮事件循环
+     */
+    void DeferChannel(std::shared_ptr<SocketChannel> pChannel);
+
+    /**
+     * @brief 按permission.uin_permit检查用户消息频率（令牌桶，stat_interval内平均permit_num条）
+     * @return 未配置限制或未超过限制返回true
+     */
+    bool MsgPermit(uint64 ullUin);
+
+    /**
+     * @brief 事件循环回调耗时统计：回调开始时取GetCoarseMicroTime()，结束时调用LoopCallbackDone()
+     * @note 使用CLOCK_MONOTONIC_COARSE（vDSO，无系统调用），精度为一个时钟节拍（1~4毫秒），
+     *       足以发现百毫秒级的卡顿，常开的开销为每个回调两次读时钟和一次比较。
+     */
+    static uint64 GetCoarseMicroTime()
+    {
+        struct timespec stTime;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &stTime);
+        return((uint64)stTime.tv_sec * 1000000 + stTime.tv_nsec / 1000);
+    }
+    static uint64 GetMonotonicMicroTime()
+    {
+        struct timespec stTime;
+        clock_gettime(CLOCK_MONOTONIC, &stTime);
+        return((uint64)stTime.tv_sec * 1000000 + stTime.tv_nsec / 1000);
+    }
+    template <typename T>
+    void LoopCallbackDone(const char* szCallback, uint64 ullStartTime, T* pObject)
+    {
+        uint64 ullElapsed = GetCoarseMicroTime() - ullStartTime;
+        ++m_stLoopStat.uiIterationCallbackNum;
+        if (ullElapsed > m_stLoopStat.ullSlowestCallback)   // 粗粒度时钟下绝大多数回调耗时为0，极少进入
+        {
+            m_stLoopStat.ullSlowestCallback = ullElapsed;
+            m_stLoopStat.szSlowestCallback = szCallback;
+            m_stLoopStat.strSlowestOwner = GetCallbackOwner(pObject);
+        }
+        if (ullElapsed >= m_stLoopStat.ullStallThreshold)
+        {
+            OnSlowCallback(szCallback, ullElapsed, pObject);
+        }
+    }
+
 protected:
     void Destroy();
     bool AddIoReadEvent(std::shared_ptr<SocketChannel> pChannel);
     bool AddIoWriteEvent(std::shared_ptr<SocketChannel> pChannel);
     bool RemoveIoWriteEvent(std::shared_ptr<SocketChannel> pChannel);
+    bool RemoveIoReadEvent(std::shared_ptr<SocketChannel> pChannel);
     bool AddEvent(ev_signal* signal_watcher, signal_callback pFunc, int iSignum);
     bool AddEvent(ev_timer* timer_watcher, timer_callback pFunc, ev_tstamp dTimeout);
     bool AddEvent(ev_idle* idle_watcher, idle_callback pFunc);
@@ -187,32 +314,226 @@ protected:
     bool RefreshEvent(ev_timer* timer_watcher, ev_tstamp dTimeout);
     bool DelEvent(ev_io* io_watcher);
     bool DelEvent(ev_timer* timer_watcher);
+    /**
+     * @brief 在时间轮上添加（或刷新）dTimeout秒后到期的定时器
+     * @note 用于Step、Session、Chain等数量多且频繁刷新的超时，所有定时器共用一个ev_timer
+     */
+    bool AddTimer(CTimingWheel::tagTimer* pTimer, CTimingWheel::timeout_callback pFunc, ev_tstamp dTimeout);
+    bool RefreshTimer(CTimingWheel::tagTimer* pTimer, ev_tstamp dTimeout);
+    bool DelTimer(CTimingWheel::tagTimer* pTimer);
     int32 GetConnectionNum() const;
+    bool InsertChannel(int iFd, std::shared_ptr<SocketChannel> pChannel);
+    void EraseChannel(std::shared_ptr<SocketChannel> pChannel);     ///< fd上已是其他连接时不删除
+    uint32 GetLoopIteration() const
+    {
+        return(ev_iteration(m_loop));
+    }
+    uint32 GetBufferReclaimNum() const
+    {
+        return(m_uiBufferReclaimNum);
+    }
+    void ResetBufferReclaimNum()
+    {
+        m_uiBufferReclaimNum = 0;
+    }
+    uint32 GetMsgBudgetHitNum() const
+    {
+        return(m_uiMsgBudgetHitNum);
+    }
+    void ResetMsgBudgetHitNum()
+    {
+        m_uiMsgBudgetHitNum = 0;
+    }
+    void GetSendQueueStat(uint64& ullTotalBytes, uint64& ullMaxBytes, uint32& uiReadSuspendedNum) const;
+    void ResetUnitTimeMsgNum();         ///< 开始新的连接消息数统计周期
+    /**
+     * @brief 选取可迁移的接收消息最多的连接（每秒消息数在[dMinMsgRate, dMaxMsgRate)之间）
+     * @note 只选取已建立、无待响应请求且业务已开启自动迁移的服务端连接。每秒消息数按上次
+     *       选取以来的消息数计算，选取后开始新的统计周期
+     */
+    std::shared_ptr<SocketChannel> GetRebalanceChannel(double dMinMsgRate, double dMaxMsgRate);
     void SetChannelStatus(std::shared_ptr<SocketChannel> pChannel, E_CHANNEL_STATUS eStatus);
-    bool AddClientConnFrequencyTimeout(const char* pAddr, ev_tstamp dTimeout = 60.0);
+    /**
+     * @brief 接收一个连接
+     * @note bAddrPermit为true时按permission.addr_permit检查客户端地址，超过限制的连接在分配
+     *       SocketChannel之前直接关闭并继续接收下一个
+     */
+    int Accept(int iListenFd, int iFamily, char* szClientAddr, size_t uiClientAddrSize, int& iClientPort, bool bAddrPermit = false);
     bool AcceptFdAndTransfer(int iFd, int iFamily = AF_INET, int iBonding = 0);
+    bool AcceptClientConn(int iFd, int iFamily);    ///< reuseport模式下Worker直接接收客户端连接
     bool AcceptServerConn(int iFd);
     bool PingChannel(std::shared_ptr<SocketChannel> pChannel);
     void CheckFailedNode();
+    void FlushCorkChannel();
+    bool SendSocketChannel(std::shared_ptr<SocketChannel> pChannel);
+    void FlushAsyncNotify();
+    void FlushSpecChannelOverflow();
+
+    /**
+     * @brief 连接关闭前接管仍被内核零拷贝引用的发送段
+     * @note 以socket副本fd继续读取完成通知，全部确认（或超时复位连接）后才释放存储空间
+     */
+    void LingerZeroCopy(std::shared_ptr<SocketChannel> pChannel);
+    void ReapZeroCopyLinger();
+    void OnComputeDone();
+    const tagComputeStat& GetComputeStat() const
+    {
+        return(m_stComputeStat);
+    }
+    void ResetComputeStat();
+    void HandleDeferredChannel();
+    void ScheduleTimingWheel();         ///< 按时间轮下一个到期时间设置ev_timer
+    static std::string GetCallbackOwner(SocketChannel* pChannel);  ///< "codec N"
+    static std::string GetCallbackOwner(Actor* pActor);            ///< Actor类名
+    void OnSlowCallback(const char* szCallback, uint64 ullElapsed, SocketChannel* pChannel);
+    void OnSlowCallback(const char* szCallback, uint64 ullElapsed, Actor* pActor);
+    void AddSlowCallback(const char* szCallback, const std::string& strOwner, uint64 ullElapsed);
+    void OnLoopIterationDone();
+    /**
+     * @brief 获取事件循环统计（每次迭代处理耗时的分布等），auiLagHistogram[i]为耗时不超过LOOP_LAG_BUCKET[i]毫秒的迭代数
+     */
+    const tagLoopStat& GetLoopStat() const
+    {
+        return(m_stLoopStat);
+    }
+    void ResetLoopStat();
+    void SetBusyPoll(int iFd, int iBusyPoll);
     void EvBreak();
+    /**
+     * @brief 按配置的后端创建事件循环，后端不可用（libev未编译或内核不支持）时退回libev默认后端
+     */
+    bool NewLoop(const std::string& strIoBackend);
+    static const char* IoBackendName(unsigned int uiBackend);
+
+    /**
+     * @brief 创建io_uring，环fd加入事件循环（完成事件由RingCallback处理），请求在每次poll前提交
+     * @note 内核不支持io_uring或缓冲区环时返回false，所有IO仍走libev
+     */
+    bool InitRing();
+    bool IsListenFd(int iFd) const;
+    bool RingAccept(std::shared_ptr<SocketChannel> pChannel);   ///< 监听fd提交多次完成的accept
+    bool RingRecv(std::shared_ptr<SocketChannel> pChannel);     ///< 服务端非SSL连接提交多次完成的recv
+    bool RingSend(std::shared_ptr<SocketChannel> pChannel);     ///< 不等待可写，把队首数据交给io_uring发送
+    void RingCancel(uint64 ullRequestId);
+    void CancelRingIo(std::shared_ptr<SocketChannel> pChannel); ///< 连接关闭前取消其io_uring请求
+    void ReapRing();
+    void OnRingAccept(uint64 ullRequestId, const CIoUring::tagCompletion& stCompletion);
+    void OnRingRecv(uint64 ullRequestId, const CIoUring::tagCompletion& stCompletion);
+    void OnRingSend(uint64 ullRequestId, const CIoUring::tagCompletion& stCompletion);
+    void FlushRingAccepted();           ///< 对有已接受连接的监听fd调用OnIoRead()
+    int AcceptFd(int iListenFd, struct sockaddr* pAddr, socklen_t* pAddrLen);  ///< 优先取io_uring已接受的连接
+    void SubmitRing();
 
 private:
+    struct tagComputeResult
+    {
+        uint32 uiStepSeq = 0;
+        int32 iErrno = 0;
+        bool bCanceled = false;
+        std::string strResult;
+    };
+
+    /**
+     * @brief 计算结果完成队列，由Dispatcher和已提交的计算任务共同持有
+     * @note Dispatcher销毁时置bClosed，之后完成的任务丢弃结果，不再访问事件循环
+     */
+    struct tagComputeSink
+    {
+        std::mutex oMutex;
+        bool bClosed = false;
+        struct ev_loop* pLoop = nullptr;
+        ev_async oWatcher;
+        std::vector<tagComputeResult> vecResult;
+    };
+
+    /**
+     * @brief 已关闭连接上等待内核零拷贝完成通知的发送段
+     */
+    struct tagZeroCopyLinger
+    {
+        int iFd = -1;                           ///< socket的副本fd，-1表示复制失败或已复位关闭
+        ev_tstamp dDeadline = 0.0;              ///< 超过此时间未全部确认则复位连接
+        std::unique_ptr<CBufferChain> pChain;
+    };
+
+    /**
+     * @brief 已提交给io_uring的请求
+     */
+    struct tagRingRequest
+    {
+        uint8 ucType = 0;                       ///< RING_ACCEPT、RING_RECV、RING_SEND
+        bool bCanceled = false;                 ///< 已提交取消
+        bool bRearm = false;                    ///< 取消后又恢复了读，请求终止时重新提交
+        int iFd = -1;
+        std::weak_ptr<SocketChannel> pChannel;
+        std::shared_ptr<SocketChannel> pSendChannel;    ///< send请求持有连接，被引用的发送段在完成前不会随连接释放
+        struct msghdr stSendMsg;                        ///< send请求的msghdr，指向stSendIov
+        struct iovec stSendIov[CBufferChain::MAX_IOV];  ///< 直接指向连接发送队列队首的段
+    };
+
+    static const uint8 RING_ACCEPT = 1;
+    static const uint8 RING_RECV = 2;
+    static const uint8 RING_SEND = 3;
+    static const uint32 RING_REAP_BATCH = 256;                  ///< 每次RingCallback最多处理的完成事件数
+    static const size_t MAX_CHANNEL_TABLE_RESERVE = 1 << 20;   ///< 连接表按RLIMIT_NOFILE预留的上限
+    static const uint32 BUSY_POLL_MIN_SPIN = 8;                 ///< 低延迟模式从直接阻塞恢复自旋时的自旋时长（微秒）
+    static const uint32 ZEROCOPY_LINGER_TIMEOUT = 10;           ///< 已关闭连接等待零拷贝完成通知的时长（秒）
+    static const uint32 ZEROCOPY_LINGER_GRACE = 1;              ///< 复位连接后释放零拷贝段前的等待时长（秒）
+
     char* m_pErrBuff;
     Labor* m_pLabor;
     struct ev_loop* m_loop;
     time_t m_lLastCheckNodeTime;
+    ev_tstamp m_dUnitTimeStart;                             ///< 本统计周期开始时间（连接单位时间消息数）
+    uint32 m_uiBufferReclaimNum;                            ///< 空闲连接缓冲区释放次数
+    uint32 m_uiMsgBudgetHitNum;                             ///< 连接消息处理预算用尽次数
     std::shared_ptr<NetLogger> m_pLogger;
     std::unique_ptr<Nodes> m_pSessionNode;
     std::shared_ptr<SocketChannel> m_pLastActivityChannel;  // 最近一个发送或接收过数据的channel
 
     // Channel
-    std::unordered_map<int32, std::shared_ptr<SocketChannel> > m_mapSocketChannel;
+    std::vector<std::shared_ptr<SocketChannel> > m_vecSocketChannel;   ///< 下标为fd，按需增长
+    uint32 m_uiChannelNum;
 
     /* named Channel */
     std::unordered_map<std::string, std::unordered_set<std::shared_ptr<SocketChannel> > > m_mapNamedSocketChannel;      ///< key为Identify，连接存在时，if(http连接)set.size()>=1;else set.size()==1;
     std::unordered_map<int32, std::string> m_mapChannelPingStepName;   // CODEC_TYPE as key 
 
-    std::unordered_map<std::string, uint32> m_mapClientConnFrequency;   ///< 客户端连接频率
+    CTokenBucketTable m_oAddrPermit;                                    ///< 客户端地址连接频率限制
+    CTokenBucketTable m_oMsgPermit;                                     ///< 用户消息频率限制
+
+    ev_prepare* m_pCorkWatcher;                                         ///< 本轮事件循环结束前发送合并数据
+    std::vector<std::shared_ptr<SocketChannel>> m_vecCorkChannel;       ///< 有待发送合并数据的连接
+    ev_prepare* m_pAsyncNotifyWatcher;                                  ///< 本轮事件循环结束前发送SpecChannel通知
+    std::vector<std::pair<Dispatcher*, ev_async*>> m_vecAsyncNotify;    ///< 待发送的SpecChannel通知
+    ev_timer* m_pSpecChannelOverflowWatcher;                            ///< 定时把溢出队列写入SpecChannel
+    std::vector<std::pair<Dispatcher*, SpecChannelWatcher*>> m_vecSpecChannelOverflow; ///< 溢出队列非空的SpecChannel
+    ev_timer* m_pZeroCopyLingerWatcher;                                 ///< 定时读取已关闭连接的零拷贝完成通知
+    std::vector<tagZeroCopyLinger> m_vecZeroCopyLinger;
+    std::shared_ptr<tagComputeSink> m_pComputeSink;                     ///< 计算线程池结果完成队列
+    std::vector<tagComputeResult> m_vecComputeResult;                   ///< 与完成队列交换后在本线程处理
+    tagComputeStat m_stComputeStat;
+    ev_idle* m_pDeferWatcher;                                           ///< 延后处理消息（最高优先级，每轮事件循环执行一次）
+    std::vector<std::shared_ptr<SocketChannel>> m_vecDeferredChannel;   ///< 消息处理预算用尽的连接
+    CTimingWheel m_oTimingWheel;                                        ///< Step、Session、Chain超时（CLOCK_MONOTONIC毫秒tick）
+    ev_timer* m_pTimingWheelWatcher;                                    ///< 驱动时间轮
+    uint64 m_ullTimingWheelArmedTick;                                   ///< m_pTimingWheelWatcher到期的tick
+    CTimingWheel m_oIoTimeoutWheel;                                     ///< 连接IO超时（秒tick，每秒一个槽）
+    ev_timer* m_pIoTimeoutSweepWatcher;                                 ///< 每秒扫描一次到期的连接
+    ev_check* m_pLoopCheckWatcher;                                      ///< 迭代开始（poll返回后）
+    ev_prepare* m_pLoopPrepareWatcher;                                  ///< 迭代结束（下一次poll前）
+    std::unique_ptr<CIoUring> m_pRing;                                  ///< io_backend为io_uring时的提交/完成队列，为空时所有IO走libev
+    ev_io* m_pRingWatcher;                                              ///< 环fd可读即有完成事件
+    ev_prepare* m_pRingPrepareWatcher;                                  ///< poll前一次性提交本轮产生的请求
+    uint64 m_ullRingRequestId;                                          ///< 上一个请求的user_data，0保留给取消请求
+    bool m_bRingAccept;                                                 ///< 内核支持多次完成的accept（5.19以上）
+    bool m_bRingRecv;                                                   ///< 内核支持多次完成的recv（6.0以上）
+    std::unordered_map<uint64, tagRingRequest> m_mapRingRequest;
+    std::unordered_map<int, std::deque<int>> m_mapRingAccepted;         ///< 监听fd上io_uring已接受、待Accept()取走的连接
+    std::vector<CIoUring::tagCompletion> m_vecRingCompletion;
+    tagLoopStat m_stLoopStat;
+    uint32 m_uiBusyPollSpin;                                            ///< 低延迟模式当前的自旋时长（微秒）
+    bool m_bLoopBreak;
 
     friend class Manager;
     friend class Worker;
@@ -220,6 +541,7 @@ private:
     friend class LoadStress;
     friend class CodecFactory;
     friend class CmdFdTransfer;
+    friend class CmdChannelRebalance;
     template<typename T> friend class IO;
 };
 
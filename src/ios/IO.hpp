@@ -39,6 +39,12 @@ public:
 
     static bool Send(std::shared_ptr<SocketChannel> pChannel);
 
+    /**
+     * @brief 立即发送合并发送（cork）连接中暂存的数据
+     * @note 用于对时延敏感的消息：SendResponse()/SendRequest()之后调用，不必等到本轮事件循环结束
+     */
+    static bool Flush(Actor* pActor, std::shared_ptr<SocketChannel> pChannel);
+
     template<typename ...Targs>
     static bool SendResponse(Actor* pActor, std::shared_ptr<SocketChannel> pChannel, Targs&&... args);
 
@@ -66,6 +72,12 @@ public:
     template<typename ...Targs>
     static bool DeliverReply(Actor* pActor, std::shared_ptr<SocketChannel> pChannel, uint32 uiPeerStepSeq, Targs&&... args);
 
+    /**
+     * @brief 到uiTargetLaborId的spec channel是否积压（写入方应暂缓TransmitTo/DeliverTo）
+     * @note 队列使用超过3/4或已有消息进入溢出队列时返回true
+     */
+    static bool IsBackPressure(Actor* pActor, uint32 uiTargetLaborId);
+
     template <typename ...Targs>
     static bool SendWithoutOption(Actor* pActor, const std::string& strIdentify, Targs&&... args);
 
@@ -231,6 +243,16 @@ bool IO<T>::Send(std::shared_ptr<SocketChannel> pChannel)
     return(true);
 }
 
+template<typename T>
+bool IO<T>::Flush(Actor* pActor, std::shared_ptr<SocketChannel> pChannel)
+{
+    if (pActor == nullptr || pChannel == nullptr || pChannel->m_pImpl == nullptr)
+    {
+        return(false);
+    }
+    return(pActor->m_pLabor->GetDispatcher()->FlushSocketChannel(pChannel));
+}
+
 template<typename T>
 template<typename ...Targs>
 bool IO<T>::SendResponse(Actor* pActor, std::shared_ptr<SocketChannel> pChannel, Targs&&... args)
@@ -333,11 +355,17 @@ bool IO<T>::SendResponse(Dispatcher* pDispatcher, std::shared_ptr<SocketChannel>
     switch (eStatus)
     {
         case CODEC_STATUS_OK:
+            if (pChannel->IsCork())
+            {
+                pDispatcher->AddCorkChannel(pChannel);
+                pDispatcher->CheckSendWatermark(pChannel);
+            }
             return(true);
         case CODEC_STATUS_PAUSE:
         case CODEC_STATUS_WANT_WRITE:
         case CODEC_STATUS_PART_OK:
             pDispatcher->AddIoWriteEvent(pChannel);
+            pDispatcher->CheckSendWatermark(pChannel);
             return(true);
         case CODEC_STATUS_WANT_READ:
             pDispatcher->RemoveIoWriteEvent(pChannel);
@@ -437,11 +465,17 @@ bool IO<T>::SendRequest(Dispatcher* pDispatcher, uint32 uiStepSeq, std::shared_p
     switch (eStatus)
     {
         case CODEC_STATUS_OK:
+            if (pChannel->IsCork())
+            {
+                pDispatcher->AddCorkChannel(pChannel);
+                pDispatcher->CheckSendWatermark(pChannel);
+            }
             return(true);
         case CODEC_STATUS_PAUSE:
         case CODEC_STATUS_WANT_WRITE:
         case CODEC_STATUS_PART_OK:
             pDispatcher->AddIoWriteEvent(pChannel);
+            pDispatcher->CheckSendWatermark(pChannel);
             return(true);
         case CODEC_STATUS_WANT_READ:
             pDispatcher->RemoveIoWriteEvent(pChannel);
@@ -561,6 +595,17 @@ bool IO<T>::DeliverTo(Actor* pActor, uint32 uiTargetLaborId, uint32 uiCallbackSt
     return(TransmitTo(pActor, uiTargetLaborId, uiCallbackStepSeq, std::forward<Targs>(args)...));
 }
 
+template<typename T>
+bool IO<T>::IsBackPressure(Actor* pActor, uint32 uiTargetLaborId)
+{
+    auto pChannel = LaborShared::Instance()->GetSpecChannel(T::Type(), pActor->GetLaborId(), uiTargetLaborId);
+    if (pChannel == nullptr)
+    {
+        return(false);
+    }
+    return(std::static_pointer_cast<SpecChannelBase>(pChannel)->IsBackPressure());
+}
+
 template<typename T>
 template<typename ...Targs>
 bool IO<T>::DeliverReply(Actor* pActor, std::shared_ptr<SocketChannel> pChannel, uint32 uiPeerStepSeq, Targs&&... args)
@@ -1537,6 +1582,17 @@ std::shared_ptr<SocketChannel> IO<T>::NewSocketChannel(Dispatcher* pDispatcher,
         std::static_pointer_cast<SocketChannelImpl<T>>(pChannel->m_pImpl)->SetIdentify(strIdentify);
         std::static_pointer_cast<SocketChannelImpl<T>>(pChannel->m_pImpl)->SetRemoteAddr(strHost);
         std::static_pointer_cast<SocketChannelImpl<T>>(pChannel->m_pImpl)->SetPipeline(stOption.bPipeline);
+        std::static_pointer_cast<SocketChannelImpl<T>>(pChannel->m_pImpl)->SetCork(stOption.bCork);
+        if (stOption.uiZeroCopyThreshold > 0)
+        {
+            std::static_pointer_cast<SocketChannelImpl<T>>(pChannel->m_pImpl)->SetZeroCopyThreshold(
+                    stOption.uiZeroCopyThreshold);
+        }
+        if (stOption.uiSendHighWatermark > 0)
+        {
+            std::static_pointer_cast<SocketChannelImpl<T>>(pChannel->m_pImpl)->SetSendWatermark(
+                    stOption.uiSendHighWatermark, stOption.uiSendLowWatermark);
+        }
         pDispatcher->m_pLastActivityChannel = pChannel;
 
         std::static_pointer_cast<SocketChannelImpl<T>>(pChannel->m_pImpl)->SetChannelStatus(CHANNEL_STATUS_TRY_CONNECT);
@@ -1788,7 +1844,7 @@ bool IO<T>::OnResponse(ActorBuilder* pBuilder, std::shared_ptr<SocketChannel> pC
         if (CMD_STATUS_RUNNING != eResult)
         {
             uint32 uiChainId = std::static_pointer_cast<T>(step_iter->second)->GetChainId();
-            pBuilder->m_pLabor->GetDispatcher()->DelEvent(step_iter->second->MutableWatcher()->MutableTimerWatcher());
+            pBuilder->m_pLabor->GetDispatcher()->DelTimer(step_iter->second->MutableWatcher()->MutableTimer());
             step_iter->second->MutableWatcher()->Reset();
             pBuilder->m_mapCallbackStep.erase(step_iter);
             if (CMD_STATUS_FAULT != eResult && 0 != uiChainId)
@@ -1835,7 +1891,7 @@ bool IO<T>::OnResponse(ActorBuilder* pBuilder, std::shared_ptr<SocketChannel> pC
         if (CMD_STATUS_RUNNING != eResult)
         {
             uint32 uiChainId = std::static_pointer_cast<T>(step_iter->second)->GetChainId();
-            pBuilder->m_pLabor->GetDispatcher()->DelEvent(step_iter->second->MutableWatcher()->MutableTimerWatcher());
+            pBuilder->m_pLabor->GetDispatcher()->DelTimer(step_iter->second->MutableWatcher()->MutableTimer());
             step_iter->second->MutableWatcher()->Reset();
             pBuilder->m_mapCallbackStep.erase(step_iter);
             if (CMD_STATUS_FAULT != eResult && 0 != uiChainId)
@@ -1861,13 +1917,13 @@ template<typename ...Targs>
 std::shared_ptr<SocketChannel> IO<T>::CreateSocketChannel(Dispatcher* pDispatcher, int iFd, bool bIsClient, bool bWithSsl)
 {
     LOG4_TRACE_DISPATCH("iFd %d, codec_type %d, with_ssl = %d", iFd, T::Type(), bWithSsl);
-    auto iter = pDispatcher->m_mapSocketChannel.find(iFd);
-    if (iter == pDispatcher->m_mapSocketChannel.end())
+    auto pExistChannel = pDispatcher->GetChannel(iFd);
+    if (pExistChannel == nullptr)
     {
         auto pChannel = CodecFactory::CreateChannel(pDispatcher->m_pLabor, pDispatcher->m_pLogger, iFd, T::Type(), bIsClient, bWithSsl);
         if (pChannel != nullptr)
         {
-            pDispatcher->m_mapSocketChannel.insert(std::make_pair(iFd, pChannel));
+            pDispatcher->InsertChannel(iFd, pChannel);
             LOG4_TRACE_DISPATCH("new channel[%d] with codec type %d", pChannel->GetFd(), pChannel->GetCodecType());
         }
         return(pChannel);
@@ -1875,7 +1931,7 @@ std::shared_ptr<SocketChannel> IO<T>::CreateSocketChannel(Dispatcher* pDispatche
     else
     {
         pDispatcher->Logger(Logger::WARNING, __FILE__, __LINE__, __FUNCTION__,"fd %d is exist!", iFd);
-        return(iter->second);
+        return(pExistChannel);
     }
 }
 
@@ -13,12 +13,12 @@ namespace neb
 {
 
 SpecChannelWatcher::SpecChannelWatcher()
-    : m_uiSpecChannelCodecType(0), m_pAsyncWatcher(nullptr), m_pSpecChannel(nullptr)
+    : m_uiSpecChannelCodecType(0), m_bOverflow(false), m_bOverflowWatched(false), m_bNotified(false), m_pAsyncWatcher(nullptr), m_pSpecChannel(nullptr)
 {
 }
 
 SpecChannelWatcher::SpecChannelWatcher(std::shared_ptr<SocketChannel> pChannel)
-    : m_uiSpecChannelCodecType(0), m_pAsyncWatcher(nullptr), m_pSpecChannel(pChannel)
+    : m_uiSpecChannelCodecType(0), m_bOverflow(false), m_bOverflowWatched(false), m_bNotified(false), m_pAsyncWatcher(nullptr), m_pSpecChannel(pChannel)
 {
 }
 
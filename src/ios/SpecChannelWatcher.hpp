@@ -11,6 +11,7 @@
 #define SRC_IOS_SPECCHANNELWATCHER_HPP_
 
 #include <memory>
+#include <atomic>
 #include "Definition.hpp"
 
 #ifdef __GNUC__
@@ -49,8 +50,54 @@ public:
     void Set(std::shared_ptr<SocketChannel> pChannel, uint32 uiSpecChannelCodecType);
     void Reset();
 
+    /**
+     * @brief 写入方标记消费方已被通知
+     * @return 此前未标记（需要发送通知）返回true
+     */
+    bool SetNotified()
+    {
+        return(!m_bNotified.exchange(true, std::memory_order_acq_rel));
+    }
+
+    /**
+     * @brief 消费方读空SpecChannel后清除通知标记，之后须再检查一次是否为空
+     */
+    void ClearNotified()
+    {
+        m_bNotified.exchange(false, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief SpecChannel溢出队列非空（仅写入方访问）
+     */
+    bool IsOverflow() const
+    {
+        return(m_bOverflow);
+    }
+
+    void SetOverflow(bool bOverflow)
+    {
+        m_bOverflow = bOverflow;
+    }
+
+    /**
+     * @brief 溢出队列是否已由写入方Dispatcher负责写入环形队列（仅写入方访问）
+     */
+    bool IsOverflowWatched() const
+    {
+        return(m_bOverflowWatched);
+    }
+
+    void SetOverflowWatched(bool bWatched)
+    {
+        m_bOverflowWatched = bWatched;
+    }
+
 private:
     uint32 m_uiSpecChannelCodecType;
+    bool m_bOverflow;
+    bool m_bOverflowWatched;
+    std::atomic<bool> m_bNotified;
     ev_async* m_pAsyncWatcher;
     std::shared_ptr<SocketChannel> m_pSpecChannel;
 };
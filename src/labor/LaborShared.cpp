@@ -20,14 +20,29 @@ LaborShared* LaborShared::s_pInstance = nullptr;
 std::mutex LaborShared::s_mutex;
 
 LaborShared::LaborShared(uint32 uiLaborNum)
-    : m_uiLaborNum(uiLaborNum), m_uiSpecChannelQueueSize(128), m_uiCodecSize(0)
+    : m_uiLaborNum(uiLaborNum), m_uiSpecChannelQueueSize(128), m_uiSpecChannelManagerQueueSize(0),
+      m_bSpecChannelOverflow(false)
 {
     m_vecDispatcher.reserve(uiLaborNum);
-    m_vecSpecChannel.reserve(CODEC_MAX + 1);
+    uint32 uiSpecChannelNum = CODEC_MAX * uiLaborNum * uiLaborNum;
+    m_pSpecChannel.reset(new std::atomic<std::shared_ptr<SocketChannel>*>[uiSpecChannelNum]);
+    for (uint32 i = 0; i < uiSpecChannelNum; ++i)
+    {
+        m_pSpecChannel[i].store(nullptr, std::memory_order_relaxed);
+    }
 }
 
 LaborShared::~LaborShared()
 {
+    uint32 uiSpecChannelNum = CODEC_MAX * m_uiLaborNum * m_uiLaborNum;
+    for (uint32 i = 0; i < uiSpecChannelNum; ++i)
+    {
+        delete m_pSpecChannel[i].load(std::memory_order_relaxed);
+    }
+    for (auto pRetired : m_vecRetiredSpecChannel)
+    {
+        delete pRetired;
+    }
 }
 
 Dispatcher* LaborShared::GetDispatcher(uint32 uiLaborId)
@@ -63,51 +78,97 @@ void LaborShared::AddDispatcher(uint32 uiLaborId, Dispatcher* pDispatcher)
     }
 }
 
-std::shared_ptr<SocketChannel> LaborShared::GetSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo)
+uint32 LaborShared::GetSpecChannelQueueSize(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo) const
 {
-    if (uiFrom >= m_uiLaborNum || uiTo >= m_uiLaborNum)
+    uint32 uiSize = m_uiSpecChannelQueueSize;
+    if (uiCodecType < m_vecSpecChannelQueueSize.size() && m_vecSpecChannelQueueSize[uiCodecType] > 0)
     {
-        return(nullptr);
+        uiSize = m_vecSpecChannelQueueSize[uiCodecType];
     }
-    if (uiCodecType < m_uiCodecSize.load(std::memory_order_relaxed))
+    if ((uiFrom == GetManagerLaborId() || uiTo == GetManagerLaborId()) && m_uiSpecChannelManagerQueueSize > uiSize)
     {
-        return(m_vecSpecChannel[uiCodecType][uiFrom][uiTo]);
+        uiSize = m_uiSpecChannelManagerQueueSize;
     }
-    else
+    return(uiSize);
+}
+
+void LaborShared::SetSpecChannelQueueSize(uint32 uiCodecType, uint32 uiSize)
+{
+    if (uiCodecType > CODEC_MAX)
     {
-        return(nullptr);
+        return;
     }
+    if (uiCodecType >= m_vecSpecChannelQueueSize.size())
+    {
+        m_vecSpecChannelQueueSize.resize(uiCodecType + 1, 0);
+    }
+    m_vecSpecChannelQueueSize[uiCodecType] = uiSize;
 }
 
-int LaborShared::AddSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo, std::shared_ptr<SocketChannel> pChannel)
+bool LaborShared::GetSpecChannelStat(uint32 uiFrom, uint32 uiTo, uint32& uiPeakFill, uint32& uiOverflowNum, uint32& uiFullNum)
 {
-    if (uiFrom >= m_uiLaborNum || uiTo >= m_uiLaborNum)
+    bool bExist = false;
+    uiPeakFill = 0;
+    uiOverflowNum = 0;
+    uiFullNum = 0;
+    for (uint32 i = 0; i < CODEC_MAX; ++i)
     {
-        return(ERR_SPEC_CHANNEL_LABOR_ID);
+        auto pChannel = std::static_pointer_cast<SpecChannelBase>(GetSpecChannel(i, uiFrom, uiTo));
+        if (pChannel == nullptr)
+        {
+            continue;
+        }
+        bExist = true;
+        uint32 uiFill = (uint32)((uint64)pChannel->GetPeakBacklog() * 1000 / pChannel->GetCapacity());
+        if (uiFill > uiPeakFill)
+        {
+            uiPeakFill = uiFill;
+        }
+        uiOverflowNum += pChannel->GetOverflowNum();
+        uiFullNum += pChannel->GetFullNum();
+        pChannel->ResetStat();
     }
-    if (uiCodecType < m_vecSpecChannel.size())
+    return(bExist);
+}
+
+std::shared_ptr<SocketChannel> LaborShared::GetSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo)
+{
+    if (uiCodecType >= CODEC_MAX || uiFrom >= m_uiLaborNum || uiTo >= m_uiLaborNum)
     {
-        m_vecSpecChannel[uiCodecType][uiFrom][uiTo] = pChannel;
+        return(nullptr);
     }
-    else
+    uint32 uiIndex = (uiCodecType * m_uiLaborNum + uiFrom) * m_uiLaborNum + uiTo;
+    std::shared_ptr<SocketChannel>* pChannel = m_pSpecChannel[uiIndex].load(std::memory_order_acquire);
+    if (pChannel == nullptr)
+    {
+        return(nullptr);
+    }
+    return(*pChannel);
+}
+
+void LaborShared::PublishSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo, std::shared_ptr<SocketChannel> pChannel)
+{
+    std::shared_ptr<SocketChannel>* pNewChannel = new std::shared_ptr<SocketChannel>(pChannel);
+    uint32 uiIndex = (uiCodecType * m_uiLaborNum + uiFrom) * m_uiLaborNum + uiTo;
+    std::shared_ptr<SocketChannel>* pOldChannel = m_pSpecChannel[uiIndex].exchange(pNewChannel, std::memory_order_acq_rel);
+    if (pOldChannel != nullptr)
     {
         std::lock_guard<std::mutex> guard(s_mutex);
-        for (uint32 i = m_vecSpecChannel.size(); i <= uiCodecType; ++i)
-        {
-            T_VEC_CHANNEL_FROM vecFrom;
-            vecFrom.reserve(m_uiLaborNum);
-            for (uint32 j = 0; j < m_uiLaborNum; ++j)
-            {
-                auto pTo = std::make_shared<T_VEC_CHANNEL_TO>();
-                T_VEC_CHANNEL_TO vecTo;
-                vecTo.resize(m_uiLaborNum, nullptr);
-                vecFrom.emplace_back(std::move(vecTo));
-            }
-            m_vecSpecChannel.emplace_back(std::move(vecFrom));
-        }
-        m_vecSpecChannel[uiCodecType][uiFrom][uiTo] = pChannel;
-        m_uiCodecSize.store(m_vecSpecChannel.size(), std::memory_order_release);
+        m_vecRetiredSpecChannel.push_back(pOldChannel);
+    }
+}
+
+int LaborShared::AddSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo, std::shared_ptr<SocketChannel> pChannel)
+{
+    if (uiCodecType >= CODEC_MAX)
+    {
+        return(ERR_SPEC_CHANNEL_CREATE);
     }
+    if (uiFrom >= m_uiLaborNum || uiTo >= m_uiLaborNum)
+    {
+        return(ERR_SPEC_CHANNEL_LABOR_ID);
+    }
+    PublishSpecChannel(uiCodecType, uiFrom, uiTo, pChannel);
 
     // notice spec channel created
     SpecChannelInfo oSpecInfo;
@@ -155,7 +216,7 @@ int LaborShared::AddSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo,
     int iResult = pNoticeSpecChannel->Write(gc_uiCmdReq, 0, std::forward<MsgHead>(oMsgHead), std::forward<MsgBody>(oMsgBody));
     if (iResult == ERR_OK)
     {
-        GetDispatcher(uiNoticeLabor)->AsyncSend(pNoticeSpecChannel->MutableWatcher()->MutableAsyncWatcher());
+        GetDispatcher(uiFrom)->AsyncSend(GetDispatcher(uiNoticeLabor), pNoticeSpecChannel->MutableWatcher());
     }
     return(iResult);
 }
@@ -168,7 +229,7 @@ std::shared_ptr<SpecChannel<MsgBody, MsgHead>> LaborShared::CreateInternalSpecCh
         return(nullptr);
     }
     auto pSpecChannel = std::make_shared<SpecChannel<MsgBody, MsgHead>>(
-            uiFrom, uiTo, m_uiSpecChannelQueueSize, true);
+            uiFrom, uiTo, GetSpecChannelQueueSize(uiCodecType, uiFrom, uiTo), true, m_bSpecChannelOverflow);
     if (pSpecChannel == nullptr)
     {
         return(nullptr);
@@ -176,28 +237,7 @@ std::shared_ptr<SpecChannel<MsgBody, MsgHead>> LaborShared::CreateInternalSpecCh
     auto pChannel = std::dynamic_pointer_cast<SocketChannel>(pSpecChannel);
     auto pWatcher = pSpecChannel->MutableWatcher();
     pWatcher->Set(pChannel, uiCodecType);
-    if (uiCodecType < m_vecSpecChannel.size())
-    {
-        m_vecSpecChannel[uiCodecType][uiFrom][uiTo] = pChannel;
-    }
-    else
-    {
-        std::lock_guard<std::mutex> guard(s_mutex);
-        for (uint32 i = m_vecSpecChannel.size(); i <= uiCodecType; ++i)
-        {
-            T_VEC_CHANNEL_FROM vecFrom;
-            for (uint32 j = 0; j < m_uiLaborNum; ++j)
-            {
-                auto pTo = std::make_shared<T_VEC_CHANNEL_TO>();
-                T_VEC_CHANNEL_TO vecTo;
-                vecTo.resize(m_uiLaborNum, nullptr);
-                vecFrom.emplace_back(std::move(vecTo));
-            }
-            m_vecSpecChannel.emplace_back(std::move(vecFrom));
-        }
-        m_vecSpecChannel[uiCodecType][uiFrom][uiTo] = pChannel;
-        m_uiCodecSize.store(m_vecSpecChannel.size(), std::memory_order_release);
-    }
+    PublishSpecChannel(uiCodecType, uiFrom, uiTo, pChannel);
     return(pSpecChannel);
 }
 
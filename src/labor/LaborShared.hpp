@@ -28,11 +28,6 @@ template<typename T1, typename T2> class SpecChannel;
 class LaborShared
 {
 public:
-    // To improve performance use vector instead of map
-    typedef std::vector<std::shared_ptr<SocketChannel>> T_VEC_CHANNEL_TO;
-    typedef std::vector<T_VEC_CHANNEL_TO> T_VEC_CHANNEL_FROM;
-    typedef std::vector<T_VEC_CHANNEL_FROM> T_VECCHANNEL_CODEC_TYPE;
-
     virtual ~LaborShared();
 
     static inline LaborShared* Instance(uint32 uiLaborNum = 2)
@@ -47,6 +42,10 @@ public:
     Dispatcher* GetDispatcher(uint32 uiLaborId);
     // AddDispatcher() if and only if the service starts
     void AddDispatcher(uint32 uiLaborId, Dispatcher* pDispatcher);
+    /**
+     * @brief 获取SpecChannel
+     * @note 无锁，一次下标计算和一次原子读取，可在任意labor线程调用
+     */
     std::shared_ptr<SocketChannel> GetSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo);
     int AddSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo, std::shared_ptr<SocketChannel> pChannel);
     std::shared_ptr<SpecChannel<MsgBody, MsgHead>> CreateInternalSpecChannel(uint32 uiFrom, uint32 uiTo);
@@ -66,11 +65,43 @@ public:
         return(m_uiSpecChannelQueueSize);
     }
 
+    /**
+     * @brief 获取指定SpecChannel的队列大小
+     * @note 优先使用按编解码类型配置的大小，与Manager之间的SpecChannel取该值与manager_queue_size中的较大者
+     */
+    uint32 GetSpecChannelQueueSize(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo) const;
+
     void SetSpecChannelQueueSize(uint32 uiSize)
     {
         m_uiSpecChannelQueueSize = uiSize;
     }
 
+    void SetSpecChannelQueueSize(uint32 uiCodecType, uint32 uiSize);
+
+    void SetSpecChannelManagerQueueSize(uint32 uiSize)
+    {
+        m_uiSpecChannelManagerQueueSize = uiSize;
+    }
+
+    bool IsSpecChannelOverflow() const
+    {
+        return(m_bSpecChannelOverflow);
+    }
+
+    void SetSpecChannelOverflow(bool bOverflow)
+    {
+        m_bSpecChannelOverflow = bOverflow;
+    }
+
+    /**
+     * @brief 获取uiFrom到uiTo所有编解码类型SpecChannel的统计并重置
+     * @param uiPeakFill 统计周期内最高使用率（千分比，溢出时超过1000）
+     * @param uiOverflowNum 统计周期内进入溢出队列的消息数
+     * @param uiFullNum 统计周期内因队列满被拒绝的消息数
+     * @return uiFrom到uiTo不存在SpecChannel返回false
+     */
+    bool GetSpecChannelStat(uint32 uiFrom, uint32 uiTo, uint32& uiPeakFill, uint32& uiOverflowNum, uint32& uiFullNum);
+
     const std::vector<uint64>& GetWorkerThreadId()
     {
         return(m_vecWorkerThreadId);
@@ -79,15 +110,26 @@ public:
 
 private:
     explicit LaborShared(uint32 uiLaborNum);
+
+    /**
+     * @brief 发布SpecChannel到表中
+     * @note 表项保存指向不可变shared_ptr的指针，读方复制该shared_ptr即可；被替换的旧表项
+     *       不释放（读方可能仍在复制），放入m_vecRetiredSpecChannel直到LaborShared析构
+     */
+    void PublishSpecChannel(uint32 uiCodecType, uint32 uiFrom, uint32 uiTo, std::shared_ptr<SocketChannel> pChannel);
     static LaborShared* s_pInstance;
     static std::mutex s_mutex;
 
 private:
     uint32 m_uiLaborNum;
     uint32 m_uiSpecChannelQueueSize;
-    std::atomic<uint32> m_uiCodecSize;
+    uint32 m_uiSpecChannelManagerQueueSize;             ///< Manager与Worker之间SpecChannel的队列大小
+    bool m_bSpecChannelOverflow;                        ///< SpecChannel满时是否使用写入方溢出队列
+    std::vector<uint32> m_vecSpecChannelQueueSize;      ///< 按编解码类型配置的队列大小，0为未配置
     std::vector<Dispatcher*> m_vecDispatcher;
-    T_VECCHANNEL_CODEC_TYPE m_vecSpecChannel;
+    /// 按[codec_type][from][to]展开的SpecChannel表，构造时按CODEC_MAX和labor数量一次分配，之后不再扩容
+    std::unique_ptr<std::atomic<std::shared_ptr<SocketChannel>*>[]> m_pSpecChannel;
+    std::vector<std::shared_ptr<SocketChannel>*> m_vecRetiredSpecChannel;
     std::vector<uint64> m_vecWorkerThreadId;
 };
 
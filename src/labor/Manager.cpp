@@ -208,9 +208,9 @@ void Manager::StartService()
                  m_stNodeInfo.iPortForServer, m_stNodeInfo.iBacklog,
                  m_stManagerInfo.iS2SListenFd, m_stManagerInfo.iS2SFamily);
 
-        if (m_stNodeInfo.strHostForClient.size() > 0)
+        if (m_stNodeInfo.strHostForClient.size() > 0 && !m_stNodeInfo.bReusePort)
         {
-            // 接入节点才需要监听客户端连接
+            // 接入节点才需要监听客户端连接（reuseport模式下由各Worker监听）
             if (m_stNodeInfo.iPortForClient > 0)
             {
                 m_pDispatcher->CreateListenFd(strBindIp,
@@ -247,9 +247,9 @@ void Manager::StartService()
               m_stNodeInfo.iPortForServer, m_stNodeInfo.iBacklog,
               m_stManagerInfo.iS2SListenFd, m_stManagerInfo.iS2SFamily);
 
-        if (m_stNodeInfo.strHostForClient.size() > 0)
+        if (m_stNodeInfo.strHostForClient.size() > 0 && !m_stNodeInfo.bReusePort)
         {
-            // 接入节点才需要监听客户端连接
+            // 接入节点才需要监听客户端连接（reuseport模式下由各Worker监听）
             if (m_stNodeInfo.iPortForClient > 0)
             {
                 m_pDispatcher->CreateListenFd(m_stNodeInfo.strHostForClient,
@@ -382,6 +382,12 @@ bool Manager::GetConf()
         m_oCurrentConf.Get("connection_protection", m_stNodeInfo.dConnectionProtection);
         m_oCurrentConf.Get("io_timeout", m_stNodeInfo.dIoTimeout);
         m_oCurrentConf.Get("data_report", m_stNodeInfo.dDataReportInterval);
+        m_oCurrentConf["rebalance"].Get("enable", m_stNodeInfo.bRebalance);
+        m_oCurrentConf["rebalance"].Get("high_ratio", m_stNodeInfo.dRebalanceHighRatio);
+        m_oCurrentConf["rebalance"].Get("low_ratio", m_stNodeInfo.dRebalanceLowRatio);
+        m_oCurrentConf["rebalance"].Get("hot_round", m_stNodeInfo.uiRebalanceHotRound);
+        m_oCurrentConf["rebalance"].Get("cooldown", m_stNodeInfo.dRebalanceCooldown);
+        m_oCurrentConf["rebalance"].Get("min_msg", m_stNodeInfo.uiRebalanceMinMsg);
         if (m_oLastConf.ToString().length() == 0)
         {
             std::string strSocketType = "TCP";
@@ -395,7 +401,12 @@ bool Manager::GetConf()
             m_oCurrentConf.Get("gateway_port", m_stNodeInfo.iGatewayPort);
             m_oCurrentConf.Get("access_socket_type", strSocketType);
             m_oCurrentConf.Get("backlog", m_stNodeInfo.iBacklog);
+            m_oCurrentConf.Get("accept_batch", m_stNodeInfo.uiAcceptBatch);
+            m_oCurrentConf.Get("loop_stall_threshold", m_stNodeInfo.dLoopStallThreshold);
             m_oCurrentConf.Get("connection_dispatch", m_stNodeInfo.iConnectionDispatch);
+            m_oCurrentConf.Get("io_backend", m_stNodeInfo.strIoBackend);
+            m_oCurrentConf["reuseport"].Get("enable", m_stNodeInfo.bReusePort);
+            m_oCurrentConf["reuseport"].Get("cpu_bpf", m_stNodeInfo.bReusePortCpuBpf);
             if (strSocketType == "UDP" || strSocketType == "udp")
             {
                 m_stNodeInfo.iForClientSocketType = SOCK_DGRAM;
@@ -404,6 +415,12 @@ bool Manager::GetConf()
             {
                 m_stNodeInfo.iForClientSocketType = SOCK_STREAM;
             }
+            bool bThreadMode = false;
+            m_oCurrentConf.Get("thread_mode", bThreadMode);
+            if (!bThreadMode || SOCK_STREAM != m_stNodeInfo.iForClientSocketType)
+            {   // 只有线程模式的TCP接入才由Worker各自监听
+                m_stNodeInfo.bReusePort = false;
+            }
             m_stNodeInfo.strNodeIdentify = m_stNodeInfo.strHostForServer + std::string(":") + std::to_string(m_stNodeInfo.iPortForServer);
         }
         int32 iCodec;
@@ -422,9 +439,32 @@ bool Manager::Init()
     m_oCurrentConf.Get("thread_mode", m_stNodeInfo.bThreadMode);
     if (m_stNodeInfo.bThreadMode)
     {
+        LaborShared* pLaborShared = LaborShared::Instance(m_stNodeInfo.uiWorkerNum + 2);
         uint32 uiSpecChannelQueueSize = 128;
         m_oCurrentConf.Get("spec_channel_queue_size", uiSpecChannelQueueSize);
-        LaborShared::Instance(m_stNodeInfo.uiWorkerNum + 2)->SetSpecChannelQueueSize(uiSpecChannelQueueSize);
+        CJsonObject& oSpecChannelConf = m_oCurrentConf["spec_channel"];
+        oSpecChannelConf.Get("queue_size", uiSpecChannelQueueSize);
+        pLaborShared->SetSpecChannelQueueSize(uiSpecChannelQueueSize);
+        uint32 uiManagerQueueSize = 0;
+        if (oSpecChannelConf.Get("manager_queue_size", uiManagerQueueSize))
+        {
+            pLaborShared->SetSpecChannelManagerQueueSize(uiManagerQueueSize);
+        }
+        bool bOverflow = false;
+        if (oSpecChannelConf.Get("overflow", bOverflow))
+        {
+            pLaborShared->SetSpecChannelOverflow(bOverflow);
+        }
+        std::string strCodecType;
+        CJsonObject& oCodecQueueSize = oSpecChannelConf["codec_queue_size"];
+        while (oCodecQueueSize.GetKey(strCodecType))
+        {
+            uint32 uiCodecQueueSize = 0;
+            if (oCodecQueueSize.Get(strCodecType, uiCodecQueueSize))
+            {
+                pLaborShared->SetSpecChannelQueueSize((uint32)strtoul(strCodecType.c_str(), NULL, 10), uiCodecQueueSize);
+            }
+        }
         m_oCurrentConf.Get("async_logger", m_stNodeInfo.bAsyncLogger);
     }
     if (!InitLogger(m_oCurrentConf) || !InitDispatcher() || !InitActorBuilder())
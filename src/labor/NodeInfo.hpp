@@ -11,6 +11,8 @@
 #define SRC_LABOR_NODEINFO_HPP_
 
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include "Definition.hpp"
 #include "codec/Codec.hpp"
 
@@ -38,12 +40,32 @@ struct NodeInfo
     bool bAsyncLogger               = false;        ///< 是否启用异步文件日志
     bool bIsAccess                  = false;        ///< 是否接入Server
     bool bChannelVerify             = false;        ///< 是否需要连接验证
+    bool bReusePort                 = false;        ///< 线程模式下各Worker以SO_REUSEPORT各自监听对Client端口，Manager不再接收客户端连接
+    bool bReusePortCpuBpf           = false;        ///< reuseport组挂载BPF程序，连接由处理其SYN的CPU上的Worker接收
     ev_tstamp dConnectionProtection = 0.0;          ///< >0时为连接保护时间，新建连接会设置成这个时间，接收到第一个数据包之后改设成dIoTimeout
     ev_tstamp dIoTimeout            = 60.0;          ///< IO（连接）超时配置
     ev_tstamp dDataReportInterval   = 60.0;         ///< 统计数据上报时间间隔
     ev_tstamp dMsgStatInterval      = 60.0;          ///< 客户端连接发送数据包统计时间间隔
     ev_tstamp dAddrStatInterval     = 60.0;          ///< IP地址数据统计时间间隔
     ev_tstamp dStepTimeout          = 1.5;          ///< 步骤超时
+    ev_tstamp dBufferReclaimIdle    = 0.0;          ///< 连接空闲超过该时间后释放其收发缓冲区，0为不释放
+    uint32 uiBusyPollSpin           = 0;            ///< 低延迟模式：阻塞等待事件前最多自旋轮询的微秒数（随空闲自动退避），0为不自旋
+    int32 iSoBusyPoll               = 0;            ///< 低延迟模式：客户端连接设置的SO_BUSY_POLL（微秒），0为不设置
+    ev_tstamp dLoopStallThreshold   = 0.1;          ///< 事件循环单次迭代或单个回调耗时超过该值时告警，0为不告警
+    uint32 uiSendHighWatermark      = 0;            ///< 连接待发送数据高水位（字节），超过则停止从该连接读取，0为不限制
+    uint32 uiSendLowWatermark       = 0;            ///< 连接待发送数据低水位（字节），低于则恢复读取
+    uint32 uiZeroCopyThreshold      = 0;            ///< 单次发送数据量不小于该值时使用MSG_ZEROCOPY（字节），0为不使用
+    uint32 uiMsgBudget              = 0;            ///< 单次读事件单个连接最多处理的消息数，超出部分延后处理，0为不限制
+    uint32 uiRecvBudget             = 262144;       ///< 单次读事件最多接收的字节数，0为不限制（读到EAGAIN为止）
+    bool bRebalance                 = false;        ///< 线程模式下Manager是否自动将高负载Worker的连接迁移到低负载Worker
+    double dRebalanceHighRatio      = 1.5;          ///< Worker接收消息数超过平均值的该倍数视为高负载
+    double dRebalanceLowRatio       = 0.7;          ///< Worker接收消息数低于平均值的该倍数视为低负载
+    uint32 uiRebalanceHotRound      = 2;            ///< 连续高负载的统计周期数达到该值才迁移（滞后，避免抖动）
+    ev_tstamp dRebalanceCooldown    = 60.0;         ///< 同一Worker两次参与迁移的最小间隔
+    uint32 uiRebalanceMinMsg        = 100;          ///< 只迁移每秒接收消息数不少于该值的连接
+    uint32 uiAcceptBatch            = 64;           ///< 单次监听fd可读事件最多接收的连接数，0为不限制（接收到EAGAIN为止）
+    uint32 uiComputeThreadNum       = 0;            ///< 计算线程池线程数，0为不启用
+    uint32 uiComputeQueueLimit      = 65536;        ///< 计算线程池排队任务数上限
     std::string strWorkPath;                        ///< 工作路径
     std::string strConfFile;                        ///< 配置文件
     std::string strNodeType;                        ///< 节点类型
@@ -51,6 +73,9 @@ struct NodeInfo
     std::string strHostForClient;                   ///< 对Client服务的IP地址，对应 m_iC2SListenFd
     std::string strGateway;                         ///< 对Client服务的真实IP地址（此ip转发给m_strHostForClient）
     std::string strNodeIdentify;
+    std::string strIoBackend;                       ///< 事件循环后端：空或auto为libev默认，epoll，io_uring
+    std::unordered_map<int32, uint32> mapCodecBufferSize;   ///< 各编解码器连接收发缓冲区初始容量
+    std::unordered_set<int32> setCorkCodec;                 ///< 开启合并发送的编解码器
 };
 
 enum E_IO_STAT
@@ -99,8 +124,12 @@ struct WorkerInfo
     uint32 uiDestroyUpStreamConnection      = 0;                    ///<
     uint32 uiNewDownStreamConnection        = 0;                    ///<
     uint32 uiDestroyDownStreamConnection    = 0;                    ///<
+    uint32 uiLoopCpuTime                    = 0;                    ///< 上个统计周期事件循环每次迭代的平均CPU时间（微秒）
+    uint32 uiHotRound                       = 0;                    ///< 连续高负载的统计周期数（Manager负载均衡使用）
+    ev_tstamp dLastMigrateTime              = 0.0;                  ///< 最近一次参与连接迁移的时间（Manager负载均衡使用）
     ev_tstamp dBeatTime     = 0.0;                  ///< 心跳时间
     bool bStartBeatCheck    = 0.0;                  ///< 是否需要心跳检查，worker或loader进程启动时可能需要加载数据而处于繁忙状态无法响应Manager的心跳，需等待其就绪之后才开始心跳检查。
+    std::unordered_map<int, int> mapAccessFdFamily;     ///< reuseport模式下Worker自己的对Client监听fd及其地址族
 
     WorkerInfo(){}
     WorkerInfo(const WorkerInfo& stAttr) = delete;
@@ -125,6 +154,7 @@ struct WorkerInfo
         uiDestroyUpStreamConnection = 0;
         uiNewDownStreamConnection = 0;
         uiDestroyDownStreamConnection = 0;
+        uiLoopCpuTime = 0;
     }
 };
 
@@ -8,7 +8,9 @@
  * Modify history:
  ******************************************************************************/
 #include <algorithm>
+#include <set>
 #include <sched.h>
+#include <sys/resource.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -26,6 +28,8 @@ extern "C" {
 #include "actor/session/sys_session/manager/SessionManager.hpp"
 #include "actor/session/sys_session/SessionDataReport.hpp"
 #include "pb/report.pb.h"
+#include "util/CBufferPool.hpp"
+#include "util/CComputePool.hpp"
 
 namespace neb
 {
@@ -106,6 +110,8 @@ void Worker::DataReport()
     oWorkerStatus.add_value(m_stWorkerInfo.uiRecvByte);
     oWorkerStatus.add_value(m_stWorkerInfo.uiSendNum);
     oWorkerStatus.add_value(m_stWorkerInfo.uiSendByte);
+    m_stWorkerInfo.uiLoopCpuTime = GetLoopCpuTime();
+    oWorkerStatus.add_value(m_stWorkerInfo.uiLoopCpuTime);
     oWorkerStatus.SerializeToString(&strWorkerStatus);
     oMsgBody.set_data(strWorkerStatus);
     oMsgHead.set_cmd(CMD_REQ_UPDATE_WORKER_LOAD);
@@ -179,8 +185,192 @@ void Worker::DataReport()
         pRecord->set_key("downstream_send_byte");
         pRecord->set_item("nebula");
         pRecord->add_value(m_stWorkerInfo.uiDownStreamSendByte);
+        pRecord = pReport->add_records();
+        pRecord->set_key("buffer_pool_hit");
+        pRecord->set_item("nebula");
+        pRecord->add_value(CBufferPool::Instance().GetHitNum());
+        pRecord = pReport->add_records();
+        pRecord->set_key("buffer_pool_miss");
+        pRecord->set_item("nebula");
+        pRecord->add_value(CBufferPool::Instance().GetMissNum());
+        pRecord = pReport->add_records();
+        pRecord->set_key("buffer_pool_oversize");
+        pRecord->set_item("nebula");
+        pRecord->add_value(CBufferPool::Instance().GetOversizeNum());
+        pRecord = pReport->add_records();
+        pRecord->set_key("buffer_pool_cached_byte");
+        pRecord->set_item("nebula");
+        pRecord->add_value(CBufferPool::Instance().GetCachedBytes());
+        pRecord = pReport->add_records();
+        pRecord->set_key("channel_buffer_byte");
+        pRecord->set_item("nebula");
+        pRecord->add_value((CBufferPool::Instance().GetInUseBytes() > 0) ? CBufferPool::Instance().GetInUseBytes() : 0);
+        pRecord = pReport->add_records();
+        pRecord->set_key("channel_buffer_reclaim");
+        pRecord->set_item("nebula");
+        pRecord->add_value(m_pDispatcher->GetBufferReclaimNum());
+        pRecord = pReport->add_records();
+        pRecord->set_key("msg_budget_hit");
+        pRecord->set_item("nebula");
+        pRecord->add_value(m_pDispatcher->GetMsgBudgetHitNum());
+        uint64 ullSendQueueBytes = 0;
+        uint64 ullMaxSendQueueBytes = 0;
+        uint32 uiReadSuspendedNum = 0;
+        m_pDispatcher->GetSendQueueStat(ullSendQueueBytes, ullMaxSendQueueBytes, uiReadSuspendedNum);
+        pRecord = pReport->add_records();
+        pRecord->set_key("send_queue_byte");
+        pRecord->set_item("nebula");
+        pRecord->add_value(ullSendQueueBytes);
+        pRecord = pReport->add_records();
+        pRecord->set_key("send_queue_max_byte");
+        pRecord->set_item("nebula");
+        pRecord->add_value(ullMaxSendQueueBytes);
+        pRecord = pReport->add_records();
+        pRecord->set_key("read_suspended_channel");
+        pRecord->set_item("nebula");
+        pRecord->add_value(uiReadSuspendedNum);
+        const Dispatcher::tagLoopStat& stLoopStat = m_pDispatcher->GetLoopStat();
+        pRecord = pReport->add_records();
+        pRecord->set_key("loop_iteration");
+        pRecord->set_item("nebula");
+        pRecord->add_value(stLoopStat.ullIterationNum);
+        pRecord = pReport->add_records();
+        pRecord->set_key("loop_callback");
+        pRecord->set_item("nebula");
+        pRecord->add_value(stLoopStat.ullCallbackNum);
+        pRecord = pReport->add_records();
+        pRecord->set_key("loop_max_iteration_us");
+        pRecord->set_item("nebula");
+        pRecord->add_value(stLoopStat.ullMaxIteration);
+        pRecord = pReport->add_records();
+        pRecord->set_key("loop_stall");
+        pRecord->set_item("nebula");
+        pRecord->add_value(stLoopStat.uiStallNum);
+        if (m_stNodeInfo.uiBusyPollSpin > 0)
+        {
+            pRecord = pReport->add_records();
+            pRecord->set_key("busy_poll_spin_us");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stLoopStat.ullSpinTime);
+            pRecord = pReport->add_records();
+            pRecord->set_key("busy_poll_sleep_us");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stLoopStat.ullSleepTime);
+            pRecord = pReport->add_records();
+            pRecord->set_key("busy_poll_spin_permille");
+            pRecord->set_item("nebula");
+            pRecord->add_value((stLoopStat.ullSpinTime + stLoopStat.ullSleepTime > 0)
+                    ? stLoopStat.ullSpinTime * 1000 / (stLoopStat.ullSpinTime + stLoopStat.ullSleepTime) : 0);
+        }
+        for (uint32 i = 0; i < Dispatcher::LOOP_LAG_BUCKET_NUM; ++i)
+        {
+            pRecord = pReport->add_records();
+            if (Dispatcher::LOOP_LAG_BUCKET[i] == UINT32_MAX)
+            {
+                pRecord->set_key("loop_lag_le_inf");
+            }
+            else
+            {
+                pRecord->set_key("loop_lag_le_" + std::to_string(Dispatcher::LOOP_LAG_BUCKET[i]) + "ms");
+            }
+            pRecord->set_item("nebula");
+            pRecord->add_value(stLoopStat.auiLagHistogram[i]);
+        }
+        // 超过卡顿阈值的回调按编解码类型、Actor类名分别统计
+        for (auto iter = stLoopStat.mapSlowCallback.begin(); iter != stLoopStat.mapSlowCallback.end(); ++iter)
+        {
+            pRecord = pReport->add_records();
+            pRecord->set_key("loop_slow_callback " + iter->first);
+            pRecord->set_item("nebula");
+            pRecord->add_value(iter->second.uiNum);
+            pRecord = pReport->add_records();
+            pRecord->set_key("loop_slow_callback_max_us " + iter->first);
+            pRecord->set_item("nebula");
+            pRecord->add_value(iter->second.ullMaxTime);
+            pRecord->set_value_type(ReportRecord::VALUE_FIXED);
+        }
+        if (m_stNodeInfo.uiComputeThreadNum > 0)
+        {
+            const Dispatcher::tagComputeStat& stComputeStat = m_pDispatcher->GetComputeStat();
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_submit");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stComputeStat.uiSubmitNum);
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_reject");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stComputeStat.uiRejectNum);
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_done");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stComputeStat.uiDoneNum);
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_cancel");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stComputeStat.uiCancelNum);
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_in_flight");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stComputeStat.uiInFlight);
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_peak_in_flight");
+            pRecord->set_item("nebula");
+            pRecord->add_value(stComputeStat.uiPeakInFlight);
+            // 线程池为进程内共享，以下为上报时刻的排队数和累计值
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_pool_queue_depth");
+            pRecord->set_item("nebula");
+            pRecord->add_value(CComputePool::Instance().GetQueueDepth());
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_pool_executed");
+            pRecord->set_item("nebula");
+            pRecord->add_value(CComputePool::Instance().GetExecutedNum());
+            pRecord = pReport->add_records();
+            pRecord->set_key("compute_pool_stolen");
+            pRecord->set_item("nebula");
+            pRecord->add_value(CComputePool::Instance().GetStolenNum());
+        }
+        // 每个SpecChannel只由一方上报：发往本Worker的由本Worker上报，本Worker发往Manager的也由本Worker上报
+        LaborShared* pLaborShared = LaborShared::Instance();
+        uint32 uiLaborId = (uint32)m_stWorkerInfo.iWorkerIndex;
+        std::vector<std::pair<uint32, uint32>> vecSpecChannelPair;
+        for (uint32 uiFrom = 0; uiFrom < pLaborShared->GetLaborNum(); ++uiFrom)
+        {
+            vecSpecChannelPair.push_back(std::make_pair(uiFrom, uiLaborId));
+        }
+        vecSpecChannelPair.push_back(std::make_pair(uiLaborId, uiManagerLaborId));
+        for (auto& oPair : vecSpecChannelPair)
+        {
+            uint32 uiFrom = oPair.first;
+            uint32 uiTo = oPair.second;
+            uint32 uiPeakFill = 0;
+            uint32 uiOverflowNum = 0;
+            uint32 uiFullNum = 0;
+            if (uiFrom == uiTo || !pLaborShared->GetSpecChannelStat(uiFrom, uiTo, uiPeakFill, uiOverflowNum, uiFullNum))
+            {
+                continue;
+            }
+            std::string strPair = std::to_string(uiFrom) + "_" + std::to_string(uiTo);
+            pRecord = pReport->add_records();
+            pRecord->set_key("spec_channel_" + strPair + "_peak_fill_permille");
+            pRecord->set_item("nebula");
+            pRecord->add_value(uiPeakFill);
+            pRecord = pReport->add_records();
+            pRecord->set_key("spec_channel_" + strPair + "_overflow");
+            pRecord->set_item("nebula");
+            pRecord->add_value(uiOverflowNum);
+            pRecord = pReport->add_records();
+            pRecord->set_key("spec_channel_" + strPair + "_full");
+            pRecord->set_item("nebula");
+            pRecord->add_value(uiFullNum);
+        }
         pSessionDataReport->AddReport(pReport);
     }
+    CBufferPool::Instance().ResetStat();
+    m_pDispatcher->ResetBufferReclaimNum();
+    m_pDispatcher->ResetMsgBudgetHitNum();
+    m_pDispatcher->ResetLoopStat();
+    m_pDispatcher->ResetComputeStat();
     m_stWorkerInfo.ResetStat();
 }
 
@@ -212,6 +402,61 @@ bool Worker::Init(CJsonObject& oJsonConf)
     oJsonConf.Get("need_channel_verify", m_stNodeInfo.bChannelVerify);
     oJsonConf.Get("gateway", m_stNodeInfo.strGateway);
     oJsonConf.Get("gateway_port", m_stNodeInfo.iGatewayPort);
+    oJsonConf.Get("io_backend", m_stNodeInfo.strIoBackend);
+    oJsonConf["reuseport"].Get("enable", m_stNodeInfo.bReusePort);
+    oJsonConf["reuseport"].Get("cpu_bpf", m_stNodeInfo.bReusePortCpuBpf);
+    oJsonConf.Get("recv_budget", m_stNodeInfo.uiRecvBudget);
+    oJsonConf.Get("loop_stall_threshold", m_stNodeInfo.dLoopStallThreshold);
+    oJsonConf.Get("msg_budget", m_stNodeInfo.uiMsgBudget);
+    oJsonConf.Get("zerocopy_threshold", m_stNodeInfo.uiZeroCopyThreshold);
+    oJsonConf.Get("buffer_reclaim_idle", m_stNodeInfo.dBufferReclaimIdle);
+    oJsonConf["compute_pool"].Get("thread_num", m_stNodeInfo.uiComputeThreadNum);
+    oJsonConf["compute_pool"].Get("queue_limit", m_stNodeInfo.uiComputeQueueLimit);
+    CComputePool::Instance().Configure(m_stNodeInfo.uiComputeThreadNum, m_stNodeInfo.uiComputeQueueLimit);
+    bool bBusyPoll = false;
+    if (oJsonConf["busy_poll"].Get("enable", bBusyPoll) && bBusyPoll)
+    {
+        // 未配置workers时所有Worker开启，否则只有列出的Worker开启
+        bool bBusyPollWorker = true;
+        if (oJsonConf["busy_poll"]["workers"].IsArray() && oJsonConf["busy_poll"]["workers"].GetArraySize() > 0)
+        {
+            bBusyPollWorker = false;
+            for (int i = 0; i < oJsonConf["busy_poll"]["workers"].GetArraySize(); ++i)
+            {
+                int32 iWorkerIndex = -1;
+                if (oJsonConf["busy_poll"]["workers"].Get(i, iWorkerIndex) && iWorkerIndex == m_stWorkerInfo.iWorkerIndex)
+                {
+                    bBusyPollWorker = true;
+                    break;
+                }
+            }
+        }
+        if (bBusyPollWorker)
+        {
+            oJsonConf["busy_poll"].Get("spin_us", m_stNodeInfo.uiBusyPollSpin);
+            oJsonConf["busy_poll"].Get("so_busy_poll", m_stNodeInfo.iSoBusyPoll);
+        }
+    }
+    oJsonConf["send_watermark"].Get("high", m_stNodeInfo.uiSendHighWatermark);
+    oJsonConf["send_watermark"].Get("low", m_stNodeInfo.uiSendLowWatermark);
+    for (int i = 0; i < oJsonConf["codec_buffer_size"].GetArraySize(); ++i)
+    {
+        int32 iCodec = 0;
+        uint32 uiBufferSize = 0;
+        if (oJsonConf["codec_buffer_size"][i].Get("codec", iCodec)
+                && oJsonConf["codec_buffer_size"][i].Get("size", uiBufferSize))
+        {
+            m_stNodeInfo.mapCodecBufferSize[iCodec] = uiBufferSize;
+        }
+    }
+    for (int i = 0; i < oJsonConf["cork_codec"].GetArraySize(); ++i)
+    {
+        int32 iCodec = 0;
+        if (oJsonConf["cork_codec"].Get(i, iCodec))
+        {
+            m_stNodeInfo.setCorkCodec.insert(iCodec);
+        }
+    }
     m_oNodeConf = oJsonConf;
     m_oCustomConf = oJsonConf["custom"];
     std::ostringstream oss;
@@ -278,6 +523,13 @@ bool Worker::Init(CJsonObject& oJsonConf)
     {
         return(false);
     }
+    // Loader（序号0）不处理客户端连接，监听它会使reuseport组内序号与Worker错位
+    if (m_stNodeInfo.bThreadMode && m_stNodeInfo.bReusePort && m_stNodeInfo.bIsAccess
+            && GetLaborType() == LABOR_WORKER && m_stWorkerInfo.iWorkerIndex >= 1
+            && !CreateReusePortListener(oJsonConf))
+    {
+        return(false);
+    }
 
     std::string strChainKey;
     while (oJsonConf["runtime"]["chains"].GetKey(strChainKey))
@@ -424,10 +676,117 @@ bool Worker::CreateEvents()
         signal_watcher->data = (void*)this;
         m_pDispatcher->AddEvent(signal_watcher, Dispatcher::SignalCallback, SIGINT);
     }
+    for (auto iter = m_stWorkerInfo.mapAccessFdFamily.begin(); iter != m_stWorkerInfo.mapAccessFdFamily.end(); ++iter)
+    {
+        LOG4_TRACE("C2SListenFd[%d]", iter->first);
+        auto pChannelListen = m_pDispatcher->CreateSocketChannel(iter->first, m_stNodeInfo.eCodec);
+        if (pChannelListen == nullptr)
+        {
+            return(false);
+        }
+        m_pDispatcher->SetChannelStatus(pChannelListen, CHANNEL_STATUS_ESTABLISHED);
+        m_pDispatcher->AddIoReadEvent(pChannelListen);
+    }
     AddPeriodicTaskEvent();
     return(true);
 }
 
+uint32 Worker::GetLoopCpuTime()
+{
+    struct rusage stUsage;
+    // 线程模式只统计本Worker线程
+    if (0 != getrusage(m_stNodeInfo.bThreadMode ? RUSAGE_THREAD : RUSAGE_SELF, &stUsage))
+    {
+        return(0);
+    }
+    uint64 ullCpuTime = (uint64)(stUsage.ru_utime.tv_sec + stUsage.ru_stime.tv_sec) * 1000000
+        + stUsage.ru_utime.tv_usec + stUsage.ru_stime.tv_usec;
+    uint32 uiLoopIteration = m_pDispatcher->GetLoopIteration();
+    uint32 uiLoopNum = uiLoopIteration - m_uiLastLoopIteration;
+    uint64 ullCpuTimeDiff = ullCpuTime - m_ullLastCpuTime;
+    m_ullLastCpuTime = ullCpuTime;
+    m_uiLastLoopIteration = uiLoopIteration;
+    if (uiLoopNum == 0)
+    {
+        return(0);
+    }
+    return((uint32)(ullCpuTimeDiff / uiLoopNum));
+}
+
+bool Worker::CreateReusePortListener(CJsonObject& oJsonConf)
+{
+    std::string strSocketType = "TCP";
+    oJsonConf.Get("access_socket_type", strSocketType);
+    if (strSocketType == "UDP" || strSocketType == "udp")
+    {
+        LOG4_WARNING("reuseport only supports TCP access, fall back to manager accepting.");
+        m_stNodeInfo.bReusePort = false;
+        return(true);
+    }
+    int32 iCodec = 0;
+    if (oJsonConf.Get("access_codec", iCodec))
+    {
+        m_stNodeInfo.eCodec = E_CODEC_TYPE(iCodec);
+    }
+    oJsonConf.Get("backlog", m_stNodeInfo.iBacklog);
+    oJsonConf.Get("accept_batch", m_stNodeInfo.uiAcceptBatch);
+    oJsonConf.Get("connection_protection", m_stNodeInfo.dConnectionProtection);
+    oJsonConf["permission"]["addr_permit"].Get("stat_interval", m_stNodeInfo.dAddrStatInterval);
+    oJsonConf["permission"]["addr_permit"].Get("permit_num", m_stNodeInfo.iAddrPermitNum);
+
+    std::string strBindIp;
+    if (!oJsonConf.Get("bind_ip", strBindIp) || strBindIp.length() == 0)
+    {
+        strBindIp = m_stNodeInfo.strHostForClient;
+    }
+    std::set<int> setPort;
+    if (m_stNodeInfo.iPortForClient > 0)
+    {
+        setPort.insert(m_stNodeInfo.iPortForClient);
+    }
+    int iPort = 0;
+    for (int i = 0; i < oJsonConf["access_ports"].GetArraySize(); ++i)
+    {
+        if (oJsonConf["access_ports"].Get(i, iPort) && iPort > 0)
+        {
+            setPort.insert(iPort);
+        }
+    }
+    for (auto it = setPort.begin(); it != setPort.end(); ++it)
+    {
+        // access_port_to_worker指定了该端口的Worker时，只有这些Worker监听
+        CJsonObject& oPortWorkers = oJsonConf["access_port_to_worker"][std::to_string(*it)];
+        bool bListen = (oPortWorkers.GetArraySize() == 0);
+        for (int i = 0; i < oPortWorkers.GetArraySize(); ++i)
+        {
+            int iWorkerIndex = 0;
+            if (oPortWorkers.Get(i, iWorkerIndex) && iWorkerIndex == m_stWorkerInfo.iWorkerIndex)
+            {
+                bListen = true;
+                break;
+            }
+        }
+        if (!bListen)
+        {
+            continue;
+        }
+        int iListenFd = -1;
+        int iFamily = AF_INET;
+        if (!m_pDispatcher->CreateListenFd(strBindIp, *it, m_stNodeInfo.iBacklog, iListenFd, iFamily, true))
+        {
+            LOG4_FATAL("create reuseport listen fd for port %d failed!", *it);
+            return(false);
+        }
+        // 组内序号即Worker的监听顺序，Worker依次Init，由第一个Worker挂载BPF程序
+        if (m_stNodeInfo.bReusePortCpuBpf && oPortWorkers.GetArraySize() == 0 && m_stWorkerInfo.iWorkerIndex == 1)
+        {
+            m_pDispatcher->AttachReusePortCpuBpf(iListenFd, m_stNodeInfo.uiWorkerNum);
+        }
+        m_stWorkerInfo.mapAccessFdFamily.insert(std::make_pair(iListenFd, iFamily));
+    }
+    return(true);
+}
+
 void Worker::StartService()
 {
     MsgHead oMsgHead;
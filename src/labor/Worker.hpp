@@ -178,6 +178,8 @@ protected:
     bool NewDispatcher();
     bool NewActorBuilder();
     bool CreateEvents();
+    bool CreateReusePortListener(CJsonObject& oJsonConf);   ///< reuseport模式下创建本Worker的对Client监听fd
+    uint32 GetLoopCpuTime();            ///< 自上次调用以来事件循环每次迭代的平均CPU时间（微秒）
     void StartService();
     void Destroy();
     bool AddPeriodicTaskEvent();
@@ -193,6 +195,8 @@ private:
     CJsonObject m_oCustomConf;    ///< 自定义配置
     NodeInfo m_stNodeInfo;
     WorkerInfo m_stWorkerInfo;
+    uint64 m_ullLastCpuTime = 0;            ///< 上次数据上报时的CPU时间（微秒）
+    uint32 m_uiLastLoopIteration = 0;       ///< 上次数据上报时的事件循环迭代次数
 
     std::shared_ptr<NetLogger> m_pLogger = nullptr;
 };
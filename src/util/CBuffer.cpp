@@ -90,26 +90,24 @@ int CBuffer::WriteFD(int fd, int& err)
 
 int CBuffer::ReadFD(int fd, int& err)
 {
-    char extrabuf[32768];
-    struct iovec vec[2];
-    size_t writable = WriteableBytes();
-    vec[0].iov_base = m_buffer + m_write_idx;
-    vec[0].iov_len = writable;
-    vec[1].iov_base = extrabuf;
-    vec[1].iov_len = sizeof(extrabuf);
-    int n = readv(fd, vec, writable > sizeof(extrabuf) ? 1 : 2);
-    if (n < 0)
+    return ReadFD(fd, BUFFER_MAX_READ, err);
+}
+
+int CBuffer::ReadFD(int fd, size_t readSize, int& err)
+{
+    if (!EnsureWritableBytes(readSize))
     {
-        err = errno;
+        err = ENOMEM;
+        return -1;
     }
-    else if ((size_t) n <= writable)
+    int n = ::read(fd, m_buffer + m_write_idx, WriteableBytes());
+    if (n < 0)
     {
-        m_write_idx += n;
+        err = errno;
     }
     else
     {
-        m_write_idx = m_buffer_len;
-        Write(extrabuf, n - writable);
+        m_write_idx += n;
     }
     return n;
 }
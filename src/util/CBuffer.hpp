@@ -21,6 +21,8 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <utility>
+#include "CBufferPool.hpp"
 
 namespace neb
 {
@@ -116,9 +118,10 @@ class CBuffer
             uint32_t readableBytes = ReadableBytes();
             uint32_t total = Capacity();
             char* newSpace = NULL;
+            size_t newCapacity = 0;
             if (readableBytes > 0)
             {
-                newSpace = (char*) malloc(readableBytes);
+                newSpace = CBufferPool::Instance().Allocate(readableBytes, newCapacity);
                 if (NULL == newSpace)
                 {
                     return 0;
@@ -127,13 +130,17 @@ class CBuffer
             }
             if(NULL != m_buffer)
             {
-                free(m_buffer);
+                CBufferPool::Instance().Free(m_buffer, m_buffer_len);
             }
             m_read_idx = 0;
             m_write_idx = readableBytes;
-            m_buffer_len = readableBytes;
+            m_buffer_len = newCapacity;
             m_buffer = newSpace;
-            return total - readableBytes;
+            if (total <= newCapacity)
+            {
+                return 0;
+            }
+            return total - newCapacity;
         }
 
         inline bool EnsureWritableBytes(size_t minWritableBytes)
@@ -148,6 +155,11 @@ class CBuffer
             }
             else
             {
+                if (m_read_idx > 0 && m_buffer_len - ReadableBytes() >= minWritableBytes)
+                {
+                    DiscardReadedBytes();
+                    return true;
+                }
                 size_t newCapacity = Capacity();
                 if (newCapacity > BUFFER_MAX_READ)
                 {
@@ -157,24 +169,26 @@ class CBuffer
                 {
                     newCapacity = DEFAULT_BUFFER_SIZE;
                 }
-                size_t minNewCapacity = GetWriteIndex()
-                        + minWritableBytes;
+                size_t minNewCapacity = ReadableBytes() + minWritableBytes;
                 while (newCapacity < minNewCapacity)
                 {
                     newCapacity <<= 1;
                 }
-                char* tmp = NULL;
-
-                //tmp = (char*) realloc(m_buffer, newCapacity);
-                tmp = (char*)malloc(newCapacity);
+                char* tmp = CBufferPool::Instance().Allocate(newCapacity, newCapacity);
                 if (NULL != tmp)
                 {
-                    memcpy(tmp, m_buffer + m_read_idx, ReadableBytes());
-//                    memcpy(tmp, m_buffer, m_buffer_len);
-                    free(m_buffer);
+                    size_t readable = ReadableBytes();
+                    if (readable > 0)
+                    {
+                        memcpy(tmp, m_buffer + m_read_idx, readable);
+                    }
+                    if (NULL != m_buffer)
+                    {
+                        CBufferPool::Instance().Free(m_buffer, m_buffer_len);
+                    }
                     m_buffer = tmp;
                     m_buffer_len = newCapacity;
-                    m_write_idx = ReadableBytes();
+                    m_write_idx = readable;
                     m_read_idx = 0;
                     return true;
                 }
@@ -340,14 +354,46 @@ class CBuffer
         int Printf(const char *fmt, ...);
         int VPrintf(const char *fmt, va_list ap);
         int ReadFD(int fd, int& err);
+        /**
+         * @brief 保证至少readSize字节的可写空间后，直接读入缓冲区（不经过栈上中转缓冲区）
+         */
+        int ReadFD(int fd, size_t readSize, int& err);
         int WriteFD(int fd, int& err);
         inline CBuffer(size_t size) :
-            m_buffer(NULL), m_buffer_len(0), m_write_idx(0),
-                    m_read_idx(0)
+            m_buffer(NULL), m_external_readonly_buffer(NULL),
+            m_buffer_len(0), m_write_idx(0), m_read_idx(0)
         {
             EnsureWritableBytes(size);
         }
 
+        inline void Swap(CBuffer& other)
+        {
+            std::swap(m_buffer, other.m_buffer);
+            std::swap(m_external_readonly_buffer, other.m_external_readonly_buffer);
+            std::swap(m_buffer_len, other.m_buffer_len);
+            std::swap(m_write_idx, other.m_write_idx);
+            std::swap(m_read_idx, other.m_read_idx);
+        }
+
+        /**
+         * @brief 没有待读数据时释放存储空间，下次写入时重新分配
+         */
+        inline bool Release()
+        {
+            if (m_external_readonly_buffer != NULL || Readable())
+            {
+                return false;
+            }
+            if (NULL != m_buffer)
+            {
+                CBufferPool::Instance().Free(m_buffer, m_buffer_len);
+                m_buffer = NULL;
+            }
+            m_buffer_len = 0;
+            m_write_idx = m_read_idx = 0;
+            return true;
+        }
+
         inline std::string ToString()
         {
             return std::string(m_buffer + m_read_idx, ReadableBytes());
@@ -358,7 +404,7 @@ class CBuffer
             {
                 if (m_buffer != NULL)
                 {
-                    free(m_buffer);
+                    CBufferPool::Instance().Free(m_buffer, m_buffer_len);
                 }
                 m_buffer = NULL;
             }
@@ -0,0 +1,545 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CBufferChain.cpp
+ * @brief    分段发送队列
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/sendfile.h>
+#include <linux/errqueue.h>
+#include "CBufferChain.hpp"
+
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#ifndef SO_EE_ORIGIN_ZEROCOPY
+#define SO_EE_ORIGIN_ZEROCOPY 5
+#endif
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
+
+namespace neb
+{
+
+CBufferChain::CBufferChain()
+    : m_uiReadableBytes(0), m_uiFileBytes(0), m_uiZeroCopyThreshold(0),
+      m_uiZeroCopyNextId(0), m_uiZeroCopyDoneId(0), m_ullZeroCopyCopiedNum(0)
+{
+}
+
+CBufferChain::~CBufferChain()
+{
+    Clear();
+    for (auto iter = m_dequePinned.begin(); iter != m_dequePinned.end(); ++iter)
+    {
+        FreeSegment(*iter);
+    }
+}
+
+bool CBufferChain::Append(CBuffer* pBuff)
+{
+    if (pBuff == nullptr)
+    {
+        return(false);
+    }
+    size_t uiLen = pBuff->ReadableBytes();
+    if (uiLen == 0)
+    {
+        return(true);
+    }
+    if (uiLen <= COALESCE_SIZE)
+    {
+        CBuffer* pTail = WritableTail(uiLen);
+        if (pTail == nullptr)
+        {
+            return(false);
+        }
+        if (pTail->Write(pBuff, uiLen) != (int)uiLen)
+        {
+            return(false);
+        }
+    }
+    else
+    {
+        CBuffer* pTail = NewTailBuffer(0);
+        if (pTail == nullptr)
+        {
+            return(false);
+        }
+        pTail->Swap(*pBuff);
+    }
+    m_uiReadableBytes += uiLen;
+    return(true);
+}
+
+bool CBufferChain::Append(std::string&& strBlock)
+{
+    if (strBlock.empty())
+    {
+        return(true);
+    }
+    size_t uiLen = strBlock.size();
+    try
+    {
+        m_dequeSegment.emplace_back();
+    }
+    catch(std::bad_alloc& e)
+    {
+        return(false);
+    }
+    m_dequeSegment.back().strBlock = std::move(strBlock);
+    CBufferPool::Instance().AddInUseBytes(m_dequeSegment.back().strBlock.capacity());
+    m_uiReadableBytes += uiLen;
+    return(true);
+}
+
+bool CBufferChain::Append(const char* pData, size_t uiLen)
+{
+    if (uiLen == 0)
+    {
+        return(true);
+    }
+    CBuffer* pTail = WritableTail(uiLen);
+    if (pTail == nullptr)
+    {
+        return(false);
+    }
+    if (pTail->Write(pData, uiLen) != (int)uiLen)
+    {
+        return(false);
+    }
+    m_uiReadableBytes += uiLen;
+    return(true);
+}
+
+bool CBufferChain::AppendFile(int iFileFd, uint64_t uiOffset, size_t uiLen)
+{
+    if (uiLen == 0)
+    {
+        return(true);
+    }
+    int iDupFd = ::fcntl(iFileFd, F_DUPFD_CLOEXEC, 0);
+    if (iDupFd < 0)
+    {
+        return(false);
+    }
+    try
+    {
+        m_dequeSegment.emplace_back();
+    }
+    catch(std::bad_alloc& e)
+    {
+        ::close(iDupFd);
+        return(false);
+    }
+    tagSegment& stSegment = m_dequeSegment.back();
+    stSegment.iFileFd = iDupFd;
+    stSegment.uiFileOffset = uiOffset;
+    stSegment.uiFileBytes = uiLen;
+    m_uiFileBytes += uiLen;
+    m_uiReadableBytes += uiLen;
+    return(true);
+}
+
+bool CBufferChain::Peek(const char*& pData, size_t& uiLen) const
+{
+    if (m_dequeSegment.empty() || m_dequeSegment.front().IsFile())
+    {
+        return(false);
+    }
+    pData = m_dequeSegment.front().GetRawReadBuffer();
+    uiLen = m_dequeSegment.front().ReadableBytes();
+    return(true);
+}
+
+int CBufferChain::PinRingSend(struct iovec* pVec, int iMaxIov)
+{
+    int iVecNum = 0;
+    for (auto iter = m_dequeSegment.begin();
+            iter != m_dequeSegment.end() && iVecNum < iMaxIov; ++iter)
+    {
+        if (iter->IsFile())
+        {
+            break;
+        }
+        iter->bRingSend = true;     // 引用的段连续位于队首，RingSendDone()据此解除引用
+        size_t uiLen = iter->ReadableBytes();
+        if (uiLen == 0)
+        {
+            continue;
+        }
+        pVec[iVecNum].iov_base = const_cast<char*>(iter->GetRawReadBuffer());
+        pVec[iVecNum].iov_len = uiLen;
+        ++iVecNum;
+    }
+    return(iVecNum);
+}
+
+void CBufferChain::RingSendDone(size_t uiLen)
+{
+    for (auto iter = m_dequeSegment.begin(); iter != m_dequeSegment.end() && iter->bRingSend; ++iter)
+    {
+        iter->bRingSend = false;
+    }
+    Skip(uiLen);
+    // 发送未完成时被Clear()转入待确认队列的段
+    for (auto iter = m_dequePinned.begin(); iter != m_dequePinned.end();)
+    {
+        if (iter->bRingSend)
+        {
+            FreeSegment(*iter);
+            iter = m_dequePinned.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+void CBufferChain::Skip(size_t uiLen)
+{
+    while (uiLen > 0 && !m_dequeSegment.empty())
+    {
+        tagSegment& stSegment = m_dequeSegment.front();
+        size_t uiSegmentLen = stSegment.ReadableBytes();
+        if (uiLen < uiSegmentLen)
+        {
+            if (stSegment.IsFile())
+            {
+                stSegment.uiFileOffset += uiLen;
+                stSegment.uiFileBytes -= uiLen;
+                m_uiFileBytes -= uiLen;
+            }
+            else if (stSegment.pBuff == nullptr)
+            {
+                stSegment.uiBlockOffset += uiLen;
+            }
+            else
+            {
+                stSegment.pBuff->SkipBytes(uiLen);
+            }
+            m_uiReadableBytes -= uiLen;
+            return;
+        }
+        uiLen -= uiSegmentLen;
+        m_uiReadableBytes -= uiSegmentLen;
+        if (stSegment.IsFile())
+        {
+            m_uiFileBytes -= uiSegmentLen;
+        }
+        PopFront();
+    }
+}
+
+void CBufferChain::Clear()
+{
+    // 待确认的零拷贝段也在此释放，而内核可能仍在从这些页面取数据发送，
+    // 连接关闭前须先用TakeZeroCopyPending()转移（见Dispatcher::LingerZeroCopy()）；
+    // io_uring发送引用的段保留到RingSendDone()
+    std::deque<tagSegment> dequeRingSend;
+    for (auto iter = m_dequePinned.begin(); iter != m_dequePinned.end(); ++iter)
+    {
+        if (iter->bRingSend)
+        {
+            dequeRingSend.push_back(std::move(*iter));
+            iter->pBuff = nullptr;
+        }
+        else
+        {
+            FreeSegment(*iter);
+        }
+    }
+    for (auto iter = m_dequeSegment.begin(); iter != m_dequeSegment.end(); ++iter)
+    {
+        if (iter->bRingSend)
+        {
+            dequeRingSend.push_back(std::move(*iter));
+            iter->pBuff = nullptr;
+        }
+        else
+        {
+            FreeSegment(*iter);
+        }
+    }
+    m_dequeSegment.clear();
+    m_dequePinned.swap(dequeRingSend);
+    m_uiZeroCopyDoneId = m_uiZeroCopyNextId;
+    m_uiReadableBytes = 0;
+    m_uiFileBytes = 0;
+}
+
+bool CBufferChain::Release()
+{
+    if (m_uiReadableBytes > 0 || !m_dequePinned.empty())
+    {
+        return(false);
+    }
+    Clear();
+    std::deque<tagSegment>().swap(m_dequeSegment);
+    std::deque<tagSegment>().swap(m_dequePinned);
+    return(true);
+}
+
+size_t CBufferChain::Capacity() const
+{
+    size_t uiCapacity = 0;
+    for (auto iter = m_dequeSegment.begin(); iter != m_dequeSegment.end(); ++iter)
+    {
+        uiCapacity += (iter->pBuff == nullptr) ? iter->strBlock.capacity() : iter->pBuff->Capacity();
+    }
+    for (auto iter = m_dequePinned.begin(); iter != m_dequePinned.end(); ++iter)
+    {
+        uiCapacity += (iter->pBuff == nullptr) ? iter->strBlock.capacity() : iter->pBuff->Capacity();
+    }
+    return(uiCapacity);
+}
+
+ssize_t CBufferChain::WriteFD(int fd, int& err)
+{
+    if (m_uiReadableBytes == 0)
+    {
+        return 0;
+    }
+    if (m_dequeSegment.front().IsFile())
+    {
+        return(SendFile(fd, err));
+    }
+    struct iovec vec[MAX_IOV];
+    int iVecNum = 0;
+    size_t uiVecBytes = 0;
+    int iMoreFlag = 0;
+    for (auto iter = m_dequeSegment.begin();
+            iter != m_dequeSegment.end() && iVecNum < MAX_IOV; ++iter)
+    {
+        if (iter->IsFile())
+        {
+            iMoreFlag = MSG_MORE;   // 后面紧跟文件内容，避免头部单独成包
+            break;
+        }
+        size_t uiLen = iter->ReadableBytes();
+        if (uiLen == 0)
+        {
+            continue;
+        }
+        vec[iVecNum].iov_base = const_cast<char*>(iter->GetRawReadBuffer());
+        vec[iVecNum].iov_len = uiLen;
+        uiVecBytes += uiLen;
+        ++iVecNum;
+    }
+    struct msghdr stMsg;
+    memset(&stMsg, 0, sizeof(stMsg));
+    stMsg.msg_iov = vec;
+    stMsg.msg_iovlen = iVecNum;
+    ssize_t n = -1;
+    if (m_uiZeroCopyThreshold > 0 && uiVecBytes >= m_uiZeroCopyThreshold)
+    {
+        n = ::sendmsg(fd, &stMsg, MSG_NOSIGNAL | MSG_ZEROCOPY | iMoreFlag);
+        if (n > 0)
+        {
+            // 本次发送引用到的段在内核确认前不可释放或再写入
+            int iVecIndex = 0;
+            for (auto iter = m_dequeSegment.begin();
+                    iter != m_dequeSegment.end() && iVecIndex < iVecNum; ++iter)
+            {
+                if (iter->ReadableBytes() == 0)
+                {
+                    continue;
+                }
+                iter->bZeroCopy = true;
+                iter->uiZeroCopyId = m_uiZeroCopyNextId;
+                ++iVecIndex;
+            }
+            ++m_uiZeroCopyNextId;
+        }
+        else if (n < 0 && errno == ENOBUFS)    // 超出optmem限制，退化为普通发送
+        {
+            n = ::sendmsg(fd, &stMsg, MSG_NOSIGNAL | iMoreFlag);
+        }
+    }
+    else
+    {
+        n = ::sendmsg(fd, &stMsg, MSG_NOSIGNAL | iMoreFlag);
+    }
+    if (n < 0)
+    {
+        err = errno;
+    }
+    else
+    {
+        Skip(n);
+    }
+    return (n);
+}
+
+ssize_t CBufferChain::SendFile(int fd, int& err)
+{
+    tagSegment& stSegment = m_dequeSegment.front();
+    off_t lOffset = (off_t)stSegment.uiFileOffset;
+    size_t uiLen = (stSegment.uiFileBytes > SENDFILE_SIZE) ? SENDFILE_SIZE : stSegment.uiFileBytes;
+    ssize_t n = ::sendfile(fd, stSegment.iFileFd, &lOffset, uiLen);
+    if (n < 0)
+    {
+        err = errno;
+        return(-1);
+    }
+    if (n == 0)     // 文件在发送过程中被截短，剩余数据已无法发出
+    {
+        err = EIO;
+        return(-1);
+    }
+    Skip(n);
+    return(n);
+}
+
+int CBufferChain::ReapZeroCopy(int fd)
+{
+    int iNoticeNum = 0;
+    char szControl[128];
+    while (ZeroCopyPending())
+    {
+        struct msghdr stMsg;
+        memset(&stMsg, 0, sizeof(stMsg));
+        stMsg.msg_control = szControl;
+        stMsg.msg_controllen = sizeof(szControl);
+        if (::recvmsg(fd, &stMsg, MSG_ERRQUEUE) < 0)
+        {
+            break;
+        }
+        for (struct cmsghdr* pCmsg = CMSG_FIRSTHDR(&stMsg); pCmsg != nullptr; pCmsg = CMSG_NXTHDR(&stMsg, pCmsg))
+        {
+            if (!((pCmsg->cmsg_level == SOL_IP && pCmsg->cmsg_type == IP_RECVERR)
+                    || (pCmsg->cmsg_level == SOL_IPV6 && pCmsg->cmsg_type == IPV6_RECVERR)))
+            {
+                continue;
+            }
+            struct sock_extended_err* pErr = (struct sock_extended_err*)CMSG_DATA(pCmsg);
+            if (pErr->ee_errno != 0 || pErr->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+            {
+                continue;
+            }
+            if (pErr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+            {
+                ++m_ullZeroCopyCopiedNum;
+            }
+            // [ee_info, ee_data]为本次完成的发送序号区间，通知按序到达
+            if ((int32_t)(pErr->ee_data + 1 - m_uiZeroCopyDoneId) > 0)
+            {
+                m_uiZeroCopyDoneId = pErr->ee_data + 1;
+            }
+            ++iNoticeNum;
+        }
+    }
+    while (!m_dequePinned.empty() && !m_dequePinned.front().bRingSend
+            && ZeroCopyDone(m_dequePinned.front().uiZeroCopyId))
+    {
+        FreeSegment(m_dequePinned.front());
+        m_dequePinned.pop_front();
+    }
+    return(iNoticeNum);
+}
+
+void CBufferChain::TakeZeroCopyPending(CBufferChain& oChain)
+{
+    // 先转移已发送完的段，再转移发送了一部分的段，保持零拷贝序号递增
+    for (auto iter = oChain.m_dequePinned.begin(); iter != oChain.m_dequePinned.end(); ++iter)
+    {
+        m_dequePinned.push_back(std::move(*iter));
+        iter->pBuff = nullptr;
+    }
+    oChain.m_dequePinned.clear();
+    for (auto iter = oChain.m_dequeSegment.begin(); iter != oChain.m_dequeSegment.end(); ++iter)
+    {
+        if (iter->bZeroCopy && !oChain.ZeroCopyDone(iter->uiZeroCopyId))
+        {
+            m_dequePinned.push_back(std::move(*iter));
+            iter->pBuff = nullptr;
+        }
+    }
+    m_uiZeroCopyNextId = oChain.m_uiZeroCopyNextId;
+    m_uiZeroCopyDoneId = oChain.m_uiZeroCopyDoneId;
+    oChain.m_uiZeroCopyDoneId = oChain.m_uiZeroCopyNextId;
+}
+
+CBuffer* CBufferChain::NewTailBuffer(size_t uiMinSize)
+{
+    CBuffer* pBuff = nullptr;
+    try
+    {
+        m_dequeSegment.emplace_back();
+        if (uiMinSize > 0)
+        {
+            pBuff = new CBuffer((uiMinSize > SEGMENT_SIZE) ? uiMinSize : SEGMENT_SIZE);
+        }
+        else
+        {
+            pBuff = new CBuffer();
+        }
+    }
+    catch(std::bad_alloc& e)
+    {
+        if (!m_dequeSegment.empty() && m_dequeSegment.back().pBuff == nullptr
+                && m_dequeSegment.back().strBlock.empty() && !m_dequeSegment.back().IsFile())
+        {
+            m_dequeSegment.pop_back();
+        }
+        return(nullptr);
+    }
+    m_dequeSegment.back().pBuff = pBuff;
+    return(pBuff);
+}
+
+CBuffer* CBufferChain::WritableTail(size_t uiLen)
+{
+    if (!m_dequeSegment.empty() && m_dequeSegment.back().pBuff != nullptr
+            && !m_dequeSegment.back().bZeroCopy && !m_dequeSegment.back().bRingSend
+            && m_dequeSegment.back().pBuff->WriteableBytes() >= uiLen)
+    {
+        return(m_dequeSegment.back().pBuff);
+    }
+    return(NewTailBuffer(uiLen));
+}
+
+void CBufferChain::PopFront()
+{
+    tagSegment& stSegment = m_dequeSegment.front();
+    if (stSegment.bRingSend || (stSegment.bZeroCopy && !ZeroCopyDone(stSegment.uiZeroCopyId)))
+    {
+        m_dequePinned.push_back(std::move(stSegment));
+        stSegment.pBuff = nullptr;
+    }
+    else
+    {
+        FreeSegment(stSegment);
+    }
+    m_dequeSegment.pop_front();
+}
+
+void CBufferChain::FreeSegment(tagSegment& stSegment)
+{
+    if (stSegment.pBuff != nullptr)
+    {
+        delete stSegment.pBuff;
+        stSegment.pBuff = nullptr;
+    }
+    if (!stSegment.strBlock.empty())
+    {
+        CBufferPool::Instance().AddInUseBytes(-(int64_t)stSegment.strBlock.capacity());
+        std::string().swap(stSegment.strBlock);
+    }
+    if (stSegment.iFileFd >= 0)
+    {
+        ::close(stSegment.iFileFd);
+        stSegment.iFileFd = -1;
+    }
+}
+
+} /* namespace neb */
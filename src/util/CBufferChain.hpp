@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CBufferChain.hpp
+ * @brief    分段发送队列
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     待发送数据由若干段组成：CBuffer段（小消息合并写入，大消息直接接管
+ *           编码缓冲区的存储空间）和外部数据块段（接管所有权，不拷贝）。发送时
+ *           一次sendmsg()写出多个段，已发送的段整段释放，不会对积压数据做memmove。
+ *           开启零拷贝（MSG_ZEROCOPY）后，大于阈值的发送由内核直接引用段的存储空间，
+ *           这些段在发送完后转入待确认队列，直到从socket错误队列读到内核的完成通知才释放。
+ *           文件段只记录文件描述符和区间，轮到该段时以sendfile()发送，数据不进入用户态。
+ *           io_uring发送同样直接引用段的存储空间，被引用的段在发送完成前不释放、不再写入。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_UTIL_CBUFFERCHAIN_HPP_
+#define SRC_UTIL_CBUFFERCHAIN_HPP_
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <sys/uio.h>
+#include "CBuffer.hpp"
+
+namespace neb
+{
+
+class CBufferChain
+{
+public:
+    static const size_t SEGMENT_SIZE = 16384;       ///< CBuffer段初始容量
+    static const size_t COALESCE_SIZE = 4096;       ///< 不大于此长度的数据合并写入尾部CBuffer段
+    static const int MAX_IOV = 64;                  ///< 单次sendmsg()最多写出的段数
+    static const size_t SENDFILE_SIZE = 1048576;    ///< 单次sendfile()最多写出的字节数
+
+    CBufferChain();
+    virtual ~CBufferChain();
+
+    inline size_t ReadableBytes() const
+    {
+        return m_uiReadableBytes;
+    }
+    inline bool Empty() const
+    {
+        return m_uiReadableBytes == 0;
+    }
+    /** @brief 待发送数据中文件段的字节数（不占用内存） */
+    inline size_t FileBytes() const
+    {
+        return m_uiFileBytes;
+    }
+    inline size_t SegmentNum() const
+    {
+        return m_dequeSegment.size();
+    }
+
+    /**
+     * @brief 把pBuff的全部可读数据追加到队列尾部
+     * @note 较小的数据拷贝到尾部CBuffer段；较大的数据直接接管pBuff的存储空间，
+     *       pBuff被置为空缓冲区。
+     */
+    bool Append(CBuffer* pBuff);
+
+    /** @brief 追加外部数据块（接管所有权，不拷贝） */
+    bool Append(std::string&& strBlock);
+
+    /** @brief 拷贝追加数据 */
+    bool Append(const char* pData, size_t uiLen);
+
+    /**
+     * @brief 追加文件段，发送时以sendfile()从文件的uiOffset位置起发送uiLen字节
+     * @note 队列持有iFileFd的副本（dup），调用方可在追加后关闭iFileFd。
+     */
+    bool AppendFile(int iFileFd, uint64_t uiOffset, size_t uiLen);
+
+    /**
+     * @brief 获取队首段的可读数据
+     * @return 队列为空或队首为文件段时返回false
+     */
+    bool Peek(const char*& pData, size_t& uiLen) const;
+
+    /**
+     * @brief 以队首的内存段填充pVec，供异步发送（io_uring）直接引用
+     * @return iovec数，队列为空或队首为文件段时返回0
+     * @note 被引用的段在RingSendDone()之前不释放、不再写入，期间Clear()也只是把它们转入
+     *       待确认队列；调用方须保证发送未完成时不以其他方式从队列移除数据。
+     */
+    int PinRingSend(struct iovec* pVec, int iMaxIov);
+
+    /** @brief 异步发送完成，丢弃队首uiLen字节并解除PinRingSend()对段的引用 */
+    void RingSendDone(size_t uiLen);
+
+    /** @brief 丢弃队首uiLen字节数据 */
+    void Skip(size_t uiLen);
+
+    void Clear();
+
+    /**
+     * @brief 设置零拷贝发送阈值
+     * @note 单次sendmsg()的数据量不小于阈值时使用MSG_ZEROCOPY，0为关闭。调用方需先对socket设置SO_ZEROCOPY。
+     */
+    void SetZeroCopyThreshold(uint32_t uiThreshold)
+    {
+        m_uiZeroCopyThreshold = uiThreshold;
+    }
+    uint32_t GetZeroCopyThreshold() const
+    {
+        return(m_uiZeroCopyThreshold);
+    }
+
+    /** @brief 是否有等待内核确认的零拷贝发送 */
+    bool ZeroCopyPending() const
+    {
+        return(m_uiZeroCopyNextId != m_uiZeroCopyDoneId);
+    }
+
+    /**
+     * @brief 读取socket错误队列中的零拷贝完成通知，释放内核已不再引用的段
+     * @return 读到的完成通知数量
+     */
+    int ReapZeroCopy(int fd);
+
+    /**
+     * @brief 把oChain中仍被内核零拷贝引用的段和发送序号转移到本队列
+     * @note 连接关闭前调用，之后oChain可以安全Clear()；本队列继续以socket的副本fd
+     *       调用ReapZeroCopy()，直到ZeroCopyPending()为false再释放。
+     */
+    void TakeZeroCopyPending(CBufferChain& oChain);
+
+    /** @brief 内核未能零拷贝而退化为拷贝发送的次数 */
+    uint64_t GetZeroCopyCopiedNum() const
+    {
+        return(m_ullZeroCopyCopiedNum);
+    }
+
+    /** @brief 队列为空时释放队列自身占用的存储空间 */
+    bool Release();
+
+    /** @brief 队列占用的存储空间字节数 */
+    size_t Capacity() const;
+
+    /**
+     * @brief 以一次sendmsg()写出尽可能多的段
+     * @return 写出的字节数，出错返回-1并设置err
+     */
+    ssize_t WriteFD(int fd, int& err);
+
+private:
+    struct tagSegment
+    {
+        CBuffer* pBuff = nullptr;       ///< CBuffer段（二选一）
+        std::string strBlock;           ///< 外部数据块段（二选一）
+        size_t uiBlockOffset = 0;       ///< 外部数据块已发送的字节数
+        bool bZeroCopy = false;         ///< 是否被零拷贝发送引用过（引用过的段不可再写入）
+        uint32_t uiZeroCopyId = 0;      ///< 最后一次引用该段的零拷贝发送序号
+        bool bRingSend = false;         ///< 被未完成的io_uring发送引用
+        int iFileFd = -1;               ///< 文件段的文件描述符（文件段不含pBuff和strBlock）
+        uint64_t uiFileOffset = 0;      ///< 文件段下一个待发送字节在文件中的位置
+        size_t uiFileBytes = 0;         ///< 文件段待发送的字节数
+
+        bool IsFile() const
+        {
+            return iFileFd >= 0;
+        }
+        size_t ReadableBytes() const
+        {
+            if (IsFile())
+            {
+                return uiFileBytes;
+            }
+            return (pBuff == nullptr) ? strBlock.size() - uiBlockOffset : pBuff->ReadableBytes();
+        }
+        const char* GetRawReadBuffer() const
+        {
+            return (pBuff == nullptr) ? strBlock.data() + uiBlockOffset : pBuff->GetRawReadBuffer();
+        }
+    };
+
+    CBuffer* NewTailBuffer(size_t uiMinSize);
+    CBuffer* WritableTail(size_t uiLen);
+    void PopFront();
+    void FreeSegment(tagSegment& stSegment);
+    ssize_t SendFile(int fd, int& err);
+    bool ZeroCopyDone(uint32_t uiId) const
+    {
+        return((int32_t)(uiId - m_uiZeroCopyDoneId) < 0);
+    }
+
+private:
+    size_t m_uiReadableBytes;               ///< 含文件段的字节数
+    size_t m_uiFileBytes;
+    uint32_t m_uiZeroCopyThreshold;
+    uint32_t m_uiZeroCopyNextId;            ///< 下一次零拷贝发送的序号（与内核的计数一致）
+    uint32_t m_uiZeroCopyDoneId;            ///< 小于此序号的零拷贝发送均已完成
+    uint64_t m_ullZeroCopyCopiedNum;
+    std::deque<tagSegment> m_dequeSegment;
+    std::deque<tagSegment> m_dequePinned;   ///< 已发送完、等待内核完成通知的零拷贝段和io_uring发送段
+};
+
+} /* namespace neb */
+
+#endif /* SRC_UTIL_CBUFFERCHAIN_HPP_ */
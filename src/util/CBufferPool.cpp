@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CBufferPool.cpp
+ * @brief    CBuffer存储空间分配器
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include <stdlib.h>
+#include <cstring>
+#include "CBufferPool.hpp"
+
+namespace neb
+{
+
+CBufferPool::CBufferPool()
+    : m_uiCachedBytes(0), m_llInUseBytes(0), m_ullHitNum(0), m_ullMissNum(0), m_ullOversizeNum(0)
+{
+    memset(m_aullClassHitNum, 0, sizeof(m_aullClassHitNum));
+    memset(m_aullClassMissNum, 0, sizeof(m_aullClassMissNum));
+}
+
+CBufferPool::~CBufferPool()
+{
+    Trim();
+}
+
+CBufferPool& CBufferPool::Instance()
+{
+    static thread_local CBufferPool s_oPool;
+    return(s_oPool);
+}
+
+char* CBufferPool::Allocate(size_t uiSize, size_t& uiCapacity)
+{
+    if (uiSize > ClassSize(CLASS_NUM - 1))
+    {
+        ++m_ullOversizeNum;
+        uiCapacity = uiSize;
+        char* pBlock = (char*)malloc(uiSize);
+        if (pBlock != NULL)
+        {
+            m_llInUseBytes += uiCapacity;
+        }
+        return(pBlock);
+    }
+    size_t uiClass = CeilClass(uiSize);
+    uiCapacity = ClassSize(uiClass);
+    if (m_vecFreeList[uiClass].empty())
+    {
+        ++m_ullMissNum;
+        ++m_aullClassMissNum[uiClass];
+        char* pBlock = (char*)malloc(uiCapacity);
+        if (pBlock != NULL)
+        {
+            m_llInUseBytes += uiCapacity;
+        }
+        return(pBlock);
+    }
+    ++m_ullHitNum;
+    ++m_aullClassHitNum[uiClass];
+    char* pBlock = m_vecFreeList[uiClass].back();
+    m_vecFreeList[uiClass].pop_back();
+    m_uiCachedBytes -= uiCapacity;
+    m_llInUseBytes += uiCapacity;
+    return(pBlock);
+}
+
+void CBufferPool::Free(char* pBlock, size_t uiCapacity)
+{
+    if (pBlock == NULL)
+    {
+        return;
+    }
+    m_llInUseBytes -= uiCapacity;
+    if (uiCapacity < ClassSize(0) || uiCapacity > ClassSize(CLASS_NUM - 1))
+    {
+        free(pBlock);
+        return;
+    }
+    size_t uiClass = FloorClass(uiCapacity);
+    size_t uiClassSize = ClassSize(uiClass);
+    if ((m_vecFreeList[uiClass].size() + 1) * uiClassSize > MAX_CACHED_BYTES_PER_CLASS)
+    {
+        free(pBlock);
+        return;
+    }
+    m_vecFreeList[uiClass].push_back(pBlock);
+    m_uiCachedBytes += uiClassSize;
+}
+
+void CBufferPool::Trim()
+{
+    for (size_t i = 0; i < CLASS_NUM; ++i)
+    {
+        for (auto pBlock : m_vecFreeList[i])
+        {
+            free(pBlock);
+        }
+        m_vecFreeList[i].clear();
+    }
+    m_uiCachedBytes = 0;
+}
+
+void CBufferPool::ResetStat()
+{
+    m_ullHitNum = 0;
+    m_ullMissNum = 0;
+    m_ullOversizeNum = 0;
+    memset(m_aullClassHitNum, 0, sizeof(m_aullClassHitNum));
+    memset(m_aullClassMissNum, 0, sizeof(m_aullClassMissNum));
+}
+
+size_t CBufferPool::CeilClass(size_t uiSize)
+{
+    size_t uiClass = 0;
+    while (ClassSize(uiClass) < uiSize)
+    {
+        ++uiClass;
+    }
+    return(uiClass);
+}
+
+size_t CBufferPool::FloorClass(size_t uiSize)
+{
+    size_t uiClass = CLASS_NUM - 1;
+    while (uiClass > 0 && ClassSize(uiClass) > uiSize)
+    {
+        --uiClass;
+    }
+    return(uiClass);
+}
+
+} /* namespace neb */
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CBufferPool.hpp
+ * @brief    CBuffer存储空间分配器
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     按2的幂划分尺寸等级，每个线程（Worker）一个实例，无锁。超过最大
+ *           等级的块直接malloc/free。所有块均由malloc分配，因此在一个线程分配、
+ *           在另一个线程（如连接迁移后）释放是安全的，块只会归入释放线程的池。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_UTIL_CBUFFERPOOL_HPP_
+#define SRC_UTIL_CBUFFERPOOL_HPP_
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace neb
+{
+
+class CBufferPool
+{
+public:
+    static const size_t MIN_CLASS_SHIFT = 5;                ///< 最小等级 32 bytes
+    static const size_t MAX_CLASS_SHIFT = 16;               ///< 最大等级 64 KB
+    static const size_t CLASS_NUM = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+    static const size_t MAX_CACHED_BYTES_PER_CLASS = 1 << 20;   ///< 每个等级最多缓存的空闲字节数
+
+    virtual ~CBufferPool();
+
+    static CBufferPool& Instance();
+
+    /**
+     * @brief 分配至少uiSize字节的存储空间
+     * @param uiSize 需要的字节数
+     * @param uiCapacity 实际分配的字节数（等级尺寸）
+     * @return 存储空间，失败返回NULL
+     */
+    char* Allocate(size_t uiSize, size_t& uiCapacity);
+
+    /**
+     * @brief 归还存储空间
+     * @param pBlock 由Allocate()分配的存储空间
+     * @param uiCapacity 存储空间的可用字节数（不大于分配时的uiCapacity）
+     */
+    void Free(char* pBlock, size_t uiCapacity);
+
+    /** @brief 释放所有缓存的空闲块 */
+    void Trim();
+
+    /** @brief 尺寸等级对应的字节数 */
+    static size_t ClassSize(size_t uiClass)
+    {
+        return((size_t)1 << (uiClass + MIN_CLASS_SHIFT));
+    }
+
+    uint64_t GetHitNum() const
+    {
+        return(m_ullHitNum);
+    }
+    uint64_t GetMissNum() const
+    {
+        return(m_ullMissNum);
+    }
+    uint64_t GetOversizeNum() const
+    {
+        return(m_ullOversizeNum);
+    }
+    uint64_t GetHitNum(size_t uiClass) const
+    {
+        return((uiClass < CLASS_NUM) ? m_aullClassHitNum[uiClass] : 0);
+    }
+    uint64_t GetMissNum(size_t uiClass) const
+    {
+        return((uiClass < CLASS_NUM) ? m_aullClassMissNum[uiClass] : 0);
+    }
+    size_t GetCachedBytes() const
+    {
+        return(m_uiCachedBytes);
+    }
+    /**
+     * @brief 本线程已分配未归还的存储空间字节数（含CBufferChain外部数据块）
+     * @note 分配和释放时增减，查询为O(1)。存储空间随连接迁移到其他线程时，由迁出方
+     *       和迁入方分别调用AddInUseBytes()转移计数。
+     */
+    int64_t GetInUseBytes() const
+    {
+        return(m_llInUseBytes);
+    }
+    void AddInUseBytes(int64_t llBytes)
+    {
+        m_llInUseBytes += llBytes;
+    }
+    void ResetStat();
+
+private:
+    CBufferPool();
+    CBufferPool(const CBufferPool&) = delete;
+    CBufferPool& operator=(const CBufferPool&) = delete;
+
+    static size_t CeilClass(size_t uiSize);
+    static size_t FloorClass(size_t uiSize);
+
+private:
+    size_t m_uiCachedBytes;
+    int64_t m_llInUseBytes;
+    uint64_t m_ullHitNum;
+    uint64_t m_ullMissNum;
+    uint64_t m_ullOversizeNum;
+    uint64_t m_aullClassHitNum[CLASS_NUM];
+    uint64_t m_aullClassMissNum[CLASS_NUM];
+    std::vector<char*> m_vecFreeList[CLASS_NUM];
+};
+
+} /* namespace neb */
+
+#endif /* SRC_UTIL_CBUFFERPOOL_HPP_ */
@@ -0,0 +1,141 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CComputePool.cpp
+ * @brief    CPU密集型计算线程池
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include "CComputePool.hpp"
+
+namespace neb
+{
+
+CComputePool::CComputePool()
+    : m_uiThreadNum(0), m_uiQueueLimit(DEFAULT_QUEUE_LIMIT), m_bStarted(false),
+      m_uiQueueDepth(0), m_uiIdleNum(0), m_ullExecutedNum(0), m_ullStolenNum(0), m_ullRejectedNum(0)
+{
+}
+
+CComputePool::~CComputePool()
+{
+}
+
+CComputePool& CComputePool::Instance()
+{
+    // 计算线程不退出，实例不随进程退出析构
+    static CComputePool* s_pPool = new CComputePool();
+    return(*s_pPool);
+}
+
+void CComputePool::Configure(uint32_t uiThreadNum, uint32_t uiQueueLimit)
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if (m_bStarted.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    m_uiThreadNum = uiThreadNum;
+    m_uiQueueLimit = (uiQueueLimit > 0) ? uiQueueLimit : DEFAULT_QUEUE_LIMIT;
+}
+
+bool CComputePool::Submit(Task&& fnTask, uint32_t uiHint)
+{
+    if (!m_bStarted.load(std::memory_order_acquire) && !Start())
+    {
+        m_ullRejectedNum.fetch_add(1, std::memory_order_relaxed);
+        return(false);
+    }
+    if (m_uiQueueDepth.fetch_add(1) >= m_uiQueueLimit)
+    {
+        m_uiQueueDepth.fetch_sub(1);
+        m_ullRejectedNum.fetch_add(1, std::memory_order_relaxed);
+        return(false);
+    }
+    tagQueue& stQueue = *m_vecQueue[uiHint % m_vecQueue.size()];
+    {
+        std::lock_guard<std::mutex> oLock(stQueue.oMutex);
+        stQueue.dequeTask.push_back(std::move(fnTask));
+    }
+    // 与Run()中先增加空闲数再检查排队数配对，二者至少有一方能看到对方的修改
+    if (m_uiIdleNum.load() > 0)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_oCond.notify_one();
+    }
+    return(true);
+}
+
+bool CComputePool::Start()
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if (m_bStarted.load(std::memory_order_relaxed))
+    {
+        return(true);
+    }
+    if (m_uiThreadNum == 0)
+    {
+        return(false);
+    }
+    for (uint32_t i = 0; i < m_uiThreadNum; ++i)
+    {
+        m_vecQueue.emplace_back(new tagQueue());
+    }
+    for (uint32_t i = 0; i < m_uiThreadNum; ++i)
+    {
+        std::thread t(&CComputePool::Run, this, i);
+        t.detach();
+    }
+    m_bStarted.store(true, std::memory_order_release);
+    return(true);
+}
+
+bool CComputePool::Pop(uint32_t uiIndex, Task& fnTask)
+{
+    uint32_t uiQueueNum = m_vecQueue.size();
+    for (uint32_t i = 0; i < uiQueueNum; ++i)
+    {
+        tagQueue& stQueue = *m_vecQueue[(uiIndex + i) % uiQueueNum];
+        std::lock_guard<std::mutex> oLock(stQueue.oMutex);
+        if (stQueue.dequeTask.empty())
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            fnTask = std::move(stQueue.dequeTask.front());    // 自己的队列按提交顺序执行
+            stQueue.dequeTask.pop_front();
+        }
+        else
+        {
+            fnTask = std::move(stQueue.dequeTask.back());     // 窃取最新提交的，与队列所属线程错开
+            stQueue.dequeTask.pop_back();
+            m_ullStolenNum.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_uiQueueDepth.fetch_sub(1);
+        return(true);
+    }
+    return(false);
+}
+
+void CComputePool::Run(uint32_t uiIndex)
+{
+    Task fnTask;
+    while (true)
+    {
+        if (Pop(uiIndex, fnTask))
+        {
+            fnTask();
+            fnTask = nullptr;
+            m_ullExecutedNum.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        std::unique_lock<std::mutex> oLock(m_oMutex);
+        m_uiIdleNum.fetch_add(1);
+        m_oCond.wait(oLock, [this]{ return(m_uiQueueDepth.load() > 0); });
+        m_uiIdleNum.fetch_sub(1);
+    }
+}
+
+} /* namespace neb */
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CComputePool.hpp
+ * @brief    CPU密集型计算线程池
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     每个计算线程一个任务队列，提交时按uiHint放入对应队列（同一个Worker的任务
+ *           落在同一个队列），计算线程先从自己队列头部取任务，取不到时从其他队列尾部
+ *           窃取。任务是毫秒级的计算，队列用互斥锁保护即可。每个进程一个实例，
+ *           首次提交任务时才创建线程（进程模式下Manager fork Worker之前不会有计算线程）。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_UTIL_CCOMPUTEPOOL_HPP_
+#define SRC_UTIL_CCOMPUTEPOOL_HPP_
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neb
+{
+
+class CComputePool
+{
+public:
+    typedef std::function<void()> Task;
+
+    static const uint32_t DEFAULT_QUEUE_LIMIT = 65536;
+
+    virtual ~CComputePool();
+
+    static CComputePool& Instance();
+
+    /**
+     * @brief 设置线程数和排队任务数上限
+     * @note 只在第一次提交任务（启动线程）之前有效，uiThreadNum为0时不启用线程池
+     */
+    void Configure(uint32_t uiThreadNum, uint32_t uiQueueLimit = DEFAULT_QUEUE_LIMIT);
+
+    /**
+     * @brief 提交任务
+     * @param uiHint 选择任务队列的依据，同一个提交方使用相同的值
+     * @return 线程池未启用或排队任务数达到上限时返回false
+     */
+    bool Submit(Task&& fnTask, uint32_t uiHint);
+
+    uint32_t GetThreadNum() const
+    {
+        return(m_uiThreadNum);
+    }
+    uint32_t GetQueueDepth() const
+    {
+        return(m_uiQueueDepth.load(std::memory_order_relaxed));
+    }
+    uint64_t GetExecutedNum() const
+    {
+        return(m_ullExecutedNum.load(std::memory_order_relaxed));
+    }
+    uint64_t GetStolenNum() const
+    {
+        return(m_ullStolenNum.load(std::memory_order_relaxed));
+    }
+    uint64_t GetRejectedNum() const
+    {
+        return(m_ullRejectedNum.load(std::memory_order_relaxed));
+    }
+
+private:
+    struct tagQueue
+    {
+        std::mutex oMutex;
+        std::deque<Task> dequeTask;
+    };
+
+    CComputePool();
+    CComputePool(const CComputePool&) = delete;
+    CComputePool& operator=(const CComputePool&) = delete;
+
+    bool Start();
+    bool Pop(uint32_t uiIndex, Task& fnTask);
+    void Run(uint32_t uiIndex);
+
+private:
+    uint32_t m_uiThreadNum;
+    uint32_t m_uiQueueLimit;
+    std::atomic<bool> m_bStarted;
+    std::atomic<uint32_t> m_uiQueueDepth;           ///< 已提交未开始执行的任务数
+    std::atomic<uint32_t> m_uiIdleNum;              ///< 等待任务的线程数
+    std::atomic<uint64_t> m_ullExecutedNum;
+    std::atomic<uint64_t> m_ullStolenNum;           ///< 从其他线程队列窃取执行的任务数
+    std::atomic<uint64_t> m_ullRejectedNum;
+    std::mutex m_oMutex;                            ///< 保护启动过程和空闲等待
+    std::condition_variable m_oCond;
+    std::vector<std::unique_ptr<tagQueue>> m_vecQueue;
+};
+
+} /* namespace neb */
+
+#endif /* SRC_UTIL_CCOMPUTEPOOL_HPP_ */
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CFileCache.cpp
+ * @brief    打开文件缓存
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "CFileCache.hpp"
+
+namespace neb
+{
+
+CFileCache::CFileCache()
+    : m_ullHitNum(0), m_ullMissNum(0)
+{
+}
+
+CFileCache::~CFileCache()
+{
+    Clear();
+}
+
+CFileCache& CFileCache::Instance()
+{
+    static thread_local CFileCache s_oCache;
+    return(s_oCache);
+}
+
+bool CFileCache::Open(const std::string& strPath, tagFile& stFile)
+{
+    time_t lNow = time(nullptr);
+    auto iter = m_mapFile.find(strPath);
+    if (iter != m_mapFile.end() && lNow - iter->second.lValidateTime < VALIDATE_INTERVAL)
+    {
+        ++m_ullHitNum;
+        m_listLru.splice(m_listLru.begin(), m_listLru, iter->second.iterLru);
+        stFile = iter->second.stFile;
+        return(true);
+    }
+
+    struct stat stStat;
+    int iStatResult = ::stat(strPath.c_str(), &stStat);
+    if (iStatResult != 0 || !S_ISREG(stStat.st_mode))
+    {
+        int iErrno = (iStatResult != 0) ? errno : (S_ISDIR(stStat.st_mode) ? EISDIR : EINVAL);
+        if (iter != m_mapFile.end())
+        {
+            Remove(iter);
+        }
+        errno = iErrno;
+        return(false);
+    }
+    if (iter != m_mapFile.end())
+    {
+        tagEntry& stEntry = iter->second;
+        if (stEntry.ulDev == stStat.st_dev && stEntry.ulIno == stStat.st_ino
+                && stEntry.stFile.lMtime == stStat.st_mtime && stEntry.stFile.uiSize == (uint64_t)stStat.st_size)
+        {
+            ++m_ullHitNum;
+            stEntry.lValidateTime = lNow;
+            m_listLru.splice(m_listLru.begin(), m_listLru, stEntry.iterLru);
+            stFile = stEntry.stFile;
+            return(true);
+        }
+        Remove(iter);       // 文件已被替换或修改
+    }
+
+    ++m_ullMissNum;
+    int iFd = ::open(strPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (iFd < 0)
+    {
+        return(false);
+    }
+    if (::fstat(iFd, &stStat) != 0)
+    {
+        int iErrno = errno;
+        ::close(iFd);
+        errno = iErrno;
+        return(false);
+    }
+    tagEntry stEntry;
+    stEntry.stFile.iFd = iFd;
+    stEntry.stFile.uiSize = stStat.st_size;
+    stEntry.stFile.lMtime = stStat.st_mtime;
+    stEntry.ulDev = stStat.st_dev;
+    stEntry.ulIno = stStat.st_ino;
+    stEntry.lValidateTime = lNow;
+    try
+    {
+        m_listLru.push_front(strPath);
+        stEntry.iterLru = m_listLru.begin();
+        m_mapFile.insert(std::make_pair(strPath, stEntry));
+    }
+    catch(std::bad_alloc& e)
+    {
+        if (!m_listLru.empty() && stEntry.iterLru == m_listLru.begin())
+        {
+            m_listLru.pop_front();
+        }
+        ::close(iFd);
+        errno = ENOMEM;
+        return(false);
+    }
+    while (m_mapFile.size() > MAX_FILE_NUM)
+    {
+        Remove(m_mapFile.find(m_listLru.back()));
+    }
+    stFile = stEntry.stFile;
+    return(true);
+}
+
+void CFileCache::Clear()
+{
+    for (auto iter = m_mapFile.begin(); iter != m_mapFile.end(); ++iter)
+    {
+        ::close(iter->second.stFile.iFd);
+    }
+    m_mapFile.clear();
+    m_listLru.clear();
+}
+
+void CFileCache::Remove(std::unordered_map<std::string, tagEntry>::iterator iter)
+{
+    ::close(iter->second.stFile.iFd);
+    m_listLru.erase(iter->second.iterLru);
+    m_mapFile.erase(iter);
+}
+
+} /* namespace neb */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CFileCache.hpp
+ * @brief    打开文件缓存
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     缓存最近使用文件的文件描述符和stat()信息，每个线程（Worker）一个实例，
+ *           无锁。缓存项在VALIDATE_INTERVAL秒后重新stat()，文件被替换或修改时
+ *           重新打开；超过MAX_FILE_NUM时关闭最久未使用的文件。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_UTIL_CFILECACHE_HPP_
+#define SRC_UTIL_CFILECACHE_HPP_
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace neb
+{
+
+class CFileCache
+{
+public:
+    static const size_t MAX_FILE_NUM = 128;         ///< 最多缓存的打开文件数
+    static const time_t VALIDATE_INTERVAL = 1;      ///< 缓存项重新stat()的间隔（秒）
+
+    struct tagFile
+    {
+        int iFd = -1;
+        uint64_t uiSize = 0;
+        time_t lMtime = 0;
+    };
+
+    virtual ~CFileCache();
+
+    static CFileCache& Instance();
+
+    /**
+     * @brief 打开文件（只读）
+     * @note 返回的文件描述符归缓存所有，调用方不可关闭，也不可跨事件循环保存；
+     *       需要持有时应dup()。
+     * @return 文件不存在或不是普通文件时返回false，errno为失败原因
+     */
+    bool Open(const std::string& strPath, tagFile& stFile);
+
+    /** @brief 关闭所有缓存的文件 */
+    void Clear();
+
+    size_t Size() const
+    {
+        return(m_mapFile.size());
+    }
+    uint64_t GetHitNum() const
+    {
+        return(m_ullHitNum);
+    }
+    uint64_t GetMissNum() const
+    {
+        return(m_ullMissNum);
+    }
+
+private:
+    struct tagEntry
+    {
+        tagFile stFile;
+        dev_t ulDev = 0;
+        ino_t ulIno = 0;
+        time_t lValidateTime = 0;
+        std::list<std::string>::iterator iterLru;
+    };
+
+    CFileCache();
+    CFileCache(const CFileCache&) = delete;
+    CFileCache& operator=(const CFileCache&) = delete;
+
+    void Remove(std::unordered_map<std::string, tagEntry>::iterator iter);
+
+private:
+    uint64_t m_ullHitNum;
+    uint64_t m_ullMissNum;
+    std::list<std::string> m_listLru;       ///< 队首为最近使用的文件
+    std::unordered_map<std::string, tagEntry> m_mapFile;
+};
+
+} /* namespace neb */
+
+#endif /* SRC_UTIL_CFILECACHE_HPP_ */
@@ -0,0 +1,399 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CIoUring.cpp
+ * @brief    io_uring提交/完成队列
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include "CIoUring.hpp"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+namespace neb
+{
+
+bool CIoUring::tagCompletion::More() const
+{
+    return(uiFlags & IORING_CQE_F_MORE);
+}
+
+bool CIoUring::tagCompletion::HasBuffer() const
+{
+    return(uiFlags & IORING_CQE_F_BUFFER);
+}
+
+uint16_t CIoUring::tagCompletion::BufferId() const
+{
+    return((uint16_t)(uiFlags >> IORING_CQE_BUFFER_SHIFT));
+}
+
+CIoUring::CIoUring()
+    : m_iRingFd(-1), m_iErrno(0), m_uiSqeHead(0), m_uiSqeTail(0),
+      m_pSqRing(MAP_FAILED), m_uiSqRingSize(0), m_pCqRing(MAP_FAILED), m_uiCqRingSize(0),
+      m_pSqes((io_uring_sqe*)MAP_FAILED), m_uiSqesSize(0),
+      m_pSqHead(nullptr), m_pSqTail(nullptr), m_uiSqMask(0), m_uiSqEntries(0), m_pSqFlags(nullptr),
+      m_pSqArray(nullptr), m_pCqHead(nullptr), m_pCqTail(nullptr), m_uiCqMask(0), m_pCqes(nullptr),
+      m_pBufferRing((io_uring_buf_ring*)MAP_FAILED), m_uiBufferRingSize(0), m_pBufferBase((char*)MAP_FAILED),
+      m_uiBufferNum(0), m_uiBufferMask(0), m_uiBufferTail(0), m_uiBufferSize(0)
+{
+}
+
+CIoUring::~CIoUring()
+{
+    Destroy();
+}
+
+bool CIoUring::Init(uint32_t uiEntries, uint16_t uiBufferNum, uint32_t uiBufferSize)
+{
+    if (m_iRingFd >= 0)
+    {
+        return(true);
+    }
+    struct io_uring_params stParams;
+    memset(&stParams, 0, sizeof(stParams));
+    stParams.flags = IORING_SETUP_CQSIZE;
+    stParams.cq_entries = uiEntries * 4;        // 多次完成的请求会产生多个完成事件
+    m_iRingFd = (int)syscall(__NR_io_uring_setup, uiEntries, &stParams);
+    if (m_iRingFd < 0)
+    {
+        m_iErrno = errno;
+        return(false);
+    }
+    if (!(stParams.features & IORING_FEAT_NODROP))  // 5.5以下完成队列满时会丢弃完成事件
+    {
+        Destroy();
+        m_iErrno = ENOSYS;
+        return(false);
+    }
+
+    m_uiSqRingSize = stParams.sq_off.array + stParams.sq_entries * sizeof(uint32_t);
+    m_uiCqRingSize = stParams.cq_off.cqes + stParams.cq_entries * sizeof(struct io_uring_cqe);
+    if (stParams.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_uiSqRingSize = (m_uiCqRingSize > m_uiSqRingSize) ? m_uiCqRingSize : m_uiSqRingSize;
+    }
+    m_pSqRing = mmap(NULL, m_uiSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            m_iRingFd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == m_pSqRing)
+    {
+        m_iErrno = errno;
+        Destroy();
+        return(false);
+    }
+    if (stParams.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_pCqRing = m_pSqRing;
+    }
+    else
+    {
+        m_pCqRing = mmap(NULL, m_uiCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                m_iRingFd, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == m_pCqRing)
+        {
+            m_iErrno = errno;
+            Destroy();
+            return(false);
+        }
+    }
+    m_uiSqesSize = stParams.sq_entries * sizeof(struct io_uring_sqe);
+    m_pSqes = (io_uring_sqe*)mmap(NULL, m_uiSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            m_iRingFd, IORING_OFF_SQES);
+    if (MAP_FAILED == (void*)m_pSqes)
+    {
+        m_iErrno = errno;
+        Destroy();
+        return(false);
+    }
+
+    char* pSq = (char*)m_pSqRing;
+    char* pCq = (char*)m_pCqRing;
+    m_pSqHead = (uint32_t*)(pSq + stParams.sq_off.head);
+    m_pSqTail = (uint32_t*)(pSq + stParams.sq_off.tail);
+    m_uiSqMask = *(uint32_t*)(pSq + stParams.sq_off.ring_mask);
+    m_uiSqEntries = *(uint32_t*)(pSq + stParams.sq_off.ring_entries);
+    m_pSqFlags = (uint32_t*)(pSq + stParams.sq_off.flags);
+    m_pSqArray = (uint32_t*)(pSq + stParams.sq_off.array);
+    m_pCqHead = (uint32_t*)(pCq + stParams.cq_off.head);
+    m_pCqTail = (uint32_t*)(pCq + stParams.cq_off.tail);
+    m_uiCqMask = *(uint32_t*)(pCq + stParams.cq_off.ring_mask);
+    m_pCqes = (io_uring_cqe*)(pCq + stParams.cq_off.cqes);
+    for (uint32_t i = 0; i < m_uiSqEntries; ++i)
+    {
+        m_pSqArray[i] = i;      // 提交队列项与提交队列位置一一对应，提交时不再填写索引数组
+    }
+    m_uiSqeHead = m_uiSqeTail = *m_pSqTail;
+
+    if (!RegisterBufferRing(uiBufferNum, uiBufferSize))
+    {
+        Destroy();
+        return(false);
+    }
+    return(true);
+}
+
+bool CIoUring::RegisterBufferRing(uint16_t uiBufferNum, uint32_t uiBufferSize)
+{
+    if (uiBufferNum == 0 || (uiBufferNum & (uiBufferNum - 1)) != 0 || uiBufferSize == 0)
+    {
+        m_iErrno = EINVAL;
+        return(false);
+    }
+    m_uiBufferRingSize = uiBufferNum * sizeof(struct io_uring_buf);
+    m_pBufferRing = (io_uring_buf_ring*)mmap(NULL, m_uiBufferRingSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void*)m_pBufferRing)
+    {
+        m_iErrno = errno;
+        return(false);
+    }
+    m_pBufferBase = (char*)mmap(NULL, (size_t)uiBufferNum * uiBufferSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == (void*)m_pBufferBase)
+    {
+        m_iErrno = errno;
+        return(false);
+    }
+    m_uiBufferNum = uiBufferNum;
+    m_uiBufferMask = uiBufferNum - 1;
+    m_uiBufferSize = uiBufferSize;
+
+    struct io_uring_buf_reg stReg;
+    memset(&stReg, 0, sizeof(stReg));
+    stReg.ring_addr = (uint64_t)(uintptr_t)m_pBufferRing;
+    stReg.ring_entries = uiBufferNum;
+    stReg.bgid = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, m_iRingFd, IORING_REGISTER_PBUF_RING, &stReg, 1) < 0)
+    {
+        m_iErrno = errno;
+        return(false);
+    }
+    m_uiBufferTail = 0;
+    for (uint16_t i = 0; i < uiBufferNum; ++i)
+    {
+        RecycleBuffer(i);
+    }
+    return(true);
+}
+
+void CIoUring::Destroy()
+{
+    if (m_iRingFd >= 0)
+    {
+        close(m_iRingFd);   // 未完成的请求由内核取消
+        m_iRingFd = -1;
+    }
+    if (MAP_FAILED != (void*)m_pSqes)
+    {
+        munmap(m_pSqes, m_uiSqesSize);
+        m_pSqes = (io_uring_sqe*)MAP_FAILED;
+    }
+    if (MAP_FAILED != m_pCqRing && m_pCqRing != m_pSqRing)
+    {
+        munmap(m_pCqRing, m_uiCqRingSize);
+    }
+    m_pCqRing = MAP_FAILED;
+    if (MAP_FAILED != m_pSqRing)
+    {
+        munmap(m_pSqRing, m_uiSqRingSize);
+        m_pSqRing = MAP_FAILED;
+    }
+    if (MAP_FAILED != (void*)m_pBufferRing)
+    {
+        munmap(m_pBufferRing, m_uiBufferRingSize);
+        m_pBufferRing = (io_uring_buf_ring*)MAP_FAILED;
+    }
+    if (MAP_FAILED != (void*)m_pBufferBase)
+    {
+        munmap(m_pBufferBase, (size_t)m_uiBufferNum * m_uiBufferSize);
+        m_pBufferBase = (char*)MAP_FAILED;
+    }
+    m_pSqHead = m_pSqTail = m_pSqFlags = m_pSqArray = m_pCqHead = m_pCqTail = nullptr;
+    m_pCqes = nullptr;
+    m_uiSqeHead = m_uiSqeTail = 0;
+    m_uiBufferNum = m_uiBufferMask = m_uiBufferTail = 0;
+}
+
+io_uring_sqe* CIoUring::GetSqe()
+{
+    if (m_iRingFd < 0)
+    {
+        return(nullptr);
+    }
+    if (m_uiSqeTail - __atomic_load_n(m_pSqHead, __ATOMIC_ACQUIRE) >= m_uiSqEntries)
+    {
+        if (Submit() < 0
+                || m_uiSqeTail - __atomic_load_n(m_pSqHead, __ATOMIC_ACQUIRE) >= m_uiSqEntries)
+        {
+            return(nullptr);
+        }
+    }
+    io_uring_sqe* pSqe = &m_pSqes[m_uiSqeTail & m_uiSqMask];
+    memset(pSqe, 0, sizeof(struct io_uring_sqe));
+    ++m_uiSqeTail;
+    return(pSqe);
+}
+
+bool CIoUring::PrepareAccept(int iListenFd, uint64_t ullUserData)
+{
+    io_uring_sqe* pSqe = GetSqe();
+    if (pSqe == nullptr)
+    {
+        return(false);
+    }
+    pSqe->opcode = IORING_OP_ACCEPT;
+    pSqe->fd = iListenFd;
+    pSqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    pSqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    pSqe->user_data = ullUserData;
+    return(true);
+}
+
+bool CIoUring::PrepareRecv(int iFd, uint64_t ullUserData)
+{
+    io_uring_sqe* pSqe = GetSqe();
+    if (pSqe == nullptr)
+    {
+        return(false);
+    }
+    pSqe->opcode = IORING_OP_RECV;
+    pSqe->fd = iFd;
+    pSqe->ioprio = IORING_RECV_MULTISHOT;
+    pSqe->flags = IOSQE_BUFFER_SELECT;
+    pSqe->buf_group = BUFFER_GROUP;
+    pSqe->user_data = ullUserData;
+    return(true);
+}
+
+bool CIoUring::PrepareSend(int iFd, const void* pData, size_t uiLen, uint64_t ullUserData)
+{
+    io_uring_sqe* pSqe = GetSqe();
+    if (pSqe == nullptr)
+    {
+        return(false);
+    }
+    pSqe->opcode = IORING_OP_SEND;
+    pSqe->fd = iFd;
+    pSqe->addr = (uint64_t)(uintptr_t)pData;
+    pSqe->len = (uint32_t)uiLen;
+    pSqe->msg_flags = MSG_NOSIGNAL;
+    pSqe->user_data = ullUserData;
+    return(true);
+}
+
+bool CIoUring::PrepareSendMsg(int iFd, const struct msghdr* pMsg, uint64_t ullUserData)
+{
+    io_uring_sqe* pSqe = GetSqe();
+    if (pSqe == nullptr)
+    {
+        return(false);
+    }
+    pSqe->opcode = IORING_OP_SENDMSG;
+    pSqe->fd = iFd;
+    pSqe->addr = (uint64_t)(uintptr_t)pMsg;
+    pSqe->len = 1;
+    pSqe->msg_flags = MSG_NOSIGNAL;
+    pSqe->user_data = ullUserData;
+    return(true);
+}
+
+bool CIoUring::PrepareCancel(uint64_t ullTargetUserData, uint64_t ullUserData)
+{
+    io_uring_sqe* pSqe = GetSqe();
+    if (pSqe == nullptr)
+    {
+        return(false);
+    }
+    pSqe->opcode = IORING_OP_ASYNC_CANCEL;
+    pSqe->fd = -1;
+    pSqe->addr = ullTargetUserData;
+    pSqe->user_data = ullUserData;
+    return(true);
+}
+
+int CIoUring::Submit()
+{
+    uint32_t uiToSubmit = m_uiSqeTail - m_uiSqeHead;
+    if (uiToSubmit == 0 || m_iRingFd < 0)
+    {
+        return(0);
+    }
+    __atomic_store_n(m_pSqTail, m_uiSqeTail, __ATOMIC_RELEASE);
+    int iResult = 0;
+    do
+    {
+        iResult = (int)syscall(__NR_io_uring_enter, m_iRingFd, uiToSubmit, 0, 0, NULL, 0);
+    }
+    while (iResult < 0 && EINTR == errno);
+    if (iResult < 0)
+    {
+        m_iErrno = errno;   // EAGAIN、EBUSY：内核资源不足或完成队列溢出，下次再提交
+    }
+    m_uiSqeHead = __atomic_load_n(m_pSqHead, __ATOMIC_ACQUIRE);
+    return(iResult);
+}
+
+uint32_t CIoUring::Reap(std::vector<tagCompletion>& vecCompletion, uint32_t uiMaxNum)
+{
+    uint32_t uiNum = 0;
+    if (m_iRingFd < 0)
+    {
+        return(0);
+    }
+    while (uiNum < uiMaxNum)
+    {
+        uint32_t uiHead = *m_pCqHead;
+        uint32_t uiTail = __atomic_load_n(m_pCqTail, __ATOMIC_ACQUIRE);
+        while (uiHead != uiTail && uiNum < uiMaxNum)
+        {
+            const io_uring_cqe& stCqe = m_pCqes[uiHead & m_uiCqMask];
+            tagCompletion stCompletion;
+            stCompletion.ullUserData = stCqe.user_data;
+            stCompletion.iResult = stCqe.res;
+            stCompletion.uiFlags = stCqe.flags;
+            vecCompletion.push_back(stCompletion);
+            ++uiHead;
+            ++uiNum;
+        }
+        __atomic_store_n(m_pCqHead, uiHead, __ATOMIC_RELEASE);
+        if (uiHead != uiTail)
+        {
+            break;
+        }
+        // 完成队列曾经满过，溢出的完成事件由内核暂存，需要进入内核才会写回完成队列
+        if (!(__atomic_load_n(m_pSqFlags, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW))
+        {
+            break;
+        }
+        syscall(__NR_io_uring_enter, m_iRingFd, 0, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (__atomic_load_n(m_pCqTail, __ATOMIC_ACQUIRE) == uiHead)
+        {
+            break;
+        }
+    }
+    return(uiNum);
+}
+
+void CIoUring::RecycleBuffer(uint16_t uiBufferId)
+{
+    if (MAP_FAILED == (void*)m_pBufferRing || uiBufferId >= m_uiBufferNum)
+    {
+        return;
+    }
+    // 环的tail与bufs[0]的resv字段重叠，只能逐个字段填写；C++下头文件中bufs的偏移不为0（空结构体占位），
+    // 直接从环的起始地址取缓冲区描述
+    struct io_uring_buf* pBuf = (struct io_uring_buf*)m_pBufferRing + (m_uiBufferTail & m_uiBufferMask);
+    pBuf->addr = (uint64_t)(uintptr_t)(m_pBufferBase + (size_t)uiBufferId * m_uiBufferSize);
+    pBuf->len = m_uiBufferSize;
+    pBuf->bid = uiBufferId;
+    ++m_uiBufferTail;
+    __atomic_store_n(&m_pBufferRing->tail, m_uiBufferTail, __ATOMIC_RELEASE);
+}
+
+} /* namespace neb */
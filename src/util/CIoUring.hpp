@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CIoUring.hpp
+ * @brief    io_uring提交/完成队列
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     直接用io_uring_setup()/io_uring_enter()系统调用实现（不依赖liburing），只提供
+ *           框架用到的几种请求：多次完成的accept和recv（recv从注册的缓冲区环中取接收缓冲区，
+ *           不需要为每个连接预留接收空间）、send和取消。
+ *           请求只写入提交队列，由使用者在合适的时机（Dispatcher在每次poll之前）调用Submit()
+ *           一次性提交；完成队列有数据时环fd可读，使用者把环fd加入自己的事件循环后调用Reap()。
+ *           非线程安全，每个事件循环一个实例。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_UTIL_CIOURING_HPP_
+#define SRC_UTIL_CIOURING_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+struct msghdr;
+
+namespace neb
+{
+
+class CIoUring
+{
+public:
+    struct tagCompletion
+    {
+        uint64_t ullUserData;
+        int32_t iResult;
+        uint32_t uiFlags;
+
+        /** @brief 同一请求后续还会有完成事件（多次完成的请求未终止） */
+        bool More() const;
+        /** @brief 完成事件占用了缓冲区环中的缓冲区，用完须RecycleBuffer() */
+        bool HasBuffer() const;
+        uint16_t BufferId() const;
+    };
+
+    static const uint32_t DEFAULT_ENTRIES = 256;
+    static const uint16_t DEFAULT_BUFFER_NUM = 256;          ///< 须为2的幂
+    static const uint32_t DEFAULT_BUFFER_SIZE = 16384;
+    static const uint16_t BUFFER_GROUP = 0;
+
+    CIoUring();
+    virtual ~CIoUring();
+
+    /**
+     * @brief 创建io_uring并注册接收缓冲区环
+     * @return 内核不支持io_uring或不支持缓冲区环（5.19以下）时返回false，GetErrno()为错误码
+     */
+    bool Init(uint32_t uiEntries = DEFAULT_ENTRIES,
+            uint16_t uiBufferNum = DEFAULT_BUFFER_NUM, uint32_t uiBufferSize = DEFAULT_BUFFER_SIZE);
+    void Destroy();
+
+    int GetFd() const
+    {
+        return(m_iRingFd);
+    }
+    int GetErrno() const
+    {
+        return(m_iErrno);
+    }
+    uint32_t GetBufferSize() const
+    {
+        return(m_uiBufferSize);
+    }
+
+    /** @brief 多次完成的accept，每个新连接一个完成事件，iResult为非阻塞、CLOEXEC的新连接fd */
+    bool PrepareAccept(int iListenFd, uint64_t ullUserData);
+
+    /** @brief 多次完成的recv，每次接收一个完成事件，数据在BufferId()指定的缓冲区中 */
+    bool PrepareRecv(int iFd, uint64_t ullUserData);
+
+    /** @brief send，pData在完成之前须保持有效 */
+    bool PrepareSend(int iFd, const void* pData, size_t uiLen, uint64_t ullUserData);
+
+    /** @brief sendmsg，pMsg及其iovec指向的数据在完成之前须保持有效 */
+    bool PrepareSendMsg(int iFd, const struct msghdr* pMsg, uint64_t ullUserData);
+
+    /** @brief 取消ullTargetUserData对应的请求，被取消的请求以-ECANCELED（或已有的结果）终止 */
+    bool PrepareCancel(uint64_t ullTargetUserData, uint64_t ullUserData);
+
+    /** @brief 待提交的请求数 */
+    uint32_t Pending() const
+    {
+        return(m_uiSqeTail - m_uiSqeHead);
+    }
+
+    /**
+     * @brief 提交所有待提交的请求
+     * @return 提交的请求数，出错返回-1并设置GetErrno()
+     */
+    int Submit();
+
+    /**
+     * @brief 取出完成事件（追加到vecCompletion），最多uiMaxNum个
+     * @return 取出的完成事件数
+     */
+    uint32_t Reap(std::vector<tagCompletion>& vecCompletion, uint32_t uiMaxNum = UINT32_MAX);
+
+    const char* GetBuffer(uint16_t uiBufferId) const
+    {
+        return(m_pBufferBase + (size_t)uiBufferId * m_uiBufferSize);
+    }
+
+    /** @brief 把接收完成事件占用的缓冲区放回缓冲区环 */
+    void RecycleBuffer(uint16_t uiBufferId);
+
+private:
+    CIoUring(const CIoUring&) = delete;
+    CIoUring& operator=(const CIoUring&) = delete;
+
+    io_uring_sqe* GetSqe();
+    bool RegisterBufferRing(uint16_t uiBufferNum, uint32_t uiBufferSize);
+
+private:
+    int m_iRingFd;
+    int m_iErrno;
+    uint32_t m_uiSqeHead;               ///< 已交给内核的提交队列位置
+    uint32_t m_uiSqeTail;               ///< 已填写的提交队列位置
+
+    void* m_pSqRing;
+    size_t m_uiSqRingSize;
+    void* m_pCqRing;                    ///< 内核支持IORING_FEAT_SINGLE_MMAP时与m_pSqRing相同
+    size_t m_uiCqRingSize;
+    io_uring_sqe* m_pSqes;
+    size_t m_uiSqesSize;
+
+    uint32_t* m_pSqHead;
+    uint32_t* m_pSqTail;
+    uint32_t m_uiSqMask;
+    uint32_t m_uiSqEntries;
+    uint32_t* m_pSqFlags;
+    uint32_t* m_pSqArray;
+    uint32_t* m_pCqHead;
+    uint32_t* m_pCqTail;
+    uint32_t m_uiCqMask;
+    io_uring_cqe* m_pCqes;
+
+    io_uring_buf_ring* m_pBufferRing;
+    size_t m_uiBufferRingSize;
+    char* m_pBufferBase;
+    uint16_t m_uiBufferNum;
+    uint16_t m_uiBufferMask;
+    uint16_t m_uiBufferTail;
+    uint32_t m_uiBufferSize;
+};
+
+} /* namespace neb */
+
+#endif /* SRC_UTIL_CIOURING_HPP_ */
@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CTimingWheel.cpp
+ * @brief    分层时间轮
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include "CTimingWheel.hpp"
+
+namespace neb
+{
+
+void CTimingWheel::tagTimer::Cancel()
+{
+    if (pWheel != nullptr)
+    {
+        pPrev->pNext = pNext;
+        pNext->pPrev = pPrev;
+        pPrev = nullptr;
+        pNext = nullptr;
+        --pWheel->m_uiTimerNum;
+        pWheel = nullptr;
+    }
+}
+
+CTimingWheel::CTimingWheel(uint64_t ullNowTick)
+    : m_ullCurrentTick(ullNowTick), m_uiTimerNum(0)
+{
+    for (uint32_t i = 0; i < ROOT_SIZE; ++i)
+    {
+        ListInit(&m_astRoot[i]);
+    }
+    for (uint32_t i = 0; i < LEVEL_NUM; ++i)
+    {
+        for (uint32_t j = 0; j < LEVEL_SIZE; ++j)
+        {
+            ListInit(&m_aastLevel[i][j]);
+        }
+    }
+}
+
+CTimingWheel::~CTimingWheel()
+{
+    // 时间轮先于定时器销毁时解除所有定时器的关联
+    for (uint32_t i = 0; i < ROOT_SIZE; ++i)
+    {
+        while (m_astRoot[i].pNext != &m_astRoot[i])
+        {
+            m_astRoot[i].pNext->Cancel();
+        }
+    }
+    for (uint32_t i = 0; i < LEVEL_NUM; ++i)
+    {
+        for (uint32_t j = 0; j < LEVEL_SIZE; ++j)
+        {
+            while (m_aastLevel[i][j].pNext != &m_aastLevel[i][j])
+            {
+                m_aastLevel[i][j].pNext->Cancel();
+            }
+        }
+    }
+}
+
+void CTimingWheel::Add(tagTimer* pTimer, uint64_t ullExpire)
+{
+    pTimer->Cancel();
+    pTimer->ullExpire = ullExpire;
+    pTimer->pWheel = this;
+    ++m_uiTimerNum;
+    Link(pTimer);
+}
+
+void CTimingWheel::Link(tagTimer* pTimer)
+{
+    uint64_t ullExpire = pTimer->ullExpire;
+    if (ullExpire < m_ullCurrentTick)
+    {
+        ullExpire = m_ullCurrentTick;
+    }
+    uint64_t ullSpan = ullExpire - m_ullCurrentTick;
+    if (ullSpan >= MAX_SPAN)
+    {
+        // 超出时间轮范围，先放到最高层最远的槽，下移时按真实到期时间重新放入
+        ullSpan = MAX_SPAN - 1;
+        ullExpire = m_ullCurrentTick + ullSpan;
+    }
+    if (ullSpan < ROOT_SIZE)
+    {
+        ListAppend(&m_astRoot[ullExpire & (ROOT_SIZE - 1)], pTimer);
+        return;
+    }
+    for (uint32_t i = 0; i < LEVEL_NUM; ++i)
+    {
+        uint32_t uiShift = ROOT_BITS + (i + 1) * LEVEL_BITS;
+        if (i == LEVEL_NUM - 1 || ullSpan < ((uint64_t)1 << uiShift))
+        {
+            uint32_t uiIndex = (ullExpire >> (uiShift - LEVEL_BITS)) & (LEVEL_SIZE - 1);
+            ListAppend(&m_aastLevel[i][uiIndex], pTimer);
+            return;
+        }
+    }
+}
+
+void CTimingWheel::Cascade(uint32_t uiLevel, uint32_t uiIndex)
+{
+    tagTimer stList;
+    ListInit(&stList);
+    ListMove(&m_aastLevel[uiLevel][uiIndex], &stList);
+    while (stList.pNext != &stList)
+    {
+        tagTimer* pTimer = stList.pNext;
+        pTimer->pPrev->pNext = pTimer->pNext;
+        pTimer->pNext->pPrev = pTimer->pPrev;
+        Link(pTimer);
+    }
+}
+
+uint32_t CTimingWheel::Expire(uint64_t ullNowTick)
+{
+    uint32_t uiExpireNum = 0;
+    if (m_uiTimerNum == 0)
+    {
+        if (ullNowTick >= m_ullCurrentTick)
+        {
+            m_ullCurrentTick = ullNowTick + 1;
+        }
+        return(0);
+    }
+    tagTimer stExpired;
+    ListInit(&stExpired);
+    while (m_ullCurrentTick <= ullNowTick)
+    {
+        uint32_t uiIndex = m_ullCurrentTick & (ROOT_SIZE - 1);
+        if (uiIndex == 0)
+        {
+            for (uint32_t i = 0; i < LEVEL_NUM; ++i)
+            {
+                uint32_t uiLevelIndex = (m_ullCurrentTick >> (ROOT_BITS + i * LEVEL_BITS)) & (LEVEL_SIZE - 1);
+                Cascade(i, uiLevelIndex);
+                if (uiLevelIndex != 0)
+                {
+                    break;
+                }
+            }
+        }
+        ListMove(&m_astRoot[uiIndex], &stExpired);
+        ++m_ullCurrentTick;
+
+        // 逐个取出回调，回调中取消的定时器会从stExpired中摘除
+        while (stExpired.pNext != &stExpired)
+        {
+            tagTimer* pTimer = stExpired.pNext;
+            if (pTimer->ullExpire >= m_ullCurrentTick)     // 超出范围被截断的定时器
+            {
+                pTimer->pPrev->pNext = pTimer->pNext;
+                pTimer->pNext->pPrev = pTimer->pPrev;
+                Link(pTimer);
+                continue;
+            }
+            pTimer->Cancel();
+            ++uiExpireNum;
+            if (pTimer->pFunc != nullptr)
+            {
+                pTimer->pFunc(pTimer->pData);
+            }
+        }
+        if (m_uiTimerNum == 0)
+        {
+            if (ullNowTick >= m_ullCurrentTick)
+            {
+                m_ullCurrentTick = ullNowTick + 1;
+            }
+            break;
+        }
+    }
+    return(uiExpireNum);
+}
+
+uint64_t CTimingWheel::NextTick() const
+{
+    if (m_uiTimerNum == 0)
+    {
+        return(UINT64_MAX);
+    }
+    if ((m_ullCurrentTick & (ROOT_SIZE - 1)) == 0)
+    {
+        return(m_ullCurrentTick);       // 待下移高层定时器
+    }
+    uint64_t ullTick = m_ullCurrentTick;
+    do
+    {
+        if (m_astRoot[ullTick & (ROOT_SIZE - 1)].pNext != &m_astRoot[ullTick & (ROOT_SIZE - 1)])
+        {
+            return(ullTick);
+        }
+        ++ullTick;
+    } while ((ullTick & (ROOT_SIZE - 1)) != 0);
+    return(ullTick);
+}
+
+void CTimingWheel::ListInit(tagTimer* pHead)
+{
+    pHead->pPrev = pHead;
+    pHead->pNext = pHead;
+}
+
+void CTimingWheel::ListAppend(tagTimer* pHead, tagTimer* pTimer)
+{
+    pTimer->pPrev = pHead->pPrev;
+    pTimer->pNext = pHead;
+    pHead->pPrev->pNext = pTimer;
+    pHead->pPrev = pTimer;
+}
+
+void CTimingWheel::ListMove(tagTimer* pFromHead, tagTimer* pToHead)
+{
+    if (pFromHead->pNext == pFromHead)
+    {
+        return;
+    }
+    pFromHead->pNext->pPrev = pToHead->pPrev;
+    pToHead->pPrev->pNext = pFromHead->pNext;
+    pFromHead->pPrev->pNext = pToHead;
+    pToHead->pPrev = pFromHead->pPrev;
+    ListInit(pFromHead);
+}
+
+} /* namespace neb */
+
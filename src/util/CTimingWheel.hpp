@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CTimingWheel.hpp
+ * @brief    分层时间轮
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     毫秒tick的四层时间轮（256 + 3 * 64个槽，覆盖约18.6小时，更长的定时器在到达
+ *           最高层后重新放入），定时器以侵入式双向链表挂在槽上，添加、取消、刷新均为O(1)。
+ *           时间轮本身不驱动时间，由使用者（Dispatcher）用一个ev_timer周期调用Expire()。
+ *           非线程安全，每个事件循环一个实例。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_UTIL_CTIMINGWHEEL_HPP_
+#define SRC_UTIL_CTIMINGWHEEL_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace neb
+{
+
+class CTimingWheel
+{
+public:
+    typedef void (*timeout_callback)(void* pData);
+
+    struct tagTimer
+    {
+        tagTimer* pPrev = nullptr;
+        tagTimer* pNext = nullptr;
+        CTimingWheel* pWheel = nullptr;     ///< 所在的时间轮，未添加时为nullptr
+        uint64_t ullExpire = 0;             ///< 到期时间（毫秒tick）
+        timeout_callback pFunc = nullptr;
+        void* pData = nullptr;
+
+        tagTimer() = default;
+        tagTimer(const tagTimer&) = delete;
+        tagTimer& operator=(const tagTimer&) = delete;
+        ~tagTimer()
+        {
+            Cancel();
+        }
+        bool IsActive() const
+        {
+            return(pWheel != nullptr);
+        }
+        void Cancel();
+    };
+
+    explicit CTimingWheel(uint64_t ullNowTick = 0);
+    virtual ~CTimingWheel();
+
+    /**
+     * @brief 添加（或刷新）定时器，已在时间轮中的定时器先取消再按新的到期时间放入
+     */
+    void Add(tagTimer* pTimer, uint64_t ullExpire);
+
+    /**
+     * @brief 推进到ullNowTick，依次回调所有到期的定时器
+     * @note 回调中可以添加、取消任何定时器（包括同一批到期的其他定时器）
+     * @return 回调的定时器数量
+     */
+    uint32_t Expire(uint64_t ullNowTick);
+
+    /**
+     * @brief 下一次需要调用Expire()的tick（时间轮为空时返回UINT64_MAX）
+     * @note 第一层无定时器时返回第一层转完一圈的tick，以便高层定时器及时下移
+     */
+    uint64_t NextTick() const;
+
+    uint32_t Size() const
+    {
+        return(m_uiTimerNum);
+    }
+    uint64_t GetCurrentTick() const
+    {
+        return(m_ullCurrentTick);
+    }
+
+private:
+    static const uint32_t ROOT_BITS = 8;
+    static const uint32_t LEVEL_BITS = 6;
+    static const uint32_t ROOT_SIZE = 1 << ROOT_BITS;
+    static const uint32_t LEVEL_SIZE = 1 << LEVEL_BITS;
+    static const uint32_t LEVEL_NUM = 3;            ///< 第一层之外的层数
+    static const uint64_t MAX_SPAN = (uint64_t)1 << (ROOT_BITS + LEVEL_NUM * LEVEL_BITS);
+
+    CTimingWheel(const CTimingWheel&) = delete;
+    CTimingWheel& operator=(const CTimingWheel&) = delete;
+
+    void Link(tagTimer* pTimer);
+    void Cascade(uint32_t uiLevel, uint32_t uiIndex);
+    static void ListInit(tagTimer* pHead);
+    static void ListAppend(tagTimer* pHead, tagTimer* pTimer);
+    static void ListMove(tagTimer* pFromHead, tagTimer* pToHead);
+
+private:
+    uint64_t m_ullCurrentTick;                      ///< 下一个待处理的tick
+    uint32_t m_uiTimerNum;
+    tagTimer m_astRoot[ROOT_SIZE];
+    tagTimer m_aastLevel[LEVEL_NUM][LEVEL_SIZE];
+};
+
+} /* namespace neb */
+
+#endif /* SRC_UTIL_CTIMINGWHEEL_HPP_ */
+
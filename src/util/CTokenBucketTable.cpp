@@ -0,0 +1,100 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CTokenBucketTable.cpp
+ * @brief    令牌桶准入表
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include "CTokenBucketTable.hpp"
+#include <netinet/in.h>
+
+namespace neb
+{
+
+CTokenBucketTable::CTokenBucketTable(uint32_t uiCapacity)
+    : m_uiCapacity(MAX_PROBE), m_uiSize(0)
+{
+    while (m_uiCapacity < uiCapacity)
+    {
+        m_uiCapacity <<= 1;
+    }
+}
+
+CTokenBucketTable::~CTokenBucketTable()
+{
+}
+
+bool CTokenBucketTable::Acquire(const tagKey& stKey, double dRate, double dBurst, double dNow)
+{
+    if (m_vecBucket.empty())
+    {
+        m_vecBucket.resize(m_uiCapacity);
+        memset((void*)m_vecBucket.data(), 0, sizeof(tagBucket) * m_uiCapacity);
+    }
+    uint32_t uiMask = m_uiCapacity - 1;
+    uint32_t uiIndex = Hash(stKey) & uiMask;
+    tagBucket* pVictim = nullptr;
+    for (uint32_t i = 0; i < MAX_PROBE; ++i)
+    {
+        tagBucket& stBucket = m_vecBucket[(uiIndex + i) & uiMask];
+        if (stBucket.dLastTime == 0.0)     // 表项不删除，键不会在空槽之后
+        {
+            pVictim = &stBucket;
+            break;
+        }
+        if (stBucket.stKey == stKey)
+        {
+            double dTokens = stBucket.dTokens + (dNow - stBucket.dLastTime) * dRate;
+            stBucket.dTokens = (dTokens > dBurst) ? dBurst : dTokens;
+            stBucket.dLastTime = dNow;
+            if (stBucket.dTokens < 1.0)
+            {
+                return(false);
+            }
+            stBucket.dTokens -= 1.0;
+            return(true);
+        }
+        if (pVictim == nullptr || stBucket.dLastTime < pVictim->dLastTime)
+        {
+            pVictim = &stBucket;
+        }
+    }
+
+    // 新键：放入空槽，探测范围内无空槽时淘汰最久未访问的项
+    if (pVictim->dLastTime == 0.0)
+    {
+        ++m_uiSize;
+    }
+    pVictim->stKey = stKey;
+    pVictim->dLastTime = dNow;
+    pVictim->dTokens = dBurst - 1.0;
+    return(dBurst >= 1.0);
+}
+
+CTokenBucketTable::tagKey CTokenBucketTable::MakeKey(const struct sockaddr_storage& stAddr)
+{
+    tagKey stKey;
+    memset(&stKey, 0, sizeof(stKey));
+    if (AF_INET6 == stAddr.ss_family)
+    {
+        memcpy(&stKey, &((const struct sockaddr_in6*)&stAddr)->sin6_addr, sizeof(stKey));
+    }
+    else if (AF_INET == stAddr.ss_family)
+    {
+        unsigned char* pKey = (unsigned char*)&stKey;
+        pKey[10] = 0xff;
+        pKey[11] = 0xff;
+        memcpy(pKey + 12, &((const struct sockaddr_in*)&stAddr)->sin_addr, 4);
+    }
+    return(stKey);
+}
+
+uint32_t CTokenBucketTable::Hash(const tagKey& stKey)
+{
+    uint64_t ullHash = (stKey.aullKey[0] ^ (stKey.aullKey[1] * 0x9E3779B97F4A7C15ULL)) * 0xFF51AFD7ED558CCDULL;
+    return((uint32_t)(ullHash >> 32));
+}
+
+} /* namespace neb */
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     CTokenBucketTable.hpp
+ * @brief    令牌桶准入表
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     固定容量、开放寻址（线性探测，探测长度有限）的令牌桶表，键为16字节二进制
+ *           （IPv6地址、IPv4映射地址或uin），令牌按时间戳差值惰性补充，没有逐项定时器，
+ *           查询和更新不分配内存。探测范围内没有空位时淘汰其中最久未访问的项（通常
+ *           已补满，等同于新建）。非线程安全，每个事件循环一个实例。
+ * Modify history:
+ ******************************************************************************/
+#ifndef SRC_UTIL_CTOKENBUCKETTABLE_HPP_
+#define SRC_UTIL_CTOKENBUCKETTABLE_HPP_
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <vector>
+
+namespace neb
+{
+
+class CTokenBucketTable
+{
+public:
+    static const uint32_t DEFAULT_CAPACITY = 65536;
+    static const uint32_t MAX_PROBE = 8;            ///< 最大探测长度
+
+    struct tagKey
+    {
+        uint64_t aullKey[2];
+
+        bool operator==(const tagKey& stKey) const
+        {
+            return(aullKey[0] == stKey.aullKey[0] && aullKey[1] == stKey.aullKey[1]);
+        }
+    };
+
+    /**
+     * @param uiCapacity 表容量，向上取整为2的幂，首次使用时分配
+     */
+    explicit CTokenBucketTable(uint32_t uiCapacity = DEFAULT_CAPACITY);
+    virtual ~CTokenBucketTable();
+
+    /**
+     * @brief 从键对应的令牌桶取一个令牌
+     * @param dRate 每秒补充的令牌数
+     * @param dBurst 桶容量（新键的初始令牌数）
+     * @param dNow 当前时间（秒）
+     * @return 取到令牌返回true，应拒绝时返回false
+     */
+    bool Acquire(const tagKey& stKey, double dRate, double dBurst, double dNow);
+
+    /**
+     * @brief 由socket地址生成键，IPv4地址转为IPv4映射的IPv6地址，忽略端口
+     */
+    static tagKey MakeKey(const struct sockaddr_storage& stAddr);
+    static tagKey MakeKey(uint64_t ullId)
+    {
+        tagKey stKey;
+        stKey.aullKey[0] = 0;
+        stKey.aullKey[1] = ullId;
+        return(stKey);
+    }
+
+    uint32_t Size() const
+    {
+        return(m_uiSize);
+    }
+
+private:
+    struct tagBucket
+    {
+        tagKey stKey;
+        double dLastTime;           ///< 上次补充令牌的时间，0为空槽
+        double dTokens;
+    };
+
+    CTokenBucketTable(const CTokenBucketTable&) = delete;
+    CTokenBucketTable& operator=(const CTokenBucketTable&) = delete;
+
+    static uint32_t Hash(const tagKey& stKey);
+
+private:
+    uint32_t m_uiCapacity;
+    uint32_t m_uiSize;
+    std::vector<tagBucket> m_vecBucket;
+};
+
+} /* namespace neb */
+
+#endif /* SRC_UTIL_CTOKENBUCKETTABLE_HPP_ */
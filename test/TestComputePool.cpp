@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     TestComputePool.cpp
+ * @brief    CComputePool单元检查
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     CComputePool是进程内单例，线程启动后不退出，各检查按顺序在同一个实例上进行。
+ * Modify history:
+ ******************************************************************************/
+#include <chrono>
+#include <thread>
+#include "util/CComputePool.hpp"
+#include "TestUtil.hpp"
+
+using neb::CComputePool;
+
+static bool WaitFor(const std::function<bool()>& fnCond)
+{
+    for (int i = 0; i < 5000; ++i)
+    {
+        if (fnCond())
+        {
+            return(true);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return(false);
+}
+
+int main()
+{
+    CComputePool& oPool = CComputePool::Instance();
+
+    // 未配置线程数时不启用
+    TEST_CHECK(!oPool.Submit([]{}, 0));
+    TEST_CHECK(oPool.GetRejectedNum() == 1);
+
+    oPool.Configure(2, 4);
+    std::atomic<bool> bGate(false);
+    std::atomic<uint32_t> uiRunning(0);
+    auto fnBlock = [&bGate, &uiRunning]()
+    {
+        uiRunning.fetch_add(1);
+        while (!bGate.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+    // 两个任务都进入0号队列，1号线程只能窃取执行
+    TEST_CHECK(oPool.Submit(fnBlock, 0));
+    TEST_CHECK(oPool.Submit(fnBlock, 0));
+    TEST_CHECK(oPool.GetThreadNum() == 2);
+    TEST_CHECK(WaitFor([&uiRunning]{ return(uiRunning.load() == 2); }));
+    TEST_CHECK(oPool.GetStolenNum() >= 1);
+    TEST_CHECK(oPool.GetQueueDepth() == 0);
+
+    // 线程都在执行时，排队任务数受限
+    std::atomic<uint32_t> uiDone(0);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        TEST_CHECK(oPool.Submit([&uiDone]{ uiDone.fetch_add(1); }, i));
+    }
+    TEST_CHECK(oPool.GetQueueDepth() == 4);
+    TEST_CHECK(!oPool.Submit([&uiDone]{ uiDone.fetch_add(1); }, 0));
+    TEST_CHECK(oPool.GetRejectedNum() == 2);
+
+    // 启动后Configure()不再生效
+    oPool.Configure(8, 100);
+    TEST_CHECK(oPool.GetThreadNum() == 2);
+
+    bGate.store(true);
+    TEST_CHECK(WaitFor([&oPool]{ return(oPool.GetExecutedNum() == 6); }));
+    TEST_CHECK(uiDone.load() == 4);
+    TEST_CHECK(oPool.GetQueueDepth() == 0);
+
+    // 空闲线程被新任务唤醒
+    std::atomic<uint32_t> uiSum(0);
+    for (uint32_t i = 1; i <= 4; ++i)
+    {
+        TEST_CHECK(oPool.Submit([&uiSum, i]{ uiSum.fetch_add(i); }, i));
+        TEST_CHECK(WaitFor([&oPool, i]{ return(oPool.GetExecutedNum() == 6 + i); }));
+    }
+    TEST_CHECK(uiSum.load() == 10);
+    return(TEST_RESULT());
+}
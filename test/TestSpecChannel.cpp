@@ -0,0 +1,242 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     TestSpecChannel.cpp
+ * @brief    SpecChannel环形队列、溢出队列、批量写入与通知标记的单元检查
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include <string>
+#include <thread>
+#include <vector>
+#include "channel/SpecChannel.hpp"
+#include "TestUtil.hpp"
+
+using namespace neb;
+
+typedef SpecChannel<std::string, int> StringChannel;
+
+static std::string Msg(uint32 uiIndex)
+{
+    return(std::string("msg") + std::to_string(uiIndex));
+}
+
+static void TestRing()
+{
+    StringChannel oChannel(1, 2, 5, true, false);
+    TEST_CHECK(oChannel.GetCapacity() == 8);
+    TEST_CHECK(oChannel.IsEmpty());
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        TEST_CHECK(oChannel.Write(i, i + 100, (int)i, Msg(i)) == ERR_OK);
+    }
+    TEST_CHECK(oChannel.Write(8, 108, 8, Msg(8)) == ERR_SPEC_CHANNEL_FULL);
+    TEST_CHECK(oChannel.GetFullNum() == 1);
+    TEST_CHECK(oChannel.GetPeakBacklog() == 8);
+    TEST_CHECK(oChannel.IsBackPressure());
+    uint32 uiFlags = 0;
+    uint32 uiStepSeq = 0;
+    int iHead = 0;
+    std::string strData;
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        TEST_CHECK(oChannel.Read(uiFlags, uiStepSeq, iHead, strData));
+        TEST_CHECK(uiFlags == i && uiStepSeq == i + 100 && iHead == (int)i && strData == Msg(i));
+    }
+    TEST_CHECK(!oChannel.Read(uiFlags, uiStepSeq, iHead, strData));
+    TEST_CHECK(oChannel.IsEmpty());
+    // 写序号绕回之后仍按序读出
+    for (uint32 i = 0; i < 100; ++i)
+    {
+        TEST_CHECK(oChannel.Write(0, i, Msg(i)) == ERR_OK);
+        TEST_CHECK(oChannel.Read(uiFlags, uiStepSeq, strData) && uiStepSeq == i && strData == Msg(i));
+    }
+}
+
+static void TestOverflow()
+{
+    StringChannel oChannel(1, 2, 4, false, true);
+    auto pWatcher = oChannel.MutableWatcher();
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        TEST_CHECK(oChannel.Write(0, i, Msg(i)) == ERR_OK);
+    }
+    TEST_CHECK(oChannel.GetOverflowNum() == 6);
+    TEST_CHECK(oChannel.GetFullNum() == 0);
+    TEST_CHECK(oChannel.GetPeakBacklog() == 10);
+    TEST_CHECK(oChannel.IsBackPressure());
+    TEST_CHECK(pWatcher->IsOverflow());
+
+    uint32 uiFlags = 0;
+    uint32 uiStepSeq = 0;
+    std::string strData;
+    uint32 uiExpected = 0;
+    for (uint32 i = 0; i < 3; ++i, ++uiExpected)
+    {
+        TEST_CHECK(oChannel.Read(uiFlags, uiStepSeq, strData) && uiStepSeq == uiExpected);
+    }
+    TEST_CHECK(!oChannel.FlushOverflow());      // 只腾出3个位置，溢出队列还剩3个
+    TEST_CHECK(pWatcher->IsOverflow());
+    // 溢出队列未清空时新消息也进入溢出队列，保持顺序
+    TEST_CHECK(oChannel.Write(0, 10, Msg(10)) == ERR_OK);
+    while (oChannel.Read(uiFlags, uiStepSeq, strData))
+    {
+        TEST_CHECK(uiStepSeq == uiExpected && strData == Msg(uiExpected));
+        ++uiExpected;
+        if (uiExpected % 4 == 0)
+        {
+            oChannel.FlushOverflow();
+        }
+    }
+    TEST_CHECK(oChannel.FlushOverflow());
+    while (oChannel.Read(uiFlags, uiStepSeq, strData))
+    {
+        TEST_CHECK(uiStepSeq == uiExpected && strData == Msg(uiExpected));
+        ++uiExpected;
+    }
+    TEST_CHECK(uiExpected == 11);
+    TEST_CHECK(!pWatcher->IsOverflow());
+    TEST_CHECK(!oChannel.IsBackPressure());
+}
+
+static void TestWriteBatch()
+{
+    StringChannel oChannel(1, 2, 8, false, false);
+    std::vector<std::string> vecData;
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        vecData.push_back(Msg(i));
+    }
+    TEST_CHECK(oChannel.WriteBatch(0, 1, vecData) == 8);
+    TEST_CHECK(vecData.size() == 2 && vecData[0] == Msg(8) && vecData[1] == Msg(9));
+    TEST_CHECK(oChannel.GetFullNum() == 2);
+    TEST_CHECK(oChannel.GetPeakBacklog() == 8);
+    uint32 uiFlags = 0;
+    uint32 uiStepSeq = 0;
+    std::string strData;
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        TEST_CHECK(oChannel.Read(uiFlags, uiStepSeq, strData) && strData == Msg(i));
+    }
+    TEST_CHECK(oChannel.WriteBatch(0, 1, vecData) == 2);
+    TEST_CHECK(vecData.empty());
+
+    StringChannel oOverflowChannel(1, 2, 4, false, true);
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        vecData.push_back(Msg(i));
+    }
+    TEST_CHECK(oOverflowChannel.WriteBatch(0, 1, vecData) == 6);
+    TEST_CHECK(vecData.empty());
+    TEST_CHECK(oOverflowChannel.GetOverflowNum() == 2);
+    vecData.push_back(Msg(6));
+    TEST_CHECK(oOverflowChannel.WriteBatch(0, 1, vecData) == 1);    // 排在溢出队列之后
+    TEST_CHECK(oOverflowChannel.GetOverflowNum() == 3);
+    uint32 uiExpected = 0;
+    do
+    {
+        while (oOverflowChannel.Read(uiFlags, uiStepSeq, strData))
+        {
+            TEST_CHECK(strData == Msg(uiExpected));
+            ++uiExpected;
+        }
+    } while (!oOverflowChannel.FlushOverflow() || !oOverflowChannel.IsEmpty());
+    TEST_CHECK(uiExpected == 7);
+}
+
+static void TestWriteBatchWithHead()
+{
+    StringChannel oChannel(1, 2, 4, true, true);
+    std::vector<std::pair<int, std::string>> vecMsg;
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        vecMsg.push_back(std::make_pair((int)i, Msg(i)));
+    }
+    TEST_CHECK(oChannel.WriteBatch(3, 7, vecMsg) == 6);
+    TEST_CHECK(vecMsg.empty());
+    TEST_CHECK(oChannel.GetOverflowNum() == 2);
+    uint32 uiFlags = 0;
+    uint32 uiStepSeq = 0;
+    int iHead = 0;
+    std::string strData;
+    uint32 uiExpected = 0;
+    do
+    {
+        while (oChannel.Read(uiFlags, uiStepSeq, iHead, strData))
+        {
+            TEST_CHECK(uiFlags == 3 && uiStepSeq == 7 && iHead == (int)uiExpected && strData == Msg(uiExpected));
+            ++uiExpected;
+        }
+    } while (!oChannel.FlushOverflow() || !oChannel.IsEmpty());
+    TEST_CHECK(uiExpected == 6);
+}
+
+static void TestNotified()
+{
+    StringChannel oChannel(1, 2, 8, false, false);
+    auto pWatcher = oChannel.MutableWatcher();
+    TEST_CHECK(oChannel.Write(0, 0, Msg(0)) == ERR_OK);
+    TEST_CHECK(pWatcher->SetNotified());        // 空->非空，需要通知
+    TEST_CHECK(oChannel.Write(0, 1, Msg(1)) == ERR_OK);
+    TEST_CHECK(!pWatcher->SetNotified());       // 读取方尚未读空，不再通知
+    uint32 uiFlags = 0;
+    uint32 uiStepSeq = 0;
+    std::string strData;
+    TEST_CHECK(oChannel.Read(uiFlags, uiStepSeq, strData));
+    TEST_CHECK(oChannel.Read(uiFlags, uiStepSeq, strData));
+    TEST_CHECK(!oChannel.Read(uiFlags, uiStepSeq, strData));   // 读空时清除通知标记
+    TEST_CHECK(oChannel.Write(0, 2, Msg(2)) == ERR_OK);
+    TEST_CHECK(pWatcher->SetNotified());
+}
+
+static void TestTwoThreads()
+{
+    const uint32 uiTotal = 1000000;
+    StringChannel oChannel(1, 2, 256, false, false);
+    std::thread oProducer([&oChannel, uiTotal]()
+    {
+        std::vector<std::string> vecData;
+        uint32 uiNext = 0;
+        while (uiNext < uiTotal || !vecData.empty())
+        {
+            while (vecData.size() < 16 && uiNext < uiTotal)
+            {
+                vecData.push_back(std::to_string(uiNext++));
+            }
+            if (oChannel.WriteBatch(0, 0, vecData) == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32 uiFlags = 0;
+    uint32 uiStepSeq = 0;
+    std::string strData;
+    uint32 uiExpected = 0;
+    bool bInOrder = true;
+    while (uiExpected < uiTotal)
+    {
+        if (!oChannel.Read(uiFlags, uiStepSeq, strData))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        bInOrder = bInOrder && (strData == std::to_string(uiExpected));
+        ++uiExpected;
+    }
+    oProducer.join();
+    TEST_CHECK(bInOrder);
+    TEST_CHECK(oChannel.IsEmpty());
+}
+
+int main()
+{
+    TestRing();
+    TestOverflow();
+    TestWriteBatch();
+    TestWriteBatchWithHead();
+    TestNotified();
+    TestTwoThreads();
+    return(TEST_RESULT());
+}
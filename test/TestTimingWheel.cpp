@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     TestTimingWheel.cpp
+ * @brief    CTimingWheel单元检查
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include <vector>
+#include "util/CTimingWheel.hpp"
+#include "TestUtil.hpp"
+
+using neb::CTimingWheel;
+
+struct tagFired
+{
+    CTimingWheel::tagTimer oTimer;
+    std::vector<uint64_t>* pVecFired = nullptr;
+    CTimingWheel* pWheel = nullptr;
+    uint64_t ullRearm = 0;              ///< 非0时在回调中以此间隔重新添加
+};
+
+static void OnTimeout(void* pData)
+{
+    tagFired* pFired = (tagFired*)pData;
+    pFired->pVecFired->push_back(pFired->oTimer.ullExpire);
+    if (pFired->ullRearm > 0)
+    {
+        pFired->pWheel->Add(&pFired->oTimer, pFired->oTimer.ullExpire + pFired->ullRearm);
+    }
+}
+
+static void Init(tagFired& stFired, CTimingWheel& oWheel, std::vector<uint64_t>& vecFired)
+{
+    stFired.oTimer.pFunc = OnTimeout;
+    stFired.oTimer.pData = &stFired;
+    stFired.pVecFired = &vecFired;
+    stFired.pWheel = &oWheel;
+}
+
+static void TestExpireOrder()
+{
+    CTimingWheel oWheel(1000);
+    std::vector<uint64_t> vecFired;
+    // 分布在第一层和各高层的到期时间，逆序添加
+    const uint64_t aullExpire[] = {1000 + 300000, 1000 + 20000, 1000 + 1000, 1000 + 255, 1000 + 1, 1000};
+    const size_t uiNum = sizeof(aullExpire) / sizeof(aullExpire[0]);
+    tagFired astFired[uiNum];
+    for (size_t i = 0; i < uiNum; ++i)
+    {
+        Init(astFired[i], oWheel, vecFired);
+        oWheel.Add(&astFired[i].oTimer, aullExpire[i]);
+    }
+    TEST_CHECK(oWheel.Size() == uiNum);
+    TEST_CHECK(oWheel.NextTick() == 1000);
+
+    uint64_t ullNow = 1000;
+    while (oWheel.Size() > 0 && ullNow <= 1000 + 300000)
+    {
+        uint64_t ullNext = oWheel.NextTick();
+        TEST_CHECK(ullNext >= ullNow);
+        ullNow = ullNext;
+        oWheel.Expire(ullNow);
+    }
+    TEST_CHECK(oWheel.Size() == 0);
+    TEST_CHECK(vecFired.size() == uiNum);
+    for (size_t i = 0; i < vecFired.size(); ++i)
+    {
+        TEST_CHECK(vecFired[i] == aullExpire[uiNum - 1 - i]);   // 按到期时间回调，且不早于到期时间
+    }
+    TEST_CHECK(oWheel.NextTick() == UINT64_MAX);
+}
+
+static void TestNotEarly()
+{
+    CTimingWheel oWheel(0);
+    std::vector<uint64_t> vecFired;
+    tagFired stFired;
+    Init(stFired, oWheel, vecFired);
+    oWheel.Add(&stFired.oTimer, 5000);
+    TEST_CHECK(oWheel.Expire(4999) == 0);
+    TEST_CHECK(stFired.oTimer.IsActive());
+    TEST_CHECK(oWheel.Expire(5000) == 1);
+    TEST_CHECK(!stFired.oTimer.IsActive());
+    TEST_CHECK(vecFired.size() == 1);
+}
+
+static void TestCancelAndRefresh()
+{
+    CTimingWheel oWheel(0);
+    std::vector<uint64_t> vecFired;
+    tagFired stCanceled;
+    tagFired stRefreshed;
+    Init(stCanceled, oWheel, vecFired);
+    Init(stRefreshed, oWheel, vecFired);
+    oWheel.Add(&stCanceled.oTimer, 100);
+    oWheel.Add(&stRefreshed.oTimer, 100);
+    stCanceled.oTimer.Cancel();
+    TEST_CHECK(!stCanceled.oTimer.IsActive());
+    TEST_CHECK(oWheel.Size() == 1);
+    oWheel.Add(&stRefreshed.oTimer, 70000);     // 刷新到高层
+    TEST_CHECK(oWheel.Size() == 1);
+    TEST_CHECK(oWheel.Expire(69999) == 0);
+    TEST_CHECK(oWheel.Expire(70000) == 1);
+    TEST_CHECK(vecFired.size() == 1 && vecFired[0] == 70000);
+    {
+        tagFired stDestroyed;
+        Init(stDestroyed, oWheel, vecFired);
+        oWheel.Add(&stDestroyed.oTimer, 80000);
+        TEST_CHECK(oWheel.Size() == 1);
+    }
+    TEST_CHECK(oWheel.Size() == 0);             // 析构时从时间轮中移除
+}
+
+static void TestRearmInCallback()
+{
+    CTimingWheel oWheel(0);
+    std::vector<uint64_t> vecFired;
+    tagFired stFired;
+    Init(stFired, oWheel, vecFired);
+    stFired.ullRearm = 10;
+    oWheel.Add(&stFired.oTimer, 10);
+    TEST_CHECK(oWheel.Expire(100) == 10);       // 回调中添加的已到期定时器在同一次Expire()中回调
+    TEST_CHECK(stFired.oTimer.IsActive() && stFired.oTimer.ullExpire == 110);
+    stFired.ullRearm = 0;
+    TEST_CHECK(oWheel.Expire(110) == 1);
+    TEST_CHECK(oWheel.Size() == 0);
+}
+
+static void TestPastExpire()
+{
+    CTimingWheel oWheel(1000);
+    std::vector<uint64_t> vecFired;
+    tagFired stFired;
+    Init(stFired, oWheel, vecFired);
+    oWheel.Add(&stFired.oTimer, 10);            // 已过期的定时器在下一次Expire()回调
+    TEST_CHECK(oWheel.NextTick() == 1000);
+    TEST_CHECK(oWheel.Expire(1000) == 1);
+}
+
+int main()
+{
+    TestExpireOrder();
+    TestNotEarly();
+    TestCancelAndRefresh();
+    TestRearmInCallback();
+    TestPastExpire();
+    return(TEST_RESULT());
+}
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     TestTokenBucketTable.cpp
+ * @brief    CTokenBucketTable单元检查
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note
+ * Modify history:
+ ******************************************************************************/
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include "util/CTokenBucketTable.hpp"
+#include "TestUtil.hpp"
+
+using neb::CTokenBucketTable;
+
+static void TestBurstAndRefill()
+{
+    CTokenBucketTable oTable(64);
+    CTokenBucketTable::tagKey stKey = CTokenBucketTable::MakeKey(1);
+    double dNow = 100.0;
+    for (int i = 0; i < 5; ++i)
+    {
+        TEST_CHECK(oTable.Acquire(stKey, 10.0, 5.0, dNow));    // 新键有dBurst个令牌
+    }
+    TEST_CHECK(!oTable.Acquire(stKey, 10.0, 5.0, dNow));
+    TEST_CHECK(!oTable.Acquire(stKey, 10.0, 5.0, dNow + 0.05));
+    TEST_CHECK(oTable.Acquire(stKey, 10.0, 5.0, dNow + 0.15)); // 0.15秒补充1.5个令牌
+    TEST_CHECK(!oTable.Acquire(stKey, 10.0, 5.0, dNow + 0.15));
+    int iAcquired = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        iAcquired += oTable.Acquire(stKey, 10.0, 5.0, dNow + 100.0) ? 1 : 0;
+    }
+    TEST_CHECK(iAcquired == 5);                                 // 补充不超过桶容量
+    TEST_CHECK(oTable.Size() == 1);
+}
+
+static void TestKeysIndependent()
+{
+    CTokenBucketTable oTable(64);
+    for (uint64_t i = 1; i <= 16; ++i)
+    {
+        CTokenBucketTable::tagKey stKey = CTokenBucketTable::MakeKey(i);
+        TEST_CHECK(oTable.Acquire(stKey, 1.0, 1.0, 1.0));
+        TEST_CHECK(!oTable.Acquire(stKey, 1.0, 1.0, 1.0));
+    }
+    TEST_CHECK(oTable.Size() == 16);
+}
+
+static void TestEvictionBounded()
+{
+    CTokenBucketTable oTable(16);
+    for (uint64_t i = 1; i <= 1000; ++i)
+    {
+        TEST_CHECK(oTable.Acquire(CTokenBucketTable::MakeKey(i), 1.0, 2.0, (double)i));
+    }
+    TEST_CHECK(oTable.Size() <= 16);                            // 满表时淘汰旧键，表不增长
+    // 刚被访问的键仍在表中，保留了已消耗的令牌
+    CTokenBucketTable::tagKey stKey = CTokenBucketTable::MakeKey(1000);
+    TEST_CHECK(oTable.Acquire(stKey, 1.0, 2.0, 1000.0));
+    TEST_CHECK(!oTable.Acquire(stKey, 1.0, 2.0, 1000.0));
+}
+
+static void TestMakeKey()
+{
+    struct sockaddr_storage stAddr4;
+    memset(&stAddr4, 0, sizeof(stAddr4));
+    struct sockaddr_in* pAddr4 = (struct sockaddr_in*)&stAddr4;
+    pAddr4->sin_family = AF_INET;
+    pAddr4->sin_port = htons(1234);
+    inet_pton(AF_INET, "192.168.1.2", &pAddr4->sin_addr);
+
+    struct sockaddr_storage stAddr6;
+    memset(&stAddr6, 0, sizeof(stAddr6));
+    struct sockaddr_in6* pAddr6 = (struct sockaddr_in6*)&stAddr6;
+    pAddr6->sin6_family = AF_INET6;
+    pAddr6->sin6_port = htons(5678);
+    inet_pton(AF_INET6, "::ffff:192.168.1.2", &pAddr6->sin6_addr);
+
+    TEST_CHECK(CTokenBucketTable::MakeKey(stAddr4) == CTokenBucketTable::MakeKey(stAddr6));
+    pAddr4->sin_port = htons(4321);                             // 忽略端口
+    TEST_CHECK(CTokenBucketTable::MakeKey(stAddr4) == CTokenBucketTable::MakeKey(stAddr6));
+    inet_pton(AF_INET, "192.168.1.3", &pAddr4->sin_addr);
+    TEST_CHECK(!(CTokenBucketTable::MakeKey(stAddr4) == CTokenBucketTable::MakeKey(stAddr6)));
+}
+
+int main()
+{
+    TestBurstAndRefill();
+    TestKeysIndependent();
+    TestEvictionBounded();
+    TestMakeKey();
+    return(TEST_RESULT());
+}
@@ -0,0 +1,30 @@
+/*******************************************************************************
+ * Project:  Nebula
+ * @file     TestUtil.hpp
+ * @brief    单元检查用的断言宏
+ * @author   Bwar
+ * @date:    2026年10月17日
+ * @note     不依赖测试框架，每个测试程序失败时返回非0，由Makefile的test目标依次运行。
+ * Modify history:
+ ******************************************************************************/
+#ifndef TEST_TESTUTIL_HPP_
+#define TEST_TESTUTIL_HPP_
+
+#include <stdio.h>
+
+static int g_iTestFailed = 0;
+
+#define TEST_CHECK(cond) \
+    do { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_iTestFailed; \
+        } \
+    } while (0)
+
+#define TEST_RESULT() \
+    ((g_iTestFailed == 0) ? (printf("%s passed\n", __FILE__), 0) \
+        : (fprintf(stderr, "%s: %d checks failed\n", __FILE__, g_iTestFailed), 1))
+
+#endif /* TEST_TESTUTIL_HPP_ */